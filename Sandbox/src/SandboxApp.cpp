@@ -62,6 +62,6 @@ public:
 
 };
 
-Syndra::Application* Syndra::CreateApplication() {
+Syndra::Application* Syndra::CreateApplication(Syndra::ApplicationCommandLineArgs args) {
 	return new Sandbox();
 }
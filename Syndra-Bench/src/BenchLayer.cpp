@@ -0,0 +1,240 @@
+#include "lpch.h"
+#include "BenchLayer.h"
+
+#include "Engine/Scene/SceneSerializer.h"
+
+#include <glm/gtc/constants.hpp>
+#include <fstream>
+
+namespace Syndra {
+
+	//The scene always advances by this much, the measured time never feeds back into what is drawn
+	static constexpr float FixedTimestep = 1.0f / 60.0f;
+
+	static float Milliseconds(std::chrono::steady_clock::duration duration)
+	{
+		return std::chrono::duration<float, std::milli>(duration).count();
+	}
+
+	static std::string Quote(const std::string& text)
+	{
+		std::string quoted = "\"";
+		for (char c : text)
+		{
+			if (c == '"' || c == '\\')
+				quoted += '\\';
+			if (c == '\n')
+				quoted += "\\n";
+			else
+				quoted += c;
+		}
+		return quoted + "\"";
+	}
+
+	//Nearest rank on sorted samples
+	static float Percentile(const std::vector<float>& sorted, float percentile)
+	{
+		size_t rank = (size_t)glm::ceil(percentile / 100.0f * sorted.size());
+		return sorted[std::min(std::max(rank, (size_t)1), sorted.size()) - 1];
+	}
+
+	static void WriteStats(std::ostream& out, const std::vector<float>& samples)
+	{
+		if (samples.empty()) {
+			out << "{\"samples\":0}";
+			return;
+		}
+		std::vector<float> sorted = samples;
+		std::sort(sorted.begin(), sorted.end());
+		double sum = 0.0;
+		for (auto sample : sorted)
+			sum += sample;
+		out << "{\"samples\":" << sorted.size() << ",\"mean\":" << sum / sorted.size() << ",\"min\":" << sorted.front()
+			<< ",\"p50\":" << Percentile(sorted, 50.0f) << ",\"p90\":" << Percentile(sorted, 90.0f)
+			<< ",\"p95\":" << Percentile(sorted, 95.0f) << ",\"p99\":" << Percentile(sorted, 99.0f) << ",\"max\":" << sorted.back() << "}";
+	}
+
+	BenchLayer::BenchLayer(const BenchSettings& settings)
+		:Layer("Bench"), m_Settings(settings)
+	{
+	}
+
+	void BenchLayer::OnAttach()
+	{
+		RenderCommand::Init();
+		SN_INFO("Benchmarking {0} scenarios, {1} frames each after {2} warmup frames", m_Settings.Scenarios.size(), m_Settings.Frames, m_Settings.WarmupFrames);
+	}
+
+	void BenchLayer::OnUpdate(Timestep ts)
+	{
+		if (m_Scenario < 0 || m_Frame == m_Settings.WarmupFrames + m_Settings.Frames) {
+			if (++m_Scenario == (int)m_Settings.Scenarios.size()) {
+				WriteReport();
+				Application::Get().Close();
+				return;
+			}
+			LoadScenario(m_Settings.Scenarios[m_Scenario]);
+		}
+
+		if (m_Frame == m_Settings.WarmupFrames) {
+			SceneRenderer::GetGPUProfiler()->Reset();
+			m_GPUCounts.clear();
+		}
+
+		UpdateCamera();
+		auto start = std::chrono::steady_clock::now();
+		m_Scene->OnUpdateEditor(FixedTimestep);
+		float cpuFrame = Milliseconds(std::chrono::steady_clock::now() - start);
+		if (m_Frame >= m_Settings.WarmupFrames) {
+			//From the start of the last frame, includes the flush of the previous one
+			if (m_Frame > 0)
+				m_Results.back().FrameTime.Samples.push_back(Milliseconds(start - m_LastFrame));
+			Record(cpuFrame);
+		}
+		m_LastFrame = start;
+		m_Frame++;
+	}
+
+	void BenchLayer::LoadScenario(const BenchScenario& scenario)
+	{
+		SN_INFO("Loading {0}", scenario.Name);
+		auto start = std::chrono::steady_clock::now();
+		m_Scene = CreateRef<Scene>();
+		m_Scene->OnViewportResize(m_Settings.Width, m_Settings.Height);
+		if (!scenario.ScenePath.empty()) {
+			SceneSerializer serializer(m_Scene);
+			if (!serializer.Deserialize(scenario.ScenePath))
+				SN_ERROR("Could not load {0}, the scenario renders an empty scene", scenario.ScenePath);
+		}
+		else {
+			GenerateStressScene(m_Scene, scenario.Stress);
+			//Looks at the whole grid
+			m_Scene->GetCamera().SetFocalPoint(glm::vec3(0.0f));
+			m_Scene->GetCamera().SetDistance(glm::sqrt((float)scenario.Stress.EntityCount) * 2.0f);
+			m_Scene->GetCamera().SetYawPitch(0.6f, 0.5f);
+		}
+		SceneRenderer::SetScene(m_Scene);
+		//The environment bakes in the background, it would change the frames being measured
+		SceneRenderer::WaitForEnvironment();
+		//Frame time driven scaling would change the work done per frame between runs
+		SceneRenderer::SetDynamicResolution(false);
+
+		auto& camera = m_Scene->GetCamera();
+		m_FocalPoint = camera.GetFocalPoint();
+		m_Distance = camera.GetDistance();
+		m_Yaw = camera.GetYaw();
+		m_Pitch = camera.GetPitch();
+
+		ScenarioResult result;
+		result.Name = scenario.Name;
+		result.LoadTime = Milliseconds(std::chrono::steady_clock::now() - start);
+		result.CPUFrame.Name = result.GPUFrame.Name = result.FrameTime.Name = "Frame";
+		m_Results.push_back(result);
+		m_Frame = 0;
+	}
+
+	//Warmup frames stay at the saved view, the measured frames orbit once around the focal point while
+	//dollying in and out and tilting up and down
+	void BenchLayer::UpdateCamera()
+	{
+		float t = m_Frame < m_Settings.WarmupFrames ? 0.0f : (float)(m_Frame - m_Settings.WarmupFrames) / m_Settings.Frames;
+		float angle = glm::two_pi<float>() * t;
+		auto& camera = m_Scene->GetCamera();
+		camera.SetFocalPoint(m_FocalPoint);
+		camera.SetDistance(m_Distance * (1.0f - 0.25f * glm::sin(angle)));
+		camera.SetYawPitch(m_Yaw + angle, m_Pitch + 0.15f * glm::sin(2.0f * angle));
+	}
+
+	void BenchLayer::Record(float cpuFrame)
+	{
+		auto& result = m_Results.back();
+		result.CPUFrame.Samples.push_back(cpuFrame);
+		for (auto& [name, milliseconds] : SceneRenderer::GetRenderGraph()->GetCPUTimes())
+		{
+			//Culled passes did not run
+			if (milliseconds > 0.0f)
+				FindSeries(result.CPUPasses, name).Samples.push_back(milliseconds);
+		}
+
+		//GPU timers arrive a few frames late and only when they are new
+		auto& profiler = SceneRenderer::GetGPUProfiler();
+		auto poll = [&](const GPUTimerStats& stats, Series& series) {
+			auto& count = m_GPUCounts[stats.Name];
+			if (stats.Count > count) {
+				series.Samples.push_back(stats.Last);
+				count = stats.Count;
+			}
+		};
+		for (auto& stats : profiler->GetStats())
+			poll(stats, FindSeries(result.GPUPasses, stats.Name));
+		poll(profiler->GetFrameStats(), result.GPUFrame);
+
+		auto& stats = SceneRenderer::GetDrawStats();
+		result.DrawCalls += stats.drawCalls;
+		result.DrawCommands += stats.drawCommands;
+		result.Instances += stats.instances;
+		result.Triangles += stats.triangles;
+		result.Meshes += stats.meshes;
+	}
+
+	BenchLayer::Series& BenchLayer::FindSeries(std::vector<Series>& series, const std::string& name)
+	{
+		auto it = std::find_if(series.begin(), series.end(), [&](const Series& s) { return s.Name == name; });
+		if (it != series.end())
+			return *it;
+		series.push_back({ name, {} });
+		return series.back();
+	}
+
+	void BenchLayer::WriteReport() const
+	{
+		std::stringstream out;
+		auto writePasses = [&](const std::vector<Series>& passes) {
+			out << "{";
+			for (size_t i = 0; i < passes.size(); i++)
+			{
+				out << (i ? "," : "") << Quote(passes[i].Name) << ":";
+				WriteStats(out, passes[i].Samples);
+			}
+			out << "}";
+		};
+
+		//Per frame averages of the draw counters
+		double frames = m_Settings.Frames;
+		out << "{\"renderer\":" << Quote(RenderCommand::GetInfo()) << ",\"frames\":" << m_Settings.Frames << ",\"warmupFrames\":" << m_Settings.WarmupFrames
+			<< ",\"width\":" << m_Settings.Width << ",\"height\":" << m_Settings.Height << ",\"scenarios\":[";
+		for (size_t i = 0; i < m_Results.size(); i++)
+		{
+			auto& result = m_Results[i];
+			out << (i ? "," : "") << "{\"name\":" << Quote(result.Name) << ",\"loadMs\":" << result.LoadTime;
+			out << ",\"cpuFrameMs\":";
+			WriteStats(out, result.CPUFrame.Samples);
+			out << ",\"gpuFrameMs\":";
+			WriteStats(out, result.GPUFrame.Samples);
+			out << ",\"frameTimeMs\":";
+			WriteStats(out, result.FrameTime.Samples);
+			out << ",\"cpuPassMs\":";
+			writePasses(result.CPUPasses);
+			out << ",\"gpuPassMs\":";
+			writePasses(result.GPUPasses);
+			out << ",\"drawCalls\":" << result.DrawCalls / frames << ",\"drawCommands\":" << result.DrawCommands / frames
+				<< ",\"instances\":" << result.Instances / frames << ",\"triangles\":" << result.Triangles / frames
+				<< ",\"meshes\":" << result.Meshes / frames << "}";
+		}
+		out << "]}\n";
+
+		if (m_Settings.OutputPath.empty()) {
+			std::cout << out.str();
+			return;
+		}
+		std::ofstream file(m_Settings.OutputPath);
+		if (!file) {
+			SN_ERROR("Could not write the report to {0}", m_Settings.OutputPath);
+			std::cout << out.str();
+			return;
+		}
+		file << out.str();
+		SN_INFO("Report written to {0}", m_Settings.OutputPath);
+	}
+
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <Engine.h>
+#include "StressScene.h"
+
+#include <chrono>
+
+namespace Syndra {
+
+	//A saved scene or a generated stress scene
+	struct BenchScenario
+	{
+		std::string Name;
+		//Empty for stress scenes
+		std::string ScenePath;
+		StressSceneSpecification Stress;
+	};
+
+	struct BenchSettings
+	{
+		std::vector<BenchScenario> Scenarios;
+		//Frames rendered before measuring, shader compilation, shadow caches and the history settle
+		uint32_t WarmupFrames = 60;
+		uint32_t Frames = 600;
+		uint32_t Width = 1280;
+		uint32_t Height = 720;
+		//The report goes to stdout when empty
+		std::string OutputPath;
+	};
+
+	//Renders each scenario for a fixed number of frames along the same camera path and reports the timings as JSON.
+	//The frame index drives the camera and the scene gets a fixed timestep, so runs only differ in their timings.
+	class BenchLayer : public Layer
+	{
+	public:
+		BenchLayer(const BenchSettings& settings);
+		virtual ~BenchLayer() = default;
+
+		virtual void OnAttach() override;
+		virtual void OnUpdate(Timestep ts) override;
+
+	private:
+		//Milliseconds of every measured frame
+		struct Series
+		{
+			std::string Name;
+			std::vector<float> Samples;
+		};
+
+		struct ScenarioResult
+		{
+			std::string Name;
+			float LoadTime = 0.0f;
+			Series CPUFrame, GPUFrame, FrameTime;
+			std::vector<Series> CPUPasses, GPUPasses;
+			//Sums over the measured frames
+			uint64_t DrawCalls = 0, DrawCommands = 0, Instances = 0, Triangles = 0, Meshes = 0;
+		};
+
+		void LoadScenario(const BenchScenario& scenario);
+		void UpdateCamera();
+		void Record(float cpuFrame);
+		void WriteReport() const;
+
+		static Series& FindSeries(std::vector<Series>& series, const std::string& name);
+
+	private:
+		BenchSettings m_Settings;
+		Ref<Scene> m_Scene;
+		int m_Scenario = -1;
+		uint32_t m_Frame = 0;
+		//Camera of the scenario as loaded, the path orbits around it
+		glm::vec3 m_FocalPoint = glm::vec3(0.0f);
+		float m_Distance = 10.0f, m_Yaw = 0.0f, m_Pitch = 0.0f;
+		std::chrono::steady_clock::time_point m_LastFrame;
+		//Sample count of every GPU timer when it was last read
+		std::unordered_map<std::string, uint32_t> m_GPUCounts;
+		std::vector<ScenarioResult> m_Results;
+	};
+
+}
@@ -0,0 +1,150 @@
+#include "lpch.h"
+#include "StressScene.h"
+
+#include <glm/gtc/constants.hpp>
+#include <random>
+
+namespace Syndra {
+
+	static void AddVertex(std::vector<Vertex>& vertices, Math::AABB& bounds, const glm::vec3& position, const glm::vec3& normal, const glm::vec3& tangent, const glm::vec2& uv)
+	{
+		vertices.push_back({ position, uv, normal, tangent, glm::cross(normal, tangent) });
+		bounds.Expand(position);
+	}
+
+	//Unit sphere of the given number of segments around the axis, half as many rings from pole to pole
+	static Ref<Model> CreateSphere(uint32_t segments)
+	{
+		uint32_t rings = segments / 2;
+		std::vector<Vertex> vertices;
+		std::vector<uint32_t> indices;
+		Math::AABB bounds;
+		for (uint32_t ring = 0; ring <= rings; ring++)
+		{
+			float theta = glm::pi<float>() * ring / rings;
+			for (uint32_t segment = 0; segment <= segments; segment++)
+			{
+				float phi = glm::two_pi<float>() * segment / segments;
+				glm::vec3 normal(glm::sin(theta) * glm::cos(phi), glm::cos(theta), glm::sin(theta) * glm::sin(phi));
+				glm::vec3 tangent(-glm::sin(phi), 0.0f, glm::cos(phi));
+				AddVertex(vertices, bounds, normal, normal, tangent, glm::vec2((float)segment / segments, (float)ring / rings));
+			}
+		}
+		for (uint32_t ring = 0; ring < rings; ring++)
+		{
+			for (uint32_t segment = 0; segment < segments; segment++)
+			{
+				uint32_t a = ring * (segments + 1) + segment, b = a + segments + 1;
+				indices.insert(indices.end(), { a, a + 1, b, a + 1, b + 1, b });
+			}
+		}
+
+		auto model = CreateRef<Model>();
+		model->meshes.emplace_back(vertices.data(), (uint32_t)vertices.size(), indices.data(), (uint32_t)indices.size(), std::vector<texture>(), bounds);
+		return model;
+	}
+
+	//Cube from -1 to 1, each face split into a grid of the given size
+	static Ref<Model> CreateBox(uint32_t divisions)
+	{
+		std::vector<Vertex> vertices;
+		std::vector<uint32_t> indices;
+		Math::AABB bounds;
+		const glm::vec3 normals[] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+		for (const auto& normal : normals)
+		{
+			glm::vec3 tangent = glm::abs(normal.y) > 0.5f ? glm::vec3(1, 0, 0) : glm::cross(glm::vec3(0, 1, 0), normal);
+			glm::vec3 bitangent = glm::cross(normal, tangent);
+			uint32_t first = (uint32_t)vertices.size();
+			for (uint32_t y = 0; y <= divisions; y++)
+			{
+				for (uint32_t x = 0; x <= divisions; x++)
+				{
+					glm::vec2 uv((float)x / divisions, (float)y / divisions);
+					glm::vec3 position = normal + tangent * (uv.x * 2.0f - 1.0f) + bitangent * (uv.y * 2.0f - 1.0f);
+					AddVertex(vertices, bounds, position, normal, tangent, uv);
+				}
+			}
+			for (uint32_t y = 0; y < divisions; y++)
+			{
+				for (uint32_t x = 0; x < divisions; x++)
+				{
+					uint32_t a = first + y * (divisions + 1) + x, b = a + divisions + 1;
+					indices.insert(indices.end(), { a, a + 1, b + 1, a, b + 1, b });
+				}
+			}
+		}
+
+		auto model = CreateRef<Model>();
+		model->meshes.emplace_back(vertices.data(), (uint32_t)vertices.size(), indices.data(), (uint32_t)indices.size(), std::vector<texture>(), bounds);
+		return model;
+	}
+
+	void GenerateStressScene(const Ref<Scene>& scene, const StressSceneSpecification& spec)
+	{
+		SN_PROFILE_FUNCTION();
+
+		std::mt19937 random(spec.Seed);
+		std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+		//Every mesh index gets its own geometry, spheres and boxes alternate and get finer with the index.
+		//Copies of a mesh component share the geometry.
+		std::vector<MeshComponent> meshes(std::max(spec.MeshCount, 1u));
+		for (uint32_t i = 0; i < meshes.size(); i++)
+			meshes[i].model = i % 2 ? CreateSphere(8 + 4 * (i / 2)) : CreateBox(1 + i / 2);
+
+		auto shader = scene->GetShaderLibrary().Get("GeometryPass");
+		std::vector<Ref<Material>> materials;
+		for (uint32_t i = 0; i < std::max(spec.MaterialCount, 1u); i++)
+		{
+			auto material = Material::Create(shader);
+			material->Set("tiling", 1.0f);
+			material->Set("HasAlbedoMap", 0);
+			material->Set("HasNormalMap", 0);
+			material->Set("HasRoughnessMap", 0);
+			material->Set("HasMetallicMap", 0);
+			material->Set("HasAOMap", 0);
+			material->Set("push.material.color", glm::vec4(unit(random), unit(random), unit(random), 1.0f));
+			material->Set("push.material.MetallicFactor", unit(random));
+			material->Set("push.material.RoughnessFactor", 0.1f + 0.9f * unit(random));
+			material->Set("push.material.AO", 1.0f);
+			materials.push_back(material);
+		}
+
+		//Square grid centered on the origin, two units between entities
+		uint32_t side = (uint32_t)glm::ceil(glm::sqrt((float)spec.EntityCount));
+		float extent = side * 2.0f;
+		for (uint32_t i = 0; i < spec.EntityCount; i++)
+		{
+			auto entity = scene->CreateEntity("Stress " + std::to_string(i));
+			auto& transform = entity->GetComponent<TransformComponent>();
+			transform.Translation = glm::vec3((i % side) * 2.0f - extent * 0.5f, 0.5f + unit(random), (i / side) * 2.0f - extent * 0.5f);
+			transform.Rotation = glm::vec3(unit(random), unit(random), unit(random)) * glm::two_pi<float>();
+			transform.Scale = glm::vec3(0.4f + 0.4f * unit(random));
+			entity->AddComponent<MeshComponent>(meshes[i % meshes.size()]);
+			entity->AddComponent<MaterialComponent>(materials[(i * 7 + 3) % materials.size()]);
+		}
+
+		auto ground = scene->CreateEntity("Ground");
+		ground->GetComponent<TransformComponent>().Scale = glm::vec3(extent);
+		std::string planePath = "assets/Models/plane/plane.obj";
+		ground->AddComponent<MeshComponent>(planePath).isStatic = true;
+		ground->AddComponent<MaterialComponent>(materials[0]);
+
+		auto sun = scene->CreateLight(LightType::Directional);
+		auto directional = std::dynamic_pointer_cast<DirectionalLight>(sun->GetComponent<LightComponent>().light);
+		directional->SetDirection(glm::vec3(-0.4f, -1.0f, -0.3f));
+		directional->SetIntensity(4.0f);
+
+		for (uint32_t i = 0; i < spec.LightCount; i++)
+		{
+			auto light = scene->CreateLight(LightType::Point);
+			light->GetComponent<TransformComponent>().Translation = glm::vec3((unit(random) - 0.5f) * extent, 2.0f + 2.0f * unit(random), (unit(random) - 0.5f) * extent);
+			auto point = std::dynamic_pointer_cast<PointLight>(light->GetComponent<LightComponent>().light);
+			point->SetColor(glm::vec3(unit(random), unit(random), unit(random)));
+			point->SetIntensity(20.0f);
+			point->SetRange(8.0f);
+		}
+	}
+
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include <Engine.h>
+
+namespace Syndra {
+
+	struct StressSceneSpecification
+	{
+		uint32_t EntityCount = 1000;
+		//Distinct procedural meshes, entities using the same one are drawn as instances
+		uint32_t MeshCount = 8;
+		//Distinct material parameter sets the entities are spread over
+		uint32_t MaterialCount = 16;
+		//Point lights, a directional light is always added
+		uint32_t LightCount = 32;
+		uint32_t Seed = 1;
+	};
+
+	//Fills the scene with a grid of randomly rotated primitives and point lights floating above them.
+	//The same specification always builds the same scene.
+	void GenerateStressScene(const Ref<Scene>& scene, const StressSceneSpecification& spec);
+
+}
@@ -0,0 +1,84 @@
+#include "lpch.h"
+#include <Engine.h>
+#include "Engine/Core/EntryPoint.h"
+#include "BenchLayer.h"
+
+namespace Syndra {
+
+	//Syndra-Bench [--scene path]... [--stress entities meshes materials lights]... [--frames n] [--warmup n]
+	//             [--size width height] [--output path]
+	//Without scenes or stress scenes the bundled PBR_test, shadow and sponza scenes and a default stress scene are run.
+	static BenchSettings ParseArguments(ApplicationCommandLineArgs args)
+	{
+		BenchSettings settings;
+		auto number = [&](int index) { return index < args.Count ? (uint32_t)std::stoul(args[index]) : 0u; };
+		for (int i = 1; i < args.Count; i++)
+		{
+			std::string arg = args[i];
+			if (arg == "--scene" && i + 1 < args.Count) {
+				BenchScenario scenario;
+				scenario.ScenePath = args[++i];
+				scenario.Name = std::filesystem::path(scenario.ScenePath).stem().string();
+				settings.Scenarios.push_back(scenario);
+			}
+			else if (arg == "--stress" && i + 4 < args.Count) {
+				BenchScenario scenario;
+				scenario.Stress.EntityCount = number(i + 1);
+				scenario.Stress.MeshCount = number(i + 2);
+				scenario.Stress.MaterialCount = number(i + 3);
+				scenario.Stress.LightCount = number(i + 4);
+				i += 4;
+				scenario.Name = "stress_" + std::to_string(scenario.Stress.EntityCount) + "e_" + std::to_string(scenario.Stress.MeshCount) + "m_"
+					+ std::to_string(scenario.Stress.MaterialCount) + "mat_" + std::to_string(scenario.Stress.LightCount) + "l";
+				settings.Scenarios.push_back(scenario);
+			}
+			else if (arg == "--frames" && i + 1 < args.Count)
+				settings.Frames = std::max(number(++i), 1u);
+			else if (arg == "--warmup" && i + 1 < args.Count)
+				settings.WarmupFrames = number(++i);
+			else if (arg == "--size" && i + 2 < args.Count) {
+				settings.Width = std::max(number(i + 1), 1u);
+				settings.Height = std::max(number(i + 2), 1u);
+				i += 2;
+			}
+			else if (arg == "--output" && i + 1 < args.Count)
+				settings.OutputPath = args[++i];
+			else
+				SN_WARN("Unknown argument {0}", arg);
+		}
+
+		if (settings.Scenarios.empty()) {
+			for (const char* name : { "PBR_test", "shadow", "sponza" })
+			{
+				BenchScenario scenario;
+				scenario.Name = name;
+				scenario.ScenePath = std::string("assets/Scenes/") + name + ".syndra";
+				settings.Scenarios.push_back(scenario);
+			}
+			BenchScenario stress;
+			stress.Name = "stress";
+			settings.Scenarios.push_back(stress);
+		}
+		return settings;
+	}
+
+	class SyndraBenchApp : public Application
+	{
+	public:
+		SyndraBenchApp(const BenchSettings& settings)
+			:Application("Syndra Bench", true)
+		{
+			PushLayer(new BenchLayer(settings));
+		}
+
+		~SyndraBenchApp() {
+
+		}
+
+	};
+
+	Application* CreateApplication(ApplicationCommandLineArgs args) {
+		return new SyndraBenchApp(ParseArguments(args));
+	}
+
+}
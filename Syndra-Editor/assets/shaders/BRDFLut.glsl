@@ -1,22 +1,9 @@
-// BRDF Lookup Shader
-#type vertex
-
+// BRDF Lookup Shader, one invocation per texel of the LUT
+#type compute
 #version 450 core
-layout(location = 0) in vec3 a_pos;
-layout(location = 1) in vec2 a_uv;
-
-layout(location = 0) out vec2 v_uv;
+layout(local_size_x = 8, local_size_y = 8, local_size_z = 1) in;
 
-void main(){
-	v_uv = a_uv;
-	gl_Position = vec4(a_pos,1.0f);
-}
-
-#type fragment
-#version 450 core
-
-layout(location = 0) out vec2 FragColor;
-layout(location = 0) in vec2 v_uv;
+layout(binding = 0, rg16f) uniform writeonly image2D brdfLUT;
 
 const float PI = 3.14159265359;
 // ----------------------------------------------------------------------------
@@ -124,6 +111,10 @@ vec2 IntegrateBRDF(float NdotV, float roughness)
 // ----------------------------------------------------------------------------
 void main() 
 {
-    vec2 integratedBRDF = IntegrateBRDF(v_uv.x, v_uv.y);
-    FragColor = integratedBRDF;
+    ivec2 size = imageSize(brdfLUT);
+    if (any(greaterThanEqual(gl_GlobalInvocationID.xy, uvec2(size))))
+        return;
+
+    vec2 uv = (vec2(gl_GlobalInvocationID.xy) + 0.5) / vec2(size);
+    imageStore(brdfLUT, ivec2(gl_GlobalInvocationID.xy), vec4(IntegrateBRDF(uv.x, uv.y), 0.0, 0.0));
 }
\ No newline at end of file
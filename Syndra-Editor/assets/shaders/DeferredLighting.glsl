@@ -19,42 +19,52 @@ void main(){
 layout(location = 0) out vec4 fragColor;	
 
 
-//GBuffer samplers
+//GBuffer samplers, PACKED_GBUFFER replaces the position with the depth buffer and stores octahedral normals
+#ifdef PACKED_GBUFFER
+layout(binding = 0) uniform sampler2D gDepth;
+#else
 layout(binding = 0) uniform sampler2D gPosition;
+#endif
 layout(binding = 1) uniform sampler2D gNormal;
 layout(binding = 2) uniform sampler2D gAlbedoSpec;
 layout(binding = 6) uniform sampler2D gRoughMetalAO;
 
-// IBL
-layout(binding = 7) uniform samplerCube irradianceMap;
+// IBL, the diffuse irradiance is the Irradiance uniform block
 layout(binding = 8) uniform samplerCube prefilterMap;
 layout(binding = 9) uniform sampler2D   brdfLUT;  
 
 //Shadow related samplers
-layout(binding = 3) uniform sampler2D shadowMap;
+layout(binding = 3) uniform sampler2DArray shadowMap;
 layout(binding = 4) uniform sampler1D distribution0;
 layout(binding = 5) uniform sampler1D distribution1;
+layout(binding = 10) uniform sampler2D shadowAtlas;
 
 //-----------------------------------------------UNIFORM BUFFERS-----------------------------------------//
 layout(binding = 0) uniform camera
 {
 	mat4 u_ViewProjection;
 	vec4 cameraPos;
+	mat4 inverseViewProjection;
 } cam;
 
 layout(binding = 3) uniform ShadowData
 {
-	 mat4 lightViewProj;
+	mat4 cascadeViewProj[4];
+	//View space depth where each cascade ends
+	vec4 cascadeSplits;
+	//Size of the first cascade relative to each cascade
+	vec4 cascadeScales;
+	int cascadeCount;
+	//Fraction of a cascade blended with the next one
+	float cascadeBlend;
 } shadow;
 
-#define constant 1.0
-#define linear 0.022
-#define quadratic 0.0019
-
 struct PointLight {
     vec4 position;
     vec4 color;
-	float dist;
+	float range;
+	//First of the six cube face tiles, -1 without shadows
+	int shadowIndex;
 };
 
 struct DirLight {
@@ -68,22 +78,66 @@ struct SpotLight {
 	vec4 color;
     vec4 direction;
     float cutOff;
-    float outerCutOff;      
+    float outerCutOff;
+	float range;
+	int shadowIndex;
 };
 
 layout(binding = 2) uniform Lights
 {
-	PointLight pLight[4];
-	SpotLight sLight[4];
+	mat4 view;
 	DirLight dLight;
+	uvec4 clusterCount;
+	//depth scale, depth bias, near, far
+	vec4 clusterDepth;
 } lights;
 
+//L2 spherical harmonics of the environment irradiance, premultiplied by the cosine lobe and the basis constants
+layout(binding = 4) uniform Irradiance
+{
+	vec4 coefficients[9];
+} sh;
+
+//-----------------------------------------------LIGHT CLUSTERS-----------------------------------------//
+layout(std430, binding = 1) readonly buffer PointLights
+{
+	PointLight pLights[];
+};
+
+layout(std430, binding = 2) readonly buffer SpotLights
+{
+	SpotLight sLights[];
+};
+
+//Per cluster: offset into the index list, point light count | spot light count << 16
+layout(std430, binding = 3) readonly buffer ClusterRanges
+{
+	uvec2 clusters[];
+};
+
+layout(std430, binding = 4) readonly buffer LightIndices
+{
+	uint lightIndices[];
+};
+
+//-----------------------------------------------SHADOW ATLAS-----------------------------------------//
+struct ShadowTile
+{
+	mat4 viewProj;
+	//uv offset, uv size, normal offset per unit of distance to the light
+	vec4 rect;
+};
+
+layout(std430, binding = 6) readonly buffer ShadowTiles
+{
+	ShadowTile shadowTiles[];
+};
+
 //-----------------------------------------------PUSH CONSTANT-----------------------------------------//
 layout(push_constant) uniform pushConstants{
 	float exposure;
 	float gamma;
 	float size;
-	float near;
 	float intensity;
 	int numPCFSamples;
 	int numBlockerSearchSamples;
@@ -98,20 +152,15 @@ vec2 RandomDirection(sampler1D distribution, float u)
 }
 
 //////////////////////////////////////////////////////////////////////////
-float SearchWidth(float uvLightSize, float receiverDistance)
-{
-	return uvLightSize * (receiverDistance - pc.near) / receiverDistance;
-}
-
-//////////////////////////////////////////////////////////////////////////
-float FindBlockerDistance_DirectionalLight(vec3 shadowCoords, sampler2D shadowMap, float uvLightSize,float bias)
+float FindBlockerDistance_DirectionalLight(vec3 shadowCoords, float layer, float uvLightSize,float bias)
 {
 	int blockers = 0;
 	float avgBlockerDistance = 0;
-	float searchWidth = SearchWidth(uvLightSize, shadowCoords.z);
+	//The cascades are orthographic, the search region does not shrink with the receiver distance
+	float searchWidth = uvLightSize;
 	for (int i = 0; i < pc.numBlockerSearchSamples; i++)
 	{
-		float z = texture(shadowMap, shadowCoords.xy + RandomDirection(distribution0, i / float(pc.numBlockerSearchSamples)) * searchWidth).r;
+		float z = texture(shadowMap, vec3(shadowCoords.xy + RandomDirection(distribution0, i / float(pc.numBlockerSearchSamples)) * searchWidth, layer)).r;
 		if (z < (shadowCoords.z - bias))
 		{
 			blockers++;
@@ -125,22 +174,22 @@ float FindBlockerDistance_DirectionalLight(vec3 shadowCoords, sampler2D shadowMa
 }
 
 //////////////////////////////////////////////////////////////////////////
-float PCF_DirectionalLight(vec3 shadowCoords, sampler2D shadowMap, float uvRadius, float bias)
+float PCF_DirectionalLight(vec3 shadowCoords, float layer, float uvRadius, float bias)
 {
 	float sum = 0;
 	for (int i = 0; i < pc.numPCFSamples; i++)
 	{
-		float z = texture(shadowMap, shadowCoords.xy + RandomDirection(distribution1, i / float(pc.numPCFSamples)) * uvRadius).r;
+		float z = texture(shadowMap, vec3(shadowCoords.xy + RandomDirection(distribution1, i / float(pc.numPCFSamples)) * uvRadius, layer)).r;
 		sum += (z < (shadowCoords.z - bias)) ? 1 : 0;
 	}
 	return sum / pc.numPCFSamples;
 }
 
 //////////////////////////////////////////////////////////////////////////
-float PCSS_DirectionalLight(vec3 shadowCoords, sampler2D shadowMap, float uvLightSize, float bias)
+float PCSS_DirectionalLight(vec3 shadowCoords, float layer, float uvLightSize, float bias)
 {
 	// blocker search
-	float blockerDistance = FindBlockerDistance_DirectionalLight(shadowCoords, shadowMap, uvLightSize, bias);
+	float blockerDistance = FindBlockerDistance_DirectionalLight(shadowCoords, layer, uvLightSize, bias);
 	if (blockerDistance == -1)
 		return 0;		
 
@@ -148,12 +197,12 @@ float PCSS_DirectionalLight(vec3 shadowCoords, sampler2D shadowMap, float uvLigh
 	float penumbraWidth = (shadowCoords.z - blockerDistance) / blockerDistance;
 
 	// percentage-close filtering
-	float uvRadius = penumbraWidth * uvLightSize * pc.near / shadowCoords.z;
-	return PCF_DirectionalLight(shadowCoords, shadowMap, uvRadius, bias);
+	float uvRadius = penumbraWidth * uvLightSize;
+	return PCF_DirectionalLight(shadowCoords, layer, uvRadius, bias);
 }
 
 //////////////////////////////////////////////////////////////////////////
-float SoftShadow(vec4 fragPosLightSpace, float bias)
+float SoftShadow(vec4 fragPosLightSpace, int cascade, float bias)
 {
 
     vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
@@ -163,12 +212,12 @@ float SoftShadow(vec4 fragPosLightSpace, float bias)
     float currentDepth = projCoords.z;
 	if(projCoords.z > 1.0)
         return 0.0;
-	float shadow = PCSS_DirectionalLight(projCoords,shadowMap,pc.size,bias);
-
-    return shadow;
+	//Farther cascades cover more of the scene per uv
+	float uvLightSize = pc.size * shadow.cascadeScales[cascade];
+    return PCSS_DirectionalLight(projCoords, cascade, uvLightSize, bias);
 }
 
-float HardShadow(vec4 fragPosLightSpace, float bias)
+float HardShadow(vec4 fragPosLightSpace, int cascade, float bias)
 {
     vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
 
@@ -179,11 +228,11 @@ float HardShadow(vec4 fragPosLightSpace, float bias)
         return 0.0;
 
 	float shadow = 0.0;
-	vec2 texelSize = 1.0 / textureSize(shadowMap, 0);
+	vec2 texelSize = 1.0 / textureSize(shadowMap, 0).xy;
 	//pcf
 	for (int i = 0; i < pc.numPCFSamples; i++)
 	{
-		float z = texture(shadowMap, projCoords.xy + RandomDirection(distribution1, i / float(pc.numPCFSamples)) * texelSize * pc.numBlockerSearchSamples).r;
+		float z = texture(shadowMap, vec3(projCoords.xy + RandomDirection(distribution1, i / float(pc.numPCFSamples)) * texelSize * pc.numBlockerSearchSamples, cascade)).r;
 		shadow += (z < (projCoords.z - bias)) ? 1 : 0;
 	}
 
@@ -193,6 +242,73 @@ float HardShadow(vec4 fragPosLightSpace, float bias)
     return shadow;
 }
 
+float CascadeShadow(vec3 fragPos, int cascade, float bias)
+{
+	vec4 fragPosLightSpace = shadow.cascadeViewProj[cascade] * vec4(fragPos, 1.0);
+	if(pc.softShadow == 1)
+		return SoftShadow(fragPosLightSpace, cascade, bias);
+	return HardShadow(fragPosLightSpace, cascade, bias);
+}
+
+//Picks the first cascade that contains the fragment and blends into the next one near its end
+float DirectionalShadow(vec3 fragPos, float bias)
+{
+	float depth = -(lights.view * vec4(fragPos, 1.0)).z;
+	if(shadow.cascadeCount == 0 || depth > shadow.cascadeSplits[shadow.cascadeCount - 1])
+		return 0.0;
+
+	int cascade = 0;
+	while(cascade < shadow.cascadeCount - 1 && depth > shadow.cascadeSplits[cascade])
+		cascade++;
+
+	float result = CascadeShadow(fragPos, cascade, bias);
+	if(cascade == shadow.cascadeCount - 1)
+		return result;
+
+	float splitNear = cascade == 0 ? 0.0 : shadow.cascadeSplits[cascade - 1];
+	float splitFar = shadow.cascadeSplits[cascade];
+	float blendStart = splitFar - (splitFar - splitNear) * shadow.cascadeBlend;
+	if(depth > blendStart)
+		result = mix(result, CascadeShadow(fragPos, cascade + 1, bias), (depth - blendStart) / (splitFar - blendStart));
+	return result;
+}
+
+//3x3 PCF kept inside the tile of the light
+float LocalShadow(int tileIndex, vec3 fragPos, vec3 N, float distance)
+{
+	ShadowTile tile = shadowTiles[tileIndex];
+	vec4 fragPosLightSpace = tile.viewProj * vec4(fragPos + N * distance * tile.rect.w, 1.0);
+	vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w * 0.5 + 0.5;
+	if(projCoords.z > 1.0)
+		return 0.0;
+
+	vec2 texelSize = 1.0 / textureSize(shadowAtlas, 0);
+	vec2 minUV = tile.rect.xy + texelSize * 0.5;
+	vec2 maxUV = tile.rect.xy + tile.rect.z - texelSize * 0.5;
+	vec2 uv = tile.rect.xy + projCoords.xy * tile.rect.z;
+	float sum = 0.0;
+	for(int x = -1; x <= 1; x++)
+	{
+		for(int y = -1; y <= 1; y++)
+		{
+			float z = texture(shadowAtlas, clamp(uv + vec2(x, y) * texelSize, minUV, maxUV)).r;
+			sum += (z < projCoords.z - 0.00002) ? 1 : 0;
+		}
+	}
+	return sum / 9.0;
+}
+
+//Cube face order of the point light tiles: +X -X +Y -Y +Z -Z
+int CubeFace(vec3 direction)
+{
+	vec3 a = abs(direction);
+	if(a.x >= a.y && a.x >= a.z)
+		return direction.x > 0.0 ? 0 : 1;
+	if(a.y >= a.z)
+		return direction.y > 0.0 ? 2 : 3;
+	return direction.z > 0.0 ? 4 : 5;
+}
+
 const float PI = 3.14159265359;
 
 // ----------------------------------------------------------------------------
@@ -245,6 +361,21 @@ vec3 FresnelSchlickRoughness(float cosTheta, vec3 F0, float roughness)
     return F0 + (max(vec3(1.0 - roughness), F0) - F0) * pow(max(1.0 - cosTheta, 0.0), 5.0);
 }   
 
+// ----------------------------------------------------------------------------
+vec3 EvaluateIrradiance(vec3 n)
+{
+	vec3 result = sh.coefficients[0].rgb
+		+ sh.coefficients[1].rgb * n.y
+		+ sh.coefficients[2].rgb * n.z
+		+ sh.coefficients[3].rgb * n.x
+		+ sh.coefficients[4].rgb * (n.x * n.y)
+		+ sh.coefficients[5].rgb * (n.y * n.z)
+		+ sh.coefficients[6].rgb * (3.0 * n.z * n.z - 1.0)
+		+ sh.coefficients[7].rgb * (n.x * n.z)
+		+ sh.coefficients[8].rgb * (n.x * n.x - n.y * n.y);
+	return max(result, vec3(0.0));
+}
+
 // ----------------------------------------------------------------------------
 vec3 CalculateLo(vec3 L, vec3 N, vec3 V, vec3 Ra, vec3 F0, float R, float M, vec3 A)
 {
@@ -269,16 +400,54 @@ vec3 CalculateLo(vec3 L, vec3 N, vec3 V, vec3 Ra, vec3 F0, float R, float M, vec
 
 layout(location = 0) in vec2 v_uv;
 
-void main()
+// ----------------------------------------------------------------------------
+uint ClusterIndex(vec3 fragPos)
 {
-	vec3 fragPos = texture(gPosition, v_uv).rgb;
-	vec3 N = texture(gNormal, v_uv).rgb;
-	vec3 Albedo = pow(texture(gAlbedoSpec, v_uv).rgb, vec3(2.2));
-	float Roughness = texture(gRoughMetalAO,  v_uv).r;
-	float Metallic  = texture(gRoughMetalAO,  v_uv).g;
-	float AO		= texture(gRoughMetalAO,  v_uv).b;
+	//Background pixels have no position, keep the depth inside the grid
+	float depth = max(-(lights.view * vec4(fragPos, 1.0)).z, lights.clusterDepth.z);
+	uint slice = uint(clamp(log(depth) * lights.clusterDepth.x - lights.clusterDepth.y, 0.0, float(lights.clusterCount.z - 1)));
+	uvec2 tile = min(uvec2(v_uv * vec2(lights.clusterCount.xy)), lights.clusterCount.xy - 1);
+	return tile.x + lights.clusterCount.x * (tile.y + lights.clusterCount.y * slice);
+}
 
-	vec4 FragPosLightSpace = shadow.lightViewProj * vec4(fragPos, 1.0);
+// Inverse square falloff windowed to reach zero at the light range
+float Attenuation(float distance, float range)
+{
+	float ratio = distance / range;
+	float window = clamp(1.0 - ratio * ratio * ratio * ratio, 0.0, 1.0);
+	return window * window / max(distance * distance, 0.0001);
+}
+
+vec3 DecodeNormal(vec2 encoded)
+{
+	vec3 n = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+	float fold = clamp(-n.z, 0.0, 1.0);
+	n.xy += vec2(n.x >= 0.0 ? -fold : fold, n.y >= 0.0 ? -fold : fold);
+	return normalize(n);
+}
+
+void main()
+{
+	//The G-buffer is fetched per texel, with a render scale below one only its lower left part is drawn
+	ivec2 pixel = ivec2(gl_FragCoord.xy);
+#ifdef PACKED_GBUFFER
+	float depth = texelFetch(gDepth, pixel, 0).r;
+	//Nothing was drawn here, the sky pass fills it
+	if(depth == 1.0)
+		discard;
+	vec4 position = cam.inverseViewProjection * vec4(vec3(v_uv, depth) * 2.0 - 1.0, 1.0);
+	vec3 fragPos = position.xyz / position.w;
+	vec3 N = DecodeNormal(texelFetch(gNormal, pixel, 0).rg * 2.0 - 1.0);
+	//The sRGB target is decoded when sampled
+	vec3 Albedo = texelFetch(gAlbedoSpec, pixel, 0).rgb;
+#else
+	vec3 fragPos = texelFetch(gPosition, pixel, 0).rgb;
+	vec3 N = texelFetch(gNormal, pixel, 0).rgb;
+	vec3 Albedo = pow(texelFetch(gAlbedoSpec, pixel, 0).rgb, vec3(2.2));
+#endif
+	float Roughness = texelFetch(gRoughMetalAO, pixel, 0).r;
+	float Metallic  = texelFetch(gRoughMetalAO, pixel, 0).g;
+	float AO		= texelFetch(gRoughMetalAO, pixel, 0).b;
 
 	vec3 V = normalize(cam.cameraPos.rgb - fragPos);
 
@@ -292,23 +461,38 @@ void main()
 	vec3 lightDir = normalize(-lights.dLight.dir.rgb);
     float bias = max(0.01 * (1.0 - dot(N, lightDir)), 0.001); 
 
-	Lo += CalculateLo(lightDir, N, V, lights.dLight.color.rgb, F0, Roughness, Metallic, Albedo);
+	float shadow = DirectionalShadow(fragPos, bias);
+	Lo += (1 - shadow) * CalculateLo(lightDir, N, V, lights.dLight.color.rgb, F0, Roughness, Metallic, Albedo);
 
-	for(int i = 0; i < 4; i++)
+	//Only the lights binned into the cluster of the fragment
+	uvec2 cluster = clusters[ClusterIndex(fragPos)];
+	uint first = cluster.x;
+	uint pointCount = cluster.y & 0xFFFFu;
+	uint spotCount = cluster.y >> 16u;
+	for(uint i = 0; i < pointCount; i++)
 	{
-		vec3 L = normalize(lights.pLight[i].position.rgb - fragPos);
-		float distance = length(lights.pLight[i].position.rgb - fragPos);
-		float attenuation = 1.0/(distance * distance);
-		vec3 Ra = lights.pLight[i].color.rgb * attenuation;
+		PointLight light = pLights[lightIndices[first + i]];
+		vec3 toLight = light.position.rgb - fragPos;
+		float distance = length(toLight);
+		vec3 L = toLight / distance;
+		vec3 Ra = light.color.rgb * Attenuation(distance, light.range);
+		if(light.shadowIndex >= 0)
+			Ra *= 1.0 - LocalShadow(light.shadowIndex + CubeFace(-toLight), fragPos, N, distance);
 		Lo += CalculateLo(L, N, V, Ra, F0, Roughness, Metallic, Albedo);
 	}
-
-	float shadow =0;
-	if(pc.softShadow == 1){
-		shadow = SoftShadow(FragPosLightSpace, bias);
-	} else
+	for(uint i = 0; i < spotCount; i++)
 	{
-		shadow = HardShadow(FragPosLightSpace, bias);
+		SpotLight light = sLights[lightIndices[first + pointCount + i]];
+		vec3 toLight = light.position.rgb - fragPos;
+		float distance = length(toLight);
+		vec3 L = toLight / distance;
+		float theta = dot(L, normalize(-light.direction.rgb));
+		float epsilon = light.cutOff - light.outerCutOff;
+		float cone = clamp((theta - light.outerCutOff) / epsilon, 0.0, 1.0);
+		vec3 Ra = light.color.rgb * Attenuation(distance, light.range) * cone;
+		if(light.shadowIndex >= 0)
+			Ra *= 1.0 - LocalShadow(light.shadowIndex, fragPos, N, distance);
+		Lo += CalculateLo(L, N, V, Ra, F0, Roughness, Metallic, Albedo);
 	}
 
 	vec3 F = FresnelSchlickRoughness(max(dot(N, V), 0.0), F0, Roughness);
@@ -317,7 +501,7 @@ void main()
 	vec3 Kd = 1.0 - Ks;
 	Kd *= 1.0 - Metallic;
 	
-	vec3 irradiance = texture(irradianceMap, N).rgb * pc.intensity;
+	vec3 irradiance = EvaluateIrradiance(N) * pc.intensity;
 	vec3 diffuse    = irradiance * Albedo;
 
     const float MAX_REFLECTION_LOD = 4.0;
@@ -328,7 +512,7 @@ void main()
 	vec3 ambient = (Kd * diffuse + specular) * AO; 
 
 	vec3 result = vec3(0);
-	result = (1-shadow) * Lo + ambient;
+	result = Lo + ambient;
     vec3 hdrColor = result;
   
     // reinhard tone mapping
@@ -0,0 +1,46 @@
+// Depth only pre-pass of the G-buffer geometry
+#type vertex
+
+#version 460
+
+layout(location = 0) in vec3 a_pos;
+layout(location = 1) in vec2 a_uv;
+layout(location = 2) in vec3 a_normal;
+layout(location = 3) in vec3 a_tangent;
+layout(location = 4) in vec3 a_bitangent;
+
+struct InstanceData
+{
+	mat4 transform;
+	//Transform of the previous frame, used for motion vectors
+	mat4 previousTransform;
+	int id;
+};
+
+//Instances of every draw command, the command's base instance points at its first entry
+layout(std430, binding = 0) readonly buffer InstanceBuffer
+{
+	InstanceData instances[];
+};
+
+layout(binding = 0) uniform camera
+{
+	mat4 u_ViewProjection;
+	vec4 cameraPos;
+} cam;
+
+//The geometry pass tests against this depth with GL_EQUAL, both compute the position the same way
+invariant gl_Position;
+
+void main()
+{
+	InstanceData data = instances[gl_InstanceIndex];
+	gl_Position = cam.u_ViewProjection * data.transform * vec4(a_pos, 1.0);
+}
+
+#type fragment
+
+#version 460
+void main()
+{
+}
@@ -1,32 +1,11 @@
-// Equirectangular To Cubemap Shader
-#type vertex
+// Equirectangular To Cubemap Shader, one invocation per texel of every face
+#type compute
 
 #version 460
-	
-layout (location = 0) in vec3 a_pos;
-layout (location = 1) in vec2 a_uv;
-layout (location = 2) in vec3 a_normal;
-
-layout(location = 0) out vec3 localPos;
-
-layout(push_constant) uniform camera{
-    mat4 view;
-    mat4 projection;
-}cam;
-
-void main()
-{
-    localPos = a_pos;  
-    gl_Position =  cam.projection * cam.view * vec4(localPos, 1.0);
-}
-
-#type fragment
-
-#version 460
-layout(location = 0) out vec4 FragColor;
-layout(location = 0) in vec3 localPos;
+layout(local_size_x = 8, local_size_y = 8, local_size_z = 1) in;
 
 layout(binding = 0) uniform sampler2D equirectangularMap;
+layout(binding = 1, rgba16f) uniform writeonly imageCube cubeMap;
 
 const vec2 invAtan = vec2(0.1591, 0.3183);
 vec2 SampleSphericalMap(vec3 v)
@@ -37,10 +16,28 @@ vec2 SampleSphericalMap(vec3 v)
     return uv;
 }
 
+//Direction through the center of a texel, following the OpenGL cube map face orientation
+vec3 CubeDirection(uvec3 id, float size)
+{
+    vec2 uv = (vec2(id.xy) + 0.5) / size * 2.0 - 1.0;
+    switch (id.z)
+    {
+    case 0: return vec3(1.0, -uv.y, -uv.x);
+    case 1: return vec3(-1.0, -uv.y, uv.x);
+    case 2: return vec3(uv.x, 1.0, uv.y);
+    case 3: return vec3(uv.x, -1.0, -uv.y);
+    case 4: return vec3(uv.x, -uv.y, 1.0);
+    default: return vec3(-uv.x, -uv.y, -1.0);
+    }
+}
+
 void main()
-{		
-    vec2 uv = SampleSphericalMap(normalize(localPos));
-    vec3 color = texture(equirectangularMap, uv).rgb;
-    
-    FragColor = vec4(color, 1.0);
-}
\ No newline at end of file
+{
+    ivec2 size = imageSize(cubeMap);
+    if (any(greaterThanEqual(gl_GlobalInvocationID.xy, uvec2(size))))
+        return;
+
+    vec2 uv = SampleSphericalMap(normalize(CubeDirection(gl_GlobalInvocationID, float(size.x))));
+    vec3 color = textureLod(equirectangularMap, uv, 0.0).rgb;
+    imageStore(cubeMap, ivec3(gl_GlobalInvocationID), vec4(color, 1.0));
+}
@@ -9,16 +9,28 @@ layout(location = 2) in vec3 a_normal;
 layout(location = 3) in vec3 a_tangent;
 layout(location = 4) in vec3 a_bitangent;
 
-layout(push_constant) uniform Transform
+struct InstanceData
 {
-	mat4 u_trans;
+	mat4 transform;
+	//Transform of the previous frame, used for motion vectors
+	mat4 previousTransform;
 	int id;
-}transform;
+};
+
+//Instances of every draw command, the command's base instance points at its first entry
+layout(std430, binding = 0) readonly buffer InstanceBuffer
+{
+	InstanceData instances[];
+};
 
 layout(binding = 0) uniform camera
 {
 	mat4 u_ViewProjection;
 	vec4 cameraPos;
+	mat4 inverseViewProjection;
+	//Without the sub pixel jitter of the temporal resolve, for motion vectors
+	mat4 unjitteredViewProjection;
+	mat4 previousViewProjection;
 } cam;
 
 
@@ -32,12 +44,18 @@ struct VS_OUT
 
 layout(location = 0) out VS_OUT vs_out;
 layout(location = 8) out flat int id;
+layout(location = 9) out vec4 v_clip;
+layout(location = 10) out vec4 v_previousClip;
+
+//Must match the depth pre-pass bit for bit, it is tested with GL_EQUAL
+invariant gl_Position;
 
 void main()
 {
-	vs_out.v_pos = vec3(transform.u_trans*vec4(a_pos,1.0));
+	InstanceData data = instances[gl_InstanceIndex];
+	vs_out.v_pos = vec3(data.transform*vec4(a_pos,1.0));
 
-	mat3 normalMatrix = transpose(inverse(mat3(transform.u_trans)));
+	mat3 normalMatrix = transpose(inverse(mat3(data.transform)));
     vec3 T = normalize(normalMatrix * a_tangent);
     vec3 N = normalize(normalMatrix * a_normal);
 	T = normalize(T - dot(T, N) * N);
@@ -49,19 +67,33 @@ void main()
 
 	vs_out.v_uv = a_uv;
 
-	id = transform.id;
+	id = data.id;
 
-	gl_Position = cam.u_ViewProjection * transform.u_trans * vec4(a_pos, 1.0);
+	v_clip = cam.unjitteredViewProjection * data.transform * vec4(a_pos, 1.0);
+	v_previousClip = cam.previousViewProjection * data.previousTransform * vec4(a_pos, 1.0);
+
+	gl_Position = cam.u_ViewProjection * data.transform * vec4(a_pos, 1.0);
 }
 
 #type fragment
 
 #version 460
+//PACKED_GBUFFER: the position is rebuilt from depth, normals are octahedral encoded and remapped to [0, 1] in RG16,
+//albedo is stored in SRGB8_ALPHA8 and roughness, metallic and AO in RGBA8
+#ifdef PACKED_GBUFFER
+layout(location = 0) out vec2 gNormal;
+layout(location = 1) out vec4 gAlbedoSpec;
+layout(location = 2) out vec4 gRoughMetalAO;
+layout(location = 3) out int  gEntityID;
+layout(location = 4) out vec2 gVelocity;
+#else
 layout(location = 0) out vec3 gPosistion;	
 layout(location = 1) out vec3 gNormal;	
 layout(location = 2) out vec4 gAlbedoSpec;
 layout(location = 3) out vec3 gRoughMetalAO;
 layout(location = 4) out int  gEntityID;
+layout(location = 5) out vec2 gVelocity;
+#endif
 
 
 layout(binding = 0) uniform sampler2D AlbedoMap;
@@ -99,11 +131,24 @@ struct VS_OUT
 
 layout(location = 0) in VS_OUT fs_in;
 layout(location = 8) in	flat int id;
+layout(location = 9) in vec4 v_clip;
+layout(location = 10) in vec4 v_previousClip;
+
+//Projects the normal on the octahedron |x| + |y| + |z| = 1 and folds the lower half over the upper one
+vec2 EncodeNormal(vec3 n)
+{
+	n /= abs(n.x) + abs(n.y) + abs(n.z);
+	if(n.z < 0.0)
+		n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+	return n.xy;
+}
 
 void main()
 {
+#ifndef PACKED_GBUFFER
 	//////////////////////////////////////POSITION//////////////////////////////////////////
 	gPosistion = fs_in.v_pos;
+#endif
 	vec2 uv = fs_in.v_uv * push.tiling;
 
 	//////////////////////////////////////ALBEDO////////////////////////////////////////////
@@ -115,14 +160,20 @@ void main()
 	gAlbedoSpec.a = 1.0;
 
 	//////////////////////////////////////NORMAL////////////////////////////////////////////
+	vec3 N;
 	if(push.HasNormalMap==1){
 		vec3 normal = texture(NormalMap, uv).rgb;
 		normal = normalize(normal * 2.0 - 1.0);
-		gNormal = normalize(fs_in.TBN * normal);
+		N = normalize(fs_in.TBN * normal);
 	}
 	else{
-		gNormal = fs_in.v_normal;
+		N = fs_in.v_normal;
 	}
+#ifdef PACKED_GBUFFER
+	gNormal = EncodeNormal(normalize(N)) * 0.5 + 0.5;
+#else
+	gNormal = N;
+#endif
 
 	///////////////////////////////////ROUGHNESS////////////////////////////////////////////
 	float Roughness;
@@ -157,8 +208,16 @@ void main()
 		AO = push.material.AO;
 	}
 
+#ifdef PACKED_GBUFFER
+	gRoughMetalAO = vec4(Roughness, Metallic, AO, 0.0);
+#else
 	gRoughMetalAO = vec3(Roughness, Metallic, AO);
+#endif
 
 	//////////////////////////////////ENTITY ID////////////////////////////////////////////
 	gEntityID = id;
+
+	//////////////////////////////////VELOCITY/////////////////////////////////////////////
+	//Screen space motion since the previous frame in uv units
+	gVelocity = (v_clip.xy / v_clip.w - v_previousClip.xy / v_previousClip.w) * 0.5;
 }
\ No newline at end of file
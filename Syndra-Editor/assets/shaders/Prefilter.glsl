@@ -1,32 +1,11 @@
-// pre filter map
-#type vertex
+// pre filter map, one dispatch per mip level writes all six faces
+#type compute
 
 #version 460
-	
-layout (location = 0) in vec3 a_pos;
-layout (location = 1) in vec3 a_normal;
-layout (location = 2) in vec2 a_uv;
-
-layout(location = 0) out vec3 worldPos;
-
-layout(push_constant) uniform camera{
-    mat4 view;
-    mat4 projection;
-}cam;
-
-void main()
-{
-    worldPos = a_pos;  
-    gl_Position =  cam.projection * cam.view * vec4(worldPos, 1.0);
-}
-
-#type fragment
-
-#version 460
-layout(location = 0) out vec4 FragColor;
-layout(location = 0) in  vec3 worldPos;
+layout(local_size_x = 8, local_size_y = 8, local_size_z = 1) in;
 
 layout(binding = 0) uniform samplerCube environmentMap;
+layout(binding = 1, rgba16f) uniform writeonly imageCube prefilterMap;
 
 layout(push_constant) uniform Push{
     float roughness;
@@ -88,17 +67,47 @@ vec3 ImportanceSampleGGX(vec2 Xi, vec3 N, float roughness)
 	return normalize(sampleVec);
 }
 // ----------------------------------------------------------------------------
+//Direction through the center of a texel, following the OpenGL cube map face orientation
+vec3 CubeDirection(uvec3 id, float size)
+{
+    vec2 uv = (vec2(id.xy) + 0.5) / size * 2.0 - 1.0;
+    switch (id.z)
+    {
+    case 0: return vec3(1.0, -uv.y, -uv.x);
+    case 1: return vec3(-1.0, -uv.y, uv.x);
+    case 2: return vec3(uv.x, 1.0, uv.y);
+    case 3: return vec3(uv.x, -1.0, -uv.y);
+    case 4: return vec3(uv.x, -uv.y, 1.0);
+    default: return vec3(-uv.x, -uv.y, -1.0);
+    }
+}
+// ----------------------------------------------------------------------------
 void main()
-{		
-    vec3 N = normalize(worldPos);
-    
+{
+    ivec2 size = imageSize(prefilterMap);
+    if (any(greaterThanEqual(gl_GlobalInvocationID.xy, uvec2(size))))
+        return;
+
+    vec3 N = normalize(CubeDirection(gl_GlobalInvocationID, float(size.x)));
+    float resolution = float(textureSize(environmentMap, 0).x); // resolution of source cubemap (per face)
+    //Source mip with the texel footprint of the output, a mirror reflection needs no other sample
+    float baseLevel = log2(resolution / float(size.x));
+    if (push.roughness == 0.0)
+    {
+        imageStore(prefilterMap, ivec3(gl_GlobalInvocationID), vec4(textureLod(environmentMap, N, baseLevel).rgb, 1.0));
+        return;
+    }
+
     // make the simplyfying assumption that V equals R equals the normal 
     vec3 R = N;
     vec3 V = R;
 
-    const uint SAMPLE_COUNT = 2048u;
+    //Filtered importance sampling: each sample reads the source mip whose texel covers the solid angle
+    //of the sample, so a few samples give the result brute force sampling needed thousands for
+    const uint SAMPLE_COUNT = 64u;
     vec3 prefilteredColor = vec3(0.0);
     float totalWeight = 0.0;
+    float saTexel  = 4.0 * PI / (6.0 * resolution * resolution);
     
     for(uint i = 0u; i < SAMPLE_COUNT; ++i)
     {
@@ -116,23 +125,17 @@ void main()
             float HdotV = max(dot(H, V), 0.0);
             float pdf = D * NdotH / (4.0 * HdotV) + 0.0001; 
 
-            float resolution = 2048.0; // resolution of source cubemap (per face)
-            float saTexel  = 4.0 * PI / (6.0 * resolution * resolution);
             float saSample = 1.0 / (float(SAMPLE_COUNT) * pdf + 0.0001);
+            //One extra level smooths the overlap between neighbouring samples
+            float mipLevel = max(0.5 * log2(saSample / saTexel) + 1.0, baseLevel);
 
-            float mipLevel = push.roughness == 0.0 ? 0.0 : 0.5 * log2(saSample / saTexel); 
-            
-
-            vec3 color = textureLod(environmentMap, L, mipLevel).rgb;
-            float r = min(color.r, 20);
-            float g = min(color.g, 20);
-            float b = min(color.b, 20);
-            prefilteredColor += vec3(r,g,b) * NdotL;
+            vec3 color = min(textureLod(environmentMap, L, mipLevel).rgb, vec3(20.0));
+            prefilteredColor += color * NdotL;
             totalWeight      += NdotL;
         }
     }
 
     prefilteredColor = prefilteredColor / totalWeight;
 
-    FragColor = vec4(prefilteredColor, 1.0);
-}
\ No newline at end of file
+    imageStore(prefilterMap, ivec3(gl_GlobalInvocationID), vec4(prefilteredColor, 1.0));
+}
@@ -0,0 +1,98 @@
+// Temporal anti aliasing and upsampling
+#type vertex
+
+#version 460
+
+layout(location = 0) in vec3 a_pos;
+layout(location = 1) in vec2 a_uv;
+
+layout(location = 0) out vec2 v_uv;
+
+void main(){
+	v_uv = a_uv;
+	gl_Position = vec4(a_pos, 1.0f);
+}
+
+#type fragment
+
+#version 460
+layout(location = 0) out vec4 fragColor;
+
+//Inputs are drawn into the lower left part of their targets, history and output cover the viewport
+layout(binding = 0) uniform sampler2D currentColor;
+layout(binding = 1) uniform sampler2D velocityMap;
+layout(binding = 2) uniform sampler2D gDepth;
+layout(binding = 3) uniform sampler2D history;
+
+layout(binding = 0) uniform camera
+{
+	mat4 u_ViewProjection;
+	vec4 cameraPos;
+	mat4 inverseViewProjection;
+	mat4 unjitteredViewProjection;
+	mat4 previousViewProjection;
+} cam;
+
+layout(push_constant) uniform pushConstants{
+	//xy: drawn part of the inputs, zw: ndc jitter of the current frame
+	vec4 scaleJitter;
+	//Weight of the current frame
+	float feedback;
+	int historyValid;
+} pc;
+
+void main()
+{
+	vec2 renderScale = pc.scaleJitter.xy;
+	vec2 jitter = pc.scaleJitter.zw;
+	vec2 inputSize = vec2(textureSize(currentColor, 0));
+	ivec2 maxPixel = ivec2(inputSize * renderScale) - 1;
+
+	//The current frame was drawn shifted by the jitter, sampling it shifted back gives the unjittered image
+	vec2 inputUV = (v_uv + jitter * 0.5) * renderScale;
+	inputUV = clamp(inputUV, 0.5 / inputSize, (vec2(maxPixel) + 0.5) / inputSize);
+	vec3 current = texture(currentColor, inputUV).rgb;
+
+	//Color range of the neighbourhood clamps the history, the closest depth picks the velocity so edges move with the foreground
+	ivec2 center = clamp(ivec2(v_uv * renderScale * inputSize), ivec2(0), maxPixel);
+	vec3 minColor = vec3(1.0);
+	vec3 maxColor = vec3(0.0);
+	float closestDepth = 1.0;
+	ivec2 closest = center;
+	for (int y = -1; y <= 1; y++)
+	{
+		for (int x = -1; x <= 1; x++)
+		{
+			ivec2 pixel = clamp(center + ivec2(x, y), ivec2(0), maxPixel);
+			vec3 color = texelFetch(currentColor, pixel, 0).rgb;
+			minColor = min(minColor, color);
+			maxColor = max(maxColor, color);
+			float depth = texelFetch(gDepth, pixel, 0).r;
+			if (depth < closestDepth) {
+				closestDepth = depth;
+				closest = pixel;
+			}
+		}
+	}
+
+	vec2 velocity;
+	if (closestDepth == 1.0) {
+		//The sky has no motion vectors, it only moves with the camera
+		vec4 world = cam.inverseViewProjection * vec4(v_uv * 2.0 - 1.0 + jitter, 1.0, 1.0);
+		vec4 previous = cam.previousViewProjection * vec4(world.xyz / world.w, 1.0);
+		velocity = v_uv - (previous.xy / previous.w * 0.5 + 0.5);
+	}
+	else {
+		velocity = texelFetch(velocityMap, closest, 0).rg;
+	}
+
+	vec2 previousUV = v_uv - velocity;
+	bool offScreen = any(lessThan(previousUV, vec2(0.0))) || any(greaterThan(previousUV, vec2(1.0)));
+	if (pc.historyValid == 0 || offScreen) {
+		fragColor = vec4(current, 1.0);
+		return;
+	}
+
+	vec3 previousColor = clamp(texture(history, previousUV).rgb, minColor, maxColor);
+	fragColor = vec4(mix(previousColor, current, pc.feedback), 1.0);
+}
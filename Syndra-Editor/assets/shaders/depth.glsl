@@ -9,18 +9,32 @@ layout(location = 2) in vec3 a_normal;
 layout(location = 3) in vec3 a_tangent;
 layout(location = 4) in vec3 a_bitangent;
 
-layout(binding = 3) uniform ShadowData
+//Shadow cascades followed by the shadow atlas tiles drawn this frame
+layout(std430, binding = 5) readonly buffer ShadowViews
 {
-	 mat4 lightViewProj;
-} shadow;
+	mat4 shadowViews[];
+};
 
-layout(push_constant) uniform Transform
+layout(push_constant) uniform pushConstants{
+	int view;
+} pc;
+
+struct InstanceData
+{
+	mat4 transform;
+	//Transform of the previous frame, used for motion vectors
+	mat4 previousTransform;
+	int id;
+};
+
+//Instances of every draw command, the command's base instance points at its first entry
+layout(std430, binding = 0) readonly buffer InstanceBuffer
 {
-	mat4 u_trans;
-}transform;
+	InstanceData instances[];
+};
 
 void main(){
-	gl_Position = shadow.lightViewProj * transform.u_trans * vec4(a_pos,1.0f);
+	gl_Position = shadowViews[pc.view] * instances[gl_InstanceIndex].transform * vec4(a_pos,1.0f);
 }
 
 #type fragment
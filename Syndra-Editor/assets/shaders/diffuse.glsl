@@ -47,7 +47,8 @@ void main(){
 layout(location = 0) out vec4 fragColor;	
 
 layout(binding = 0) uniform sampler2D texture_diffuse;
-layout(binding = 3) uniform sampler2D shadowMap;
+//Layer 0 is the nearest shadow cascade
+layout(binding = 3) uniform sampler2DArray shadowMap;
 layout(binding = 4) uniform sampler1D distribution0;
 layout(binding = 5) uniform sampler1D distribution1;
 
@@ -66,7 +67,7 @@ const int NEAR = 2;
 struct PointLight {
     vec4 position;
     vec4 color;
-	float dist;
+	float range;
 };
 
 struct DirLight {
@@ -80,16 +81,29 @@ struct SpotLight {
 	vec4 color;
     vec4 direction;
     float cutOff;
-    float outerCutOff;      
+    float outerCutOff;
+	float range;
 };
 
 layout(binding = 2) uniform Lights
 {
-	PointLight pLight[4];
-	SpotLight sLight[4];
+	mat4 view;
 	DirLight dLight;
+	uvec4 clusterCount;
+	vec4 clusterDepth;
 } lights;
 
+//Forward shading does not use the clusters and walks every light
+layout(std430, binding = 1) readonly buffer PointLights
+{
+	PointLight pLights[];
+};
+
+layout(std430, binding = 2) readonly buffer SpotLights
+{
+	SpotLight sLights[];
+};
+
 layout(push_constant) uniform pc
 {
 	float size;
@@ -125,7 +139,7 @@ float SearchWidth(float uvLightSize, float receiverDistance)
 }
 
 //////////////////////////////////////////////////////////////////////////
-float FindBlockerDistance_DirectionalLight(vec3 shadowCoords, sampler2D shadowMap, float uvLightSize,float bias)
+float FindBlockerDistance_DirectionalLight(vec3 shadowCoords, sampler2DArray shadowMap, float uvLightSize,float bias)
 {
 	int blockers = 0;
 	float avgBlockerDistance = 0;
@@ -140,7 +154,7 @@ float FindBlockerDistance_DirectionalLight(vec3 shadowCoords, sampler2D shadowMa
 			//avgBlockerDistance += z;
 		//}
 
-		float z = texture(shadowMap, shadowCoords.xy + RandomDirection(distribution0, i / float(push.numBlockerSearchSamples)) * searchWidth).r;
+		float z = texture(shadowMap, vec3(shadowCoords.xy + RandomDirection(distribution0, i / float(push.numBlockerSearchSamples)) * searchWidth, 0)).r;
 		if (z < (shadowCoords.z - bias))
 		{
 			blockers++;
@@ -154,12 +168,12 @@ float FindBlockerDistance_DirectionalLight(vec3 shadowCoords, sampler2D shadowMa
 }
 
 //////////////////////////////////////////////////////////////////////////
-float PCF_DirectionalLight(vec3 shadowCoords, sampler2D shadowMap, float uvRadius, float bias)
+float PCF_DirectionalLight(vec3 shadowCoords, sampler2DArray shadowMap, float uvRadius, float bias)
 {
 	float sum = 0;
 	for (int i = 0; i < push.numPCFSamples; i++)
 	{
-		float z = texture(shadowMap, shadowCoords.xy + RandomDirection(distribution1, i / float(push.numPCFSamples)) * uvRadius).r;
+		float z = texture(shadowMap, vec3(shadowCoords.xy + RandomDirection(distribution1, i / float(push.numPCFSamples)) * uvRadius, 0)).r;
 		sum += (z < (shadowCoords.z - bias)) ? 1 : 0;
 
 		//vec3 uvc =  vec3(shadowCoords.xy + RandomDirection(distribution1, i / float(numPCFSamples)) * uvRadius,(shadowCoords.z - bias));
@@ -170,7 +184,7 @@ float PCF_DirectionalLight(vec3 shadowCoords, sampler2D shadowMap, float uvRadiu
 }
 
 //////////////////////////////////////////////////////////////////////////
-float PCSS_DirectionalLight(vec3 shadowCoords, sampler2D shadowMap, float uvLightSize, float bias)
+float PCSS_DirectionalLight(vec3 shadowCoords, sampler2DArray shadowMap, float uvLightSize, float bias)
 {
 	// blocker search
 	float blockerDistance = FindBlockerDistance_DirectionalLight(shadowCoords, shadowMap, uvLightSize, bias);
@@ -220,11 +234,11 @@ float HardShadow(vec4 fragPosLightSpace)
         return 0.0;
 
 	float shadow = 0.0;
-	vec2 texelSize = 1.0 / textureSize(shadowMap, 0);
+	vec2 texelSize = 1.0 / textureSize(shadowMap, 0).xy;
 	//pcf
 	for (int i = 0; i < push.numPCFSamples; i++)
 	{
-		float z = texture(shadowMap, projCoords.xy + RandomDirection(distribution1, i / float(push.numPCFSamples)) * texelSize * push.numBlockerSearchSamples).r;
+		float z = texture(shadowMap, vec3(projCoords.xy + RandomDirection(distribution1, i / float(push.numPCFSamples)) * texelSize * push.numBlockerSearchSamples, 0)).r;
 		shadow += (z < (projCoords.z - bias)) ? 1 : 0;
 	}
 
@@ -246,11 +260,11 @@ void main(){
 
 	vec3 result = vec3(0);
 	result += CalcDirLight(lights.dLight, norm, viewDir,color.rgb);
-	for(int i = 0; i<4; i++){
-		result += CalcPointLight(lights.pLight[i], norm, fs_in.v_pos, viewDir,color.rgb);
+	for(int i = 0; i < pLights.length(); i++){
+		result += CalcPointLight(pLights[i], norm, fs_in.v_pos, viewDir,color.rgb);
 	}
-	for(int i=0; i<1; i++){
-		result += CalcSpotLight(lights.sLight[i], norm, fs_in.v_pos, viewDir, color.rgb);
+	for(int i = 0; i < sLights.length(); i++){
+		result += CalcSpotLight(sLights[i], norm, fs_in.v_pos, viewDir, color.rgb);
 	}
 	float shadow =0;
 	if(push.softShadow == 1){
@@ -283,7 +297,7 @@ vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir,ve
 
     float distance = length(light.position.rgb - fragPos);
     float attenuation = 1.0 / (constant + quadratic * (distance * distance));  
-	if(distance > light.dist){
+	if(distance > light.range){
 		attenuation = 0;
 	}
 	vec3 color;
@@ -100,6 +100,11 @@ namespace Syndra {
 			ShowRendererInfo();
 		}
 
+		//---------------------------------------------GPU Profiler-------------------------------------------//
+		if (m_ProfilerOpen) {
+			ShowGPUProfiler();
+		}
+
 		//----------------------------------------------Viewport----------------------------------------------//
 		ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2{ 0, 0 });
 		ImGui::Begin(ICON_FA_IMAGE" Viewport");
@@ -249,7 +254,9 @@ namespace Syndra {
 		{
 			auto& mousePickFB = m_ActiveScene->GetMainFrameBuffer();
 			mousePickFB->Bind();
-			int pixelData = mousePickFB->ReadPixel(4, mouseX, mouseY);
+			//The G-buffer is drawn at the render scale
+			float renderScale = SceneRenderer::GetRenderScale();
+			int pixelData = mousePickFB->ReadPixel(SceneRenderer::GetEntityIDAttachment(), (int)(mouseX * renderScale), (int)(mouseY * renderScale));
 			if (pixelData != -1) {
 				m_ScenePanel->SetSelectedEntity(m_ActiveScene->FindEntity(pixelData));
 			}
@@ -301,6 +308,8 @@ namespace Syndra {
 					m_PropertiesOpen = true;
 				if (ImGui::MenuItem(ICON_FA_INFO "  Renderer Info"))
 					m_InfoOpen = true;
+				if (ImGui::MenuItem(ICON_FA_STOPWATCH "  GPU Profiler"))
+					m_ProfilerOpen = true;
 				if (ImGui::MenuItem(ICON_FA_TREE"  Environment"))
 					m_EnvironmentOpen = true;
 				if (ImGui::MenuItem(ICON_FA_COGS" Renderer settings"))
@@ -467,6 +476,73 @@ namespace Syndra {
 		ImGui::End();
 	}
 
+	void EditorLayer::ShowGPUProfiler()
+	{
+		auto& profiler = SceneRenderer::GetGPUProfiler();
+		ImGui::Begin(ICON_FA_STOPWATCH" GPU profiler", &m_ProfilerOpen);
+		bool enabled = profiler->IsEnabled();
+		if (ImGui::Checkbox("Enabled", &enabled))
+			profiler->SetEnabled(enabled);
+		ImGui::SameLine();
+		if (ImGui::Button("Reset"))
+			profiler->Reset();
+		ImGui::SameLine();
+		if (ImGui::Button("Export CSV")) {
+			std::optional<std::string> filepath = FileDialogs::SaveFile("CSV (*.csv)\0*.csv\0");
+			if (filepath)
+				profiler->ExportCSV(*filepath);
+		}
+		ImGui::Separator();
+
+		//Milliseconds over the last GPUProfiler::WindowSize frames
+		auto& frame = profiler->GetFrameStats();
+		auto stats = profiler->GetStats();
+		stats.push_back(frame);
+		ImGui::Columns(4);
+		ImGui::Text("Pass");
+		ImGui::NextColumn();
+		ImGui::Text("Average");
+		ImGui::NextColumn();
+		ImGui::Text("Min");
+		ImGui::NextColumn();
+		ImGui::Text("Max");
+		ImGui::NextColumn();
+		ImGui::Separator();
+		for (auto& pass : stats)
+		{
+			ImGui::Text("%s", pass.Name.c_str());
+			ImGui::NextColumn();
+			ImGui::Text("%.3f", pass.Average);
+			ImGui::NextColumn();
+			ImGui::Text("%.3f", pass.Min);
+			ImGui::NextColumn();
+			ImGui::Text("%.3f", pass.Max);
+			ImGui::NextColumn();
+		}
+		ImGui::Columns(1);
+		ImGui::Separator();
+		ImGui::Text("Frames dropped while waiting on results: %d", profiler->GetDroppedFrames());
+
+#if SN_PROFILE
+		//Scoped CPU timings, open the file in chrome://tracing or ui.perfetto.dev
+		ImGui::Separator();
+		if (!Instrumentor::IsSessionActive()) {
+			if (ImGui::Button("Record CPU trace")) {
+				std::optional<std::string> filepath = FileDialogs::SaveFile("Chrome trace (*.json)\0*.json\0");
+				if (filepath)
+					SN_PROFILE_BEGIN_SESSION("Editor", *filepath);
+			}
+		}
+		else {
+			if (ImGui::Button("Stop CPU trace"))
+				SN_PROFILE_END_SESSION();
+			ImGui::SameLine();
+			ImGui::Text("Recording");
+		}
+#endif
+		ImGui::End();
+	}
+
 	// Load the default syndra scene when starting the engine
 	void EditorLayer::OnLoadEditor()
 	{
@@ -487,6 +563,7 @@ namespace Syndra {
 	void EditorLayer::ResetLayout()
 	{
 		m_InfoOpen = true;
+		m_ProfilerOpen = true;
 		m_ViewportOpen = true;
 		m_CameraSettingOpen = false;
 		m_SceneHierarchyOpen = true;
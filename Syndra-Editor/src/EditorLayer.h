@@ -26,6 +26,7 @@ namespace Syndra {
 		void ShowGizmos();
 		void ShowCameraSettings();
 		void ShowRendererInfo();
+		void ShowGPUProfiler();
 
 		void OnLoadEditor();
 		void ResetLayout();
@@ -59,6 +60,7 @@ namespace Syndra {
 
 		//Showing and controlling tabs
 		bool m_InfoOpen = true;
+		bool m_ProfilerOpen = true;
 		bool m_ViewportOpen = true;
 		bool m_CameraSettingOpen = false;
 		bool m_SceneHierarchyOpen = true;
@@ -20,7 +20,7 @@ namespace Syndra {
 
 	};
 
-	Application* CreateApplication() {
+	Application* CreateApplication(ApplicationCommandLineArgs args) {
 		return new SyndraEditorApp();
 	}
 
@@ -135,9 +135,19 @@ namespace Syndra {
 				UI::DragFloat("Outer Cutoff", &oCut, 0.5f, p->GetOuterCutOff() + 0.01f, 180);
 
 				p->SetCutOff(iCut, oCut);
+
+				float range = p->GetRange();
+				UI::DragFloat("Range", &range);
+				p->SetRange(range);
 				p = nullptr;
 			}
 
+			if (component.type != LightType::Directional) {
+				bool castShadows = component.light->GetCastShadows();
+				if (ImGui::Checkbox("Cast Shadows", &castShadows))
+					component.light->SetCastShadows(castShadows);
+			}
+
 			ImGui::TreePop();
 		}
 		if (LightRemoved) {
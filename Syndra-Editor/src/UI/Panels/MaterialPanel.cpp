@@ -65,7 +65,7 @@ namespace Syndra {
 					auto path = FileDialogs::OpenFile("Syndra Texture (*.*)\0*.*\0");
 					if (path) {
 						//Add texture as sRGB color space if it is binded to 0 (diffuse texture binding)
-						materialTextures[sampler.binding] = Texture2D::Create(*path);
+						materialTextures[sampler.binding] = AssetManager::LoadTexture(*path);
 					}
 				}
 
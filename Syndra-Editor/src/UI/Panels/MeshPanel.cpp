@@ -39,10 +39,11 @@ namespace Syndra {
 						filePath = *path;
 					}
 					tag = filePath;
-					entity.GetComponent<MeshComponent>().model = Model(*path);
+					entity.GetComponent<MeshComponent>().model = AssetManager::LoadModel(*path);
 				}
 			}
 			ImGui::PopStyleVar();
+			ImGui::Checkbox("Static", &entity.GetComponent<MeshComponent>().isStatic);
 			ImGui::TreePop();
 		}
 		if (MeshRemoved) {
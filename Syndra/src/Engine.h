@@ -11,6 +11,8 @@
 
 #include "Engine/Core/Layer.h"
 
+#include "Engine/Debug/Instrumentor.h"
+
 #include "Engine/Scene/Scene.h"
 #include "Engine/Scene/Entity.h"
 #include "Engine/Scene/Components.h"
@@ -23,4 +25,5 @@
 #include "Engine/Renderer/Texture.h"
 #include "Engine/Renderer/PerspectiveCamera.h"
 #include "Engine/Renderer/OrthographicCamera.h"
-#include "Engine/Renderer/Model.h"
\ No newline at end of file
+#include "Engine/Renderer/Model.h"
+#include "Engine/Renderer/AssetManager.h"
\ No newline at end of file
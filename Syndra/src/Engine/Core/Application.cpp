@@ -1,26 +1,30 @@
 #include "lpch.h"
 #include "Engine/Core/Application.h"
 #include "Engine/Core/Input.h"
-#include "GLFW/glfw3.h"
+
+#include <chrono>
 
 
 namespace Syndra {
 
 	Application* Application::s_Instance = nullptr;
 
-	Application::Application(const std::string& name)
+	Application::Application(const std::string& name, bool headless)
+		:m_Headless(headless)
 	{
 		s_Instance = this;
-		m_window = Window::Create(WindowProps(name));
+		m_window = Window::Create(WindowProps(name, 1600, 900, headless));
 		m_window->SetEventCallback(SN_BIND_EVENT_FN(Application::OnEvent));
-		m_ImGuiLayer = new ImGuiLayer();
-		PushOverlay(m_ImGuiLayer);
-
+		if (!headless) {
+			m_ImGuiLayer = new ImGuiLayer();
+			PushOverlay(m_ImGuiLayer);
+		}
 	}
 
 	Application::~Application()
 	{
-
+		//A trace still recording when the editor closes is written out
+		SN_PROFILE_END_SESSION();
 	}
 
 	void Application::OnEvent(Event& e)
@@ -39,23 +43,32 @@ namespace Syndra {
 
 	void Application::Run()
 	{
+		//Steady clock instead of glfwGetTime, headless runs never initialize GLFW
+		auto start = std::chrono::steady_clock::now();
 		while (m_Running)
 		{
-			float time = (float)glfwGetTime();
+			SN_PROFILE_SCOPE("Frame");
+			float time = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
 			Timestep ts = time - m_lastFrameTime;
 			m_lastFrameTime = time;
 
 			if (!m_Minimized) {
-				for (Layer* layer : m_LayerStack) {
-					layer->OnUpdate(ts);
+				{
+					SN_PROFILE_SCOPE("LayerStack OnUpdate");
+					for (Layer* layer : m_LayerStack) {
+						layer->OnUpdate(ts);
+					}
 				}
 
-				m_ImGuiLayer->Begin();
-				for (Layer* Layer : m_LayerStack)
-				{
-					Layer->OnImGuiRender();
+				if (m_ImGuiLayer) {
+					SN_PROFILE_SCOPE("LayerStack OnImGuiRender");
+					m_ImGuiLayer->Begin();
+					for (Layer* Layer : m_LayerStack)
+					{
+						Layer->OnImGuiRender();
+					}
+					m_ImGuiLayer->End();
 				}
-				m_ImGuiLayer->End();
 			}
 
 			m_window->OnUpdate();
@@ -10,10 +10,23 @@
 
 namespace Syndra {
 
+	struct ApplicationCommandLineArgs
+	{
+		int Count = 0;
+		char** Args = nullptr;
+
+		const char* operator[](int index) const
+		{
+			SN_CORE_ASSERT(index < Count, "Command line argument index out of range");
+			return Args[index];
+		}
+	};
+
 	class Application
 	{
 	public:
-		Application(const std::string& name = "");
+		//Headless applications draw offscreen and have no ImGui layer
+		Application(const std::string& name = "", bool headless = false);
 		virtual ~Application();
 		void OnEvent(Event& e);
 		void Run();
@@ -24,6 +37,7 @@ namespace Syndra {
 		static Application& Get() { return *s_Instance; }
 		Window& GetWindow() { return *m_window; }
 		ImGuiLayer* GetImGuiLayer() const { return m_ImGuiLayer; }
+		bool IsHeadless() const { return m_Headless; }
 
 		void Close();
 
@@ -33,15 +47,16 @@ namespace Syndra {
 
 	private:
 		Ref<Window> m_window;
-		ImGuiLayer* m_ImGuiLayer;
+		ImGuiLayer* m_ImGuiLayer = nullptr;
 		float m_lastFrameTime = 0.0f;
-		bool m_Running;
+		bool m_Running = true;
+		bool m_Headless = false;
 		bool m_Minimized = false;
 		static Application* s_Instance;
 		LayerStack m_LayerStack;
 	};
 
-	Application* CreateApplication();
+	Application* CreateApplication(ApplicationCommandLineArgs args);
 }
 
 
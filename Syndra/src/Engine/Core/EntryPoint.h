@@ -2,21 +2,23 @@
 #include "Application.h"
 
 
-#ifdef SN_PLATFORM_WINDOWS
+#if defined(SN_PLATFORM_WINDOWS) || defined(SN_PLATFORM_LINUX)
 
-extern Syndra::Application* Syndra::CreateApplication();
+extern Syndra::Application* Syndra::CreateApplication(Syndra::ApplicationCommandLineArgs args);
+#ifdef SN_PLATFORM_WINDOWS
 extern "C" {
 	__declspec(dllexport) uint32_t NvOptimusEnablement = 0x00000001;
 }
+#endif
 
 int main(int argc, char** argv) 
 {
 	Syndra::Log::init();
 	SN_WARN("HELLO! Welcome to Syndra!");
 
-	auto app = Syndra::CreateApplication();
+	auto app = Syndra::CreateApplication({ argc, argv });
 	app->Run();
 	delete app;
 }
 
-#endif // SN_PLATFORM_WINDOWS
+#endif // SN_PLATFORM_WINDOWS || SN_PLATFORM_LINUX
@@ -1,7 +1,8 @@
 #include "lpch.h"
 #include "Engine/Core/Window.h"
 
-#ifdef SN_PLATFORM_WINDOWS
+#include "Platform/Headless/HeadlessWindow.h"
+#if defined(SN_PLATFORM_WINDOWS) || defined(SN_PLATFORM_LINUX)
 #include "Platform/Windows/WindowsWindow.h"
 #endif
 
@@ -9,7 +10,10 @@ namespace Syndra
 {
 	Scope<Window> Window::Create(const WindowProps& props)
 	{
-#ifdef SN_PLATFORM_WINDOWS
+		if (props.Headless)
+			return CreateScope<HeadlessWindow>(props);
+#if defined(SN_PLATFORM_WINDOWS) || defined(SN_PLATFORM_LINUX)
+		//The GLFW window works on Linux as well
 		return CreateScope<WindowsWindow>(props);
 #else
 		//SN_CORE_ASSERT(false, "Unknown platform!");
@@ -17,4 +21,4 @@ namespace Syndra
 #endif
 	}
 
-}
\ No newline at end of file
+}
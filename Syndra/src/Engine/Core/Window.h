@@ -12,11 +12,14 @@ namespace Syndra {
 		std::string Title;
 		uint32_t Width;
 		uint32_t Height;
+		//Only creates an offscreen context, for batch runs without a display
+		bool Headless;
 
 		WindowProps(const std::string& title = "Syndra Engine",
 			uint32_t width = 1600,
-			uint32_t height = 900)
-			: Title(title), Width(width), Height(height)
+			uint32_t height = 900,
+			bool headless = false)
+			: Title(title), Width(width), Height(height), Headless(headless)
 		{
 		}
 	};
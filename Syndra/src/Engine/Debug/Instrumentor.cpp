@@ -0,0 +1,149 @@
+#include "lpch.h"
+#include "Engine/Debug/Instrumentor.h"
+
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+namespace Syndra {
+
+	static constexpr uint32_t EventsPerChunk = 16384;
+
+	//Filled by its thread only. Count is published after the event is written so the reader never sees half an event.
+	struct EventChunk
+	{
+		ProfileEvent Events[EventsPerChunk];
+		std::atomic<uint32_t> Count{ 0 };
+		std::atomic<EventChunk*> Next{ nullptr };
+	};
+
+	struct ThreadBuffer
+	{
+		uint32_t ThreadID = 0;
+		//Session the buffer was last written in, a new session makes the thread start over from the first chunk
+		std::atomic<uint32_t> Session{ 0 };
+		EventChunk* Current = nullptr;
+		std::unique_ptr<EventChunk> First;
+		std::vector<std::unique_ptr<EventChunk>> Chunks;
+	};
+
+	struct InstrumentorData
+	{
+		//Only taken when a thread records for the first time and when a session begins or ends
+		std::mutex mutex;
+		std::vector<std::unique_ptr<ThreadBuffer>> threads;
+		std::atomic<uint32_t> session{ 0 };
+		std::string name;
+		std::string filepath;
+	};
+
+	static InstrumentorData s_Instrumentor;
+	std::atomic<bool> Instrumentor::s_Active{ false };
+
+	static ThreadBuffer& GetThreadBuffer()
+	{
+		thread_local ThreadBuffer* buffer = nullptr;
+		if (!buffer) {
+			auto created = std::make_unique<ThreadBuffer>();
+			created->First = std::make_unique<EventChunk>();
+			created->Current = created->First.get();
+			std::lock_guard<std::mutex> lock(s_Instrumentor.mutex);
+			created->ThreadID = (uint32_t)s_Instrumentor.threads.size();
+			buffer = created.get();
+			s_Instrumentor.threads.push_back(std::move(created));
+		}
+		return *buffer;
+	}
+
+	void Instrumentor::BeginSession(const std::string& name, const std::string& filepath)
+	{
+		if (IsSessionActive())
+			EndSession();
+		{
+			std::lock_guard<std::mutex> lock(s_Instrumentor.mutex);
+			s_Instrumentor.name = name;
+			s_Instrumentor.filepath = filepath;
+		}
+		s_Instrumentor.session.fetch_add(1, std::memory_order_release);
+		s_Active.store(true, std::memory_order_release);
+		SN_CORE_INFO("Profiling session '{0}' started", name);
+	}
+
+	void Instrumentor::Record(const char* name, int64_t start, int64_t end)
+	{
+		auto& buffer = GetThreadBuffer();
+		uint32_t session = s_Instrumentor.session.load(std::memory_order_acquire);
+		if (buffer.Session.load(std::memory_order_relaxed) != session) {
+			//Chunks of the last session are reused from the start
+			for (EventChunk* chunk = buffer.First.get(); chunk; chunk = chunk->Next.load(std::memory_order_relaxed))
+				chunk->Count.store(0, std::memory_order_relaxed);
+			buffer.Current = buffer.First.get();
+			buffer.Session.store(session, std::memory_order_release);
+		}
+
+		EventChunk* chunk = buffer.Current;
+		uint32_t count = chunk->Count.load(std::memory_order_relaxed);
+		if (count == EventsPerChunk) {
+			EventChunk* next = chunk->Next.load(std::memory_order_relaxed);
+			if (!next) {
+				buffer.Chunks.push_back(std::make_unique<EventChunk>());
+				next = buffer.Chunks.back().get();
+				chunk->Next.store(next, std::memory_order_release);
+			}
+			chunk = buffer.Current = next;
+			count = 0;
+		}
+		chunk->Events[count] = { name, start, end - start };
+		chunk->Count.store(count + 1, std::memory_order_release);
+	}
+
+	//Chrome expects plain JSON strings, function signatures may contain quotes or backslashes
+	static void WriteEscaped(std::ofstream& out, const char* text)
+	{
+		for (; *text; text++)
+		{
+			if (*text == '"' || *text == '\\')
+				out << '\\';
+			out << *text;
+		}
+	}
+
+	void Instrumentor::EndSession()
+	{
+		if (!s_Active.exchange(false, std::memory_order_acq_rel))
+			return;
+
+		std::lock_guard<std::mutex> lock(s_Instrumentor.mutex);
+		std::ofstream out(s_Instrumentor.filepath);
+		if (!out) {
+			SN_CORE_ERROR("Could not write the profiling session to {0}", s_Instrumentor.filepath);
+			return;
+		}
+
+		uint32_t session = s_Instrumentor.session.load(std::memory_order_acquire);
+		size_t written = 0;
+		out << "{\"otherData\": {},\"traceEvents\":[";
+		for (auto& buffer : s_Instrumentor.threads)
+		{
+			//Threads that recorded nothing in this session still hold the last one
+			if (buffer->Session.load(std::memory_order_acquire) != session)
+				continue;
+			for (EventChunk* chunk = buffer->First.get(); chunk; chunk = chunk->Next.load(std::memory_order_acquire))
+			{
+				uint32_t count = chunk->Count.load(std::memory_order_acquire);
+				for (uint32_t i = 0; i < count; i++)
+				{
+					auto& event = chunk->Events[i];
+					out << (written++ ? "," : "") << "{\"cat\":\"function\",\"dur\":" << event.Duration << ",\"name\":\"";
+					WriteEscaped(out, event.Name);
+					out << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer->ThreadID << ",\"ts\":" << event.Start << "}";
+				}
+				if (count < EventsPerChunk)
+					break;
+			}
+		}
+		out << "]}";
+		SN_CORE_INFO("Profiling session '{0}' written to {1} ({2} events)", s_Instrumentor.name, s_Instrumentor.filepath, written);
+	}
+
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+namespace Syndra {
+
+	//Scope timed on the CPU, the name is not copied and has to outlive the session
+	struct ProfileEvent
+	{
+		const char* Name;
+		//Microseconds on the steady clock
+		int64_t Start;
+		int64_t Duration;
+	};
+
+	//Records scoped CPU timings into per thread buffers and writes them as Chrome trace_event JSON
+	//(chrome://tracing or ui.perfetto.dev). A thread only ever writes its own buffer so recording takes
+	//no lock, the buffers are read when the session ends. Events still being written at that moment are dropped.
+	class Instrumentor
+	{
+	public:
+		static void BeginSession(const std::string& name, const std::string& filepath);
+		static void EndSession();
+		static bool IsSessionActive() { return s_Active.load(std::memory_order_relaxed); }
+
+		static void Record(const char* name, int64_t start, int64_t end);
+
+		static int64_t Now()
+		{
+			return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+
+	private:
+		static std::atomic<bool> s_Active;
+	};
+
+	class InstrumentationTimer
+	{
+	public:
+		InstrumentationTimer(const char* name)
+			:m_Name(name), m_Start(Instrumentor::IsSessionActive() ? Instrumentor::Now() : -1) {}
+
+		~InstrumentationTimer()
+		{
+			if (m_Start >= 0 && Instrumentor::IsSessionActive())
+				Instrumentor::Record(m_Name, m_Start, Instrumentor::Now());
+		}
+
+		InstrumentationTimer(const InstrumentationTimer&) = delete;
+		InstrumentationTimer& operator=(const InstrumentationTimer&) = delete;
+
+	private:
+		const char* m_Name;
+		int64_t m_Start;
+	};
+
+}
+
+//Dist builds leave no trace of the profiler
+#ifndef SN_DIST
+#define SN_PROFILE 1
+#else
+#define SN_PROFILE 0
+#endif
+
+#if SN_PROFILE
+#if defined(__GNUC__) || (defined(__ICC) && (__ICC >= 600))
+#define SN_FUNC_SIG __PRETTY_FUNCTION__
+#elif defined(_MSC_VER)
+#define SN_FUNC_SIG __FUNCSIG__
+#else
+#define SN_FUNC_SIG __func__
+#endif
+
+#define SN_PROFILE_CONCAT_INNER(a, b) a##b
+#define SN_PROFILE_CONCAT(a, b) SN_PROFILE_CONCAT_INNER(a, b)
+#define SN_PROFILE_BEGIN_SESSION(name, filepath) ::Syndra::Instrumentor::BeginSession(name, filepath)
+#define SN_PROFILE_END_SESSION() ::Syndra::Instrumentor::EndSession()
+#define SN_PROFILE_SCOPE(name) ::Syndra::InstrumentationTimer SN_PROFILE_CONCAT(timer, __LINE__)(name)
+#define SN_PROFILE_FUNCTION() SN_PROFILE_SCOPE(SN_FUNC_SIG)
+#else
+#define SN_PROFILE_BEGIN_SESSION(name, filepath)
+#define SN_PROFILE_END_SESSION()
+#define SN_PROFILE_SCOPE(name)
+#define SN_PROFILE_FUNCTION()
+#endif
@@ -0,0 +1,75 @@
+#include "lpch.h"
+#include "Engine/Renderer/AssetManager.h"
+#include "Engine/Utils/Hash.h"
+
+namespace Syndra {
+
+	struct AssetManagerData
+	{
+		std::unordered_map<uint64_t, std::weak_ptr<Model>> models;
+		std::unordered_map<uint64_t, std::weak_ptr<Texture2D>> textures;
+	};
+
+	static AssetManagerData s_Data;
+
+	uint64_t AssetManager::GetFileKey(const std::string& path)
+	{
+		std::error_code error;
+		auto canonicalPath = std::filesystem::weakly_canonical(path, error).string();
+		auto writeTime = std::filesystem::last_write_time(path, error);
+		if (error)
+			return 0;
+		auto size = std::filesystem::file_size(path, error);
+		if (error)
+			return 0;
+
+		uint64_t key = Hash::FNV1a(canonicalPath.data(), canonicalPath.size());
+		key = Hash::Combine(key, writeTime.time_since_epoch().count());
+		return Hash::Combine(key, size);
+	}
+
+	//Returns the live asset of the key, or loads a new one and drops the entries of freed assets
+	template<typename T, typename Load>
+	static Ref<T> GetOrLoad(std::unordered_map<uint64_t, std::weak_ptr<T>>& assets, uint64_t key, Load load)
+	{
+		if (key == 0)
+			return load();
+
+		auto it = assets.find(key);
+		if (it != assets.end())
+		{
+			if (auto asset = it->second.lock())
+				return asset;
+		}
+
+		for (auto expired = assets.begin(); expired != assets.end();)
+		{
+			if (expired->second.expired())
+				expired = assets.erase(expired);
+			else
+				++expired;
+		}
+
+		Ref<T> asset = load();
+		assets[key] = asset;
+		return asset;
+	}
+
+	Ref<Model> AssetManager::LoadModel(const std::string& path)
+	{
+		SN_PROFILE_FUNCTION();
+		uint64_t key = GetFileKey(path);
+		return GetOrLoad(s_Data.models, key, [&]() { return CreateRef<Model>(path); });
+	}
+
+	Ref<Texture2D> AssetManager::LoadTexture(const std::string& path, bool sRGB)
+	{
+		SN_PROFILE_FUNCTION();
+		//The same image is a different texture in sRGB
+		uint64_t key = GetFileKey(path);
+		if (key != 0 && sRGB)
+			key = ~key;
+		return GetOrLoad(s_Data.textures, key, [&]() { return Texture2D::Create(path, sRGB); });
+	}
+
+}
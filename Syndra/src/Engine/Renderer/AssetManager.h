@@ -0,0 +1,21 @@
+#pragma once
+#include "Engine/Renderer/Model.h"
+#include "Engine/Renderer/Texture.h"
+
+namespace Syndra {
+
+	//Hands out shared models and textures. Every path leading to the same file shares one asset until the file
+	//is written again, and an asset is freed when the last handle to it goes. Loads happen on the main thread.
+	//Only the file's metadata is read, a model with a mesh cache is still opened with just a mapping.
+	class AssetManager
+	{
+	public:
+		static Ref<Model> LoadModel(const std::string& path);
+		static Ref<Texture2D> LoadTexture(const std::string& path, bool sRGB = false);
+
+	private:
+		//Hash of the canonical path, write time and size of the file. Zero when it does not exist.
+		static uint64_t GetFileKey(const std::string& path);
+	};
+
+}
@@ -1,202 +1,318 @@
 #include "lpch.h"
 #include "Engine/Renderer/Environment.h"
+#include "Engine/Utils/Hash.h"
 #include "glad/glad.h"
+#include "stb_image.h"
+
+#include <chrono>
+#include <thread>
 
 namespace Syndra {
 
-	Environment::Environment(const Ref<Texture2D>& hdri)
-		:m_HDRSkyMap(hdri)
+	//The bake shaders run 8x8 work groups, one layer per cube face
+	static void DispatchBake(uint32_t size, uint32_t layers)
 	{
-		m_EquirectangularToCube = Shader::Create("assets/shaders/EquirectangularToCube.glsl");
-		m_BackgroundShader = Shader::Create("assets/shaders/BackgroundSky.glsl");
-		m_PrefilterShader = Shader::Create("assets/shaders/Prefilter.glsl");
-		m_BRDFLutShader = Shader::Create("assets/shaders/BRDFLut.glsl");
+		uint32_t groups = (size + 7) / 8;
+		glDispatchCompute(groups, groups, layers);
+	}
+
+	static constexpr uint32_t s_BRDFLutSize = 512;
+
+	template<typename T>
+	static bool IsFinished(const std::future<T>& future)
+	{
+		return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+	}
+
+	//Runs on the loading thread, touches no GL state
+	static EnvironmentSource LoadSource(const std::string& path, const EnvironmentBakeSettings& settings)
+	{
+		SN_PROFILE_FUNCTION();
+		EnvironmentSource source;
+		source.Key = EnvironmentCache::GetKey(Hash::HashFile(path), settings);
+		source.Cached = EnvironmentCache::Read(source.Key, settings, source.Cache);
+		if (source.Cached)
+			return source;
+
+		SN_PROFILE_SCOPE("Decode HDR");
+		int channels;
+		stbi_set_flip_vertically_on_load_thread(1);
+		float* pixels = stbi_loadf(path.c_str(), &source.Width, &source.Height, &channels, 3);
+		if (pixels) {
+			auto bytes = (const uint8_t*)pixels;
+			source.Pixels.assign(bytes, bytes + (size_t)source.Width * source.Height * 3 * sizeof(float));
+			stbi_image_free(pixels);
+		}
+		return source;
+	}
 
+	Environment::Environment(const std::string& path)
+		:m_Path(path)
+	{
+		SN_PROFILE_FUNCTION();
+		m_BackgroundShader = Shader::Create("assets/shaders/BackgroundSky.glsl");
 		m_BackgroundShader->Bind();
 		m_BackgroundShader->SetFloat("push.intensity", 0.5f);
 		m_BackgroundShader->Unbind();
-		m_IrradianceConvShader = Shader::Create("assets/shaders/IrradianceConvolution.glsl");
 		SetupCube();
-		//SetupFrameBuffer();
-		glm::mat4 captureProjection = glm::perspective(glm::radians(90.0f), 1.0f, 0.1f, 10.0f);
-		glm::mat4 captureViews[] =
-		{
-			glm::lookAt(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(1.0f,  0.0f,  0.0f), glm::vec3(0.0f, -1.0f,  0.0f)),
-			glm::lookAt(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(-1.0f, 0.0f,  0.0f), glm::vec3(0.0f, -1.0f,  0.0f)),
-			glm::lookAt(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f,  1.0f,  0.0f), glm::vec3(0.0f,  0.0f,  1.0f)),
-			glm::lookAt(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, -1.0f,  0.0f), glm::vec3(0.0f,  0.0f, -1.0f)),
-			glm::lookAt(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f,  0.0f,  1.0f), glm::vec3(0.0f, -1.0f,  0.0f)),
-			glm::lookAt(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f,  0.0f, -1.0f), glm::vec3(0.0f, -1.0f,  0.0f))
-		};
 
-		m_QuadVAO = VertexArray::Create();
-		float quad[] = {
-			 1.0f,  1.0f, 0.0f,    1.0f, 1.0f,   // top right
-			 1.0f, -1.0f, 0.0f,    1.0f, 0.0f,   // bottom right
-			-1.0f, -1.0f, 0.0f,    0.0f, 0.0f,   // bottom left
-			-1.0f,  1.0f, 0.0f,    0.0f, 1.0f    // top left 
-		};
-		Ref<VertexBuffer> quadVBO = VertexBuffer::Create(quad, sizeof(quad));
-		BufferLayout quadLayout = {
-			{ShaderDataType::Float3,"a_pos"},
-			{ShaderDataType::Float2,"a_uv"},
-		};
-		quadVBO->SetLayout(quadLayout);
-		m_QuadVAO->AddVertexBuffer(quadVBO);
-		unsigned int quadIndices[] = {
-			0, 3, 1, // first triangle
-			1, 3, 2  // second triangle
-		};
-		Ref<IndexBuffer> quadEBO = IndexBuffer::Create(quadIndices, sizeof(quadIndices) / sizeof(uint32_t));
-		m_QuadVAO->SetIndexBuffer(quadEBO);
-		
-		//m_CaptureFBO->Bind();
+		m_Source = std::async(std::launch::async, LoadSource, path, m_Settings);
+		m_Steps.push_back([this]() { return ReceiveSource(); });
+	}
 
-		unsigned int captureFBO;
-		unsigned int captureRBO;
-		glGenFramebuffers(1, &captureFBO);
-		glGenRenderbuffers(1, &captureRBO);
+	Environment::~Environment()
+	{
+		//Workers write into buffers owned by the environment
+		if (m_Source.valid())
+			m_Source.wait();
+		if (m_Copy.valid())
+			m_Copy.wait();
+		if (m_Fence)
+			glDeleteSync((GLsync)m_Fence);
+		ReleasePixelBuffer();
+		//The BRDF LUT is shared by every environment
+		uint32_t textures[] = { m_Textures.Cubemap, m_Textures.Prefilter, m_Textures.Preview, m_HDRTexture };
+		glDeleteTextures(4, textures);
+		RenderCommand::InvalidateState();
+	}
 
-		glBindFramebuffer(GL_FRAMEBUFFER, captureFBO);
-		glBindRenderbuffer(GL_RENDERBUFFER, captureRBO);
-		glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, 2048, 2048);
-		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, captureRBO);
+	bool Environment::IsIdle() const
+	{
+		return (!m_Source.valid() || IsFinished(m_Source)) && (!m_Copy.valid() || IsFinished(m_Copy));
+	}
 
-		glGenTextures(1, &envCubemap);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, envCubemap);
-		for (unsigned int i = 0; i < 6; ++i)
+	void Environment::Update()
+	{
+		if (m_Steps.empty())
+			return;
+
+		SN_PROFILE_FUNCTION();
+		if (m_Steps.front()())
+			m_Steps.pop_front();
+		//Steps bind textures, images and buffers directly
+		RenderCommand::InvalidateState();
+	}
+
+	void Environment::WaitUntilReady()
+	{
+		while (!m_Ready && !m_Steps.empty())
 		{
-			glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB16F, 2048, 2048, 0, GL_RGB, GL_FLOAT, nullptr);
+			if (!m_Steps.front()())
+				std::this_thread::yield();
+			else
+				m_Steps.pop_front();
 		}
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		RenderCommand::InvalidateState();
+	}
 
-		//Converting hdr sky to cube map
-		m_EquirectangularToCube->Bind();
-		m_EquirectangularToCube->SetMat4("cam.projection", captureProjection);
+	void Environment::StagePixelBuffer(std::vector<uint8_t>&& data)
+	{
+		glCreateBuffers(1, &m_PixelBuffer);
+		glNamedBufferStorage(m_PixelBuffer, data.size(), nullptr, GL_MAP_WRITE_BIT);
+		m_PixelBufferData = glMapNamedBufferRange(m_PixelBuffer, 0, data.size(), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+		m_Copy = std::async(std::launch::async, [destination = m_PixelBufferData, data = std::move(data)]() {
+			memcpy(destination, data.data(), data.size());
+		});
+	}
 
-		m_HDRSkyMap->Bind(0);
+	void Environment::ReleasePixelBuffer()
+	{
+		if (!m_PixelBuffer)
+			return;
+		if (m_PixelBufferData)
+			glUnmapNamedBuffer(m_PixelBuffer);
+		//The driver keeps the storage alive until pending copies from it are done
+		glDeleteBuffers(1, &m_PixelBuffer);
+		m_PixelBuffer = 0;
+		m_PixelBufferData = nullptr;
+	}
 
-		glViewport(0, 0, 2048, 2048); // don't forget to configure the viewport to the capture dimensions.
-		glBindFramebuffer(GL_FRAMEBUFFER, captureFBO);
-		for (unsigned int i = 0; i < 6; ++i)
-		{
-			m_EquirectangularToCube->SetMat4("cam.view", captureViews[i]);
-			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, envCubemap, 0);
-			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-			RenderCube();
+	bool Environment::ReceiveSource()
+	{
+		if (!IsFinished(m_Source))
+			return false;
+
+		EnvironmentSource source = m_Source.get();
+		m_Key = source.Key;
+		if (source.Cached) {
+			SN_CORE_INFO("Loading the environment bake of {0} from the cache", m_Path);
+			m_Irradiance = source.Cache.Irradiance;
+			StagePixelBuffer(std::move(source.Cache.Texels));
+			m_Steps.push_back([this]() { return UploadCache(); });
+			return true;
+		}
+		if (source.Pixels.empty()) {
+			//No further steps, the environment never becomes ready
+			SN_CORE_ERROR("Could not load the environment {0}", m_Path);
+			return true;
 		}
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
-		m_EquirectangularToCube->Unbind();
-		//m_CaptureFBO->Unbind();
+		m_HDRWidth = source.Width;
+		m_HDRHeight = source.Height;
+		StagePixelBuffer(std::move(source.Pixels));
+		m_Steps.push_back([this]() { return UploadHDR(); });
+		m_Steps.push_back([this]() { return ConvertToCube(); });
+		m_Steps.push_back([this]() { return ProjectIrradiance(); });
+		for (uint32_t mip = 0; mip < m_Settings.PrefilterMips; mip++)
+			m_Steps.push_back([this, mip]() { return Prefilter(mip); });
+		m_Steps.push_back([this]() { return Finish(); });
+		m_Steps.push_back([this]() { return WriteCache(); });
+		return true;
+	}
 
-		glBindTexture(GL_TEXTURE_CUBE_MAP, envCubemap);
-		glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
+	bool Environment::UploadCache()
+	{
+		if (!IsFinished(m_Copy))
+			return false;
+
+		SN_PROFILE_FUNCTION();
+		m_Textures = EnvironmentCache::CreateTextures(m_Settings);
+		glUnmapNamedBuffer(m_PixelBuffer);
+		m_PixelBufferData = nullptr;
+		EnvironmentCache::UploadImages(EnvironmentCache::GetImages(m_Settings, m_Textures), m_PixelBuffer);
+		ReleasePixelBuffer();
+		//The background samples the cube with mipmaps, they are cheaper to rebuild than to store
+		glGenerateTextureMipmap(m_Textures.Cubemap);
+		return Finish();
+	}
 
-		// ------------------------------- Irradiance cube map Convolution-----------------------------------------//
+	bool Environment::UploadHDR()
+	{
+		if (!IsFinished(m_Copy))
+			return false;
+
+		SN_PROFILE_FUNCTION();
+		m_HDRTexture = EnvironmentCache::CreateTexture2D(m_HDRWidth, m_HDRHeight, GL_RGB16F);
+		glUnmapNamedBuffer(m_PixelBuffer);
+		m_PixelBufferData = nullptr;
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_PixelBuffer);
+		glTextureSubImage2D(m_HDRTexture, 0, 0, 0, m_HDRWidth, m_HDRHeight, GL_RGB, GL_FLOAT, nullptr);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		ReleasePixelBuffer();
+		return true;
+	}
 
-		glGenTextures(1, &irradianceMap);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, irradianceMap);
-		for (unsigned int i = 0; i < 6; ++i)
-		{
-			glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB16F, 32, 32, 0, GL_RGB, GL_FLOAT, nullptr);
-		}
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-		glBindFramebuffer(GL_FRAMEBUFFER, captureFBO);
-		glBindRenderbuffer(GL_RENDERBUFFER, captureRBO);
-		glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, 32, 32);
-
-		m_IrradianceConvShader->Bind();
-		m_IrradianceConvShader->SetMat4("cam.projection", captureProjection);
-		Texture2D::BindTexture(envCubemap, 0);
-
-		glViewport(0, 0, 32, 32); // don't forget to configure the viewport to the capture dimensions.
-		glBindFramebuffer(GL_FRAMEBUFFER, captureFBO);
-		for (unsigned int i = 0; i < 6; ++i)
-		{
-			m_IrradianceConvShader->SetMat4("cam.view", captureViews[i]);
-			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, irradianceMap, 0);
-			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	bool Environment::ConvertToCube()
+	{
+		SN_PROFILE_FUNCTION();
+		auto equirectangularToCube = Shader::Create("assets/shaders/EquirectangularToCube.glsl");
+		m_Textures = EnvironmentCache::CreateTextures(m_Settings);
+
+		//Converting hdr sky to cube map, the compute shaders write every face of a level in one dispatch
+		equirectangularToCube->Bind();
+		Texture2D::BindTexture(m_HDRTexture, 0);
+		glBindImageTexture(1, m_Textures.Cubemap, 0, GL_TRUE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+		DispatchBake(m_Settings.CubeSize, 6);
+		glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_TEXTURE_UPDATE_BARRIER_BIT);
+		glBindImageTexture(1, 0, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+
+		//The prefilter reads the mips of the source
+		glGenerateTextureMipmap(m_Textures.Cubemap);
+		return true;
+	}
 
-			RenderCube();
-		}
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	bool Environment::ProjectIrradiance()
+	{
+		// ------------------------------- Irradiance as L2 spherical harmonics -----------------------------------------//
+		uint32_t shLevel = (uint32_t)std::log2(m_Settings.CubeSize / m_Settings.SHSourceSize);
+		m_Irradiance = SphericalHarmonics::ProjectCubemap(m_Textures.Cubemap, shLevel, m_Settings.SHSourceSize);
+		//Compiled here so the first prefilter step only dispatches
+		m_PrefilterShader = Shader::Create("assets/shaders/Prefilter.glsl");
+		return true;
+	}
 
-	// pbr: create a pre-filter cube map, and re-scale capture FBO to pre-filter scale.
+	// pbr: pre-filter cube map, one mip level per step
 	// --------------------------------------------------------------------------------
-		glGenTextures(1, &prefilterMap);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, prefilterMap);
-		for (unsigned int i = 0; i < 6; ++i)
-		{
-			glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB16F, 512, 512, 0, GL_RGB, GL_FLOAT, nullptr);
-		}
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR); // be sure to set minification filter to mip_linear 
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-		glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
-
-		// ----------------------------------------------------------------------------------------------------
+	bool Environment::Prefilter(uint32_t mip)
+	{
+		SN_PROFILE_FUNCTION();
 		m_PrefilterShader->Bind();
-		m_PrefilterShader->SetMat4("cam.projection", captureProjection);
-		Texture2D::BindTexture(envCubemap, 0);
+		Texture2D::BindTexture(m_Textures.Cubemap, 0);
+
+		unsigned int mipSize = std::max(m_Settings.PrefilterSize >> mip, 1u);
+		float roughness = (float)mip / (float)(m_Settings.PrefilterMips - 1);
+		m_PrefilterShader->SetFloat("push.roughness", roughness);
+		glBindImageTexture(1, m_Textures.Prefilter, mip, GL_TRUE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+		DispatchBake(mipSize, 6);
+		glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_TEXTURE_UPDATE_BARRIER_BIT);
+		glBindImageTexture(1, 0, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+		return true;
+	}
 
-		glBindFramebuffer(GL_FRAMEBUFFER, captureFBO);
-		unsigned int maxMipLevels = 5;
-		for (unsigned int mip = 0; mip < maxMipLevels; ++mip)
-		{
-			// resize framebuffer according to mip-level size.
-			unsigned int mipWidth = 512 * std::pow(0.5, mip);
-			unsigned int mipHeight = 512 * std::pow(0.5, mip);
-			glBindRenderbuffer(GL_RENDERBUFFER, captureRBO);
-			glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, mipWidth, mipHeight);
-			glViewport(0, 0, mipWidth, mipHeight);
-
-			float roughness = (float)mip / (float)(maxMipLevels - 1);
-			m_PrefilterShader->SetFloat("push.roughness", roughness);
-			for (unsigned int i = 0; i < 6; ++i)
-			{
-				m_PrefilterShader->SetMat4("cam.view", captureViews[i]);
-				glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, prefilterMap, mip);
-
-				glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-				RenderCube();
-			}
+	bool Environment::Finish()
+	{
+		SN_PROFILE_FUNCTION();
+		if (m_HDRTexture) {
+			//Thumbnail for the environment panel, the HDR is released after the bake
+			unsigned int previewFBOs[2];
+			glCreateFramebuffers(2, previewFBOs);
+			glNamedFramebufferTexture(previewFBOs[0], GL_COLOR_ATTACHMENT0, m_HDRTexture, 0);
+			glNamedFramebufferTexture(previewFBOs[1], GL_COLOR_ATTACHMENT0, m_Textures.Preview, 0);
+			glBlitNamedFramebuffer(previewFBOs[0], previewFBOs[1], 0, 0, m_HDRWidth, m_HDRHeight,
+				0, 0, m_Settings.PreviewWidth, m_Settings.PreviewHeight, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+			glDeleteFramebuffers(2, previewFBOs);
+			glDeleteTextures(1, &m_HDRTexture);
+			m_HDRTexture = 0;
+			m_PrefilterShader = nullptr;
+
+			//Read back for the cache without waiting, WriteCache picks the texels up once the GPU is done
+			size_t size = EnvironmentCache::GetTexelDataSize(m_Settings);
+			glCreateBuffers(1, &m_PixelBuffer);
+			glNamedBufferStorage(m_PixelBuffer, size, nullptr, GL_MAP_READ_BIT);
+			EnvironmentCache::ReadImages(EnvironmentCache::GetImages(m_Settings, m_Textures), m_PixelBuffer);
+			m_Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
 		}
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
-		
-		glGenTextures(1, &brdfLUTTexture);
 
-		// pre-allocate enough memory for the LUT texture.
-		glBindTexture(GL_TEXTURE_2D, brdfLUTTexture);
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RG16F, 512, 512, 0, GL_RG, GL_FLOAT, 0);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-		glBindFramebuffer(GL_FRAMEBUFFER, captureFBO);
-		glBindRenderbuffer(GL_RENDERBUFFER, captureRBO);
-		glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, 512, 512);
-		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, brdfLUTTexture, 0);
+		m_IrradianceBuffer = UniformBuffer::Create(sizeof(SHIrradiance), 4);
+		m_IrradianceBuffer->SetData(&m_Irradiance, sizeof(SHIrradiance));
+		brdfLUTTexture = GetBRDFLut();
+		m_Ready = true;
+		return true;
+	}
 
-		glViewport(0, 0, 512, 512);
-		m_BRDFLutShader->Bind();
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-		RenderQuad();
+	bool Environment::WriteCache()
+	{
+		if (!m_PixelBufferData) {
+			if (glClientWaitSync((GLsync)m_Fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+				return false;
+			glDeleteSync((GLsync)m_Fence);
+			m_Fence = nullptr;
+
+			size_t size = EnvironmentCache::GetTexelDataSize(m_Settings);
+			m_PixelBufferData = glMapNamedBufferRange(m_PixelBuffer, 0, size, GL_MAP_READ_BIT);
+			m_Copy = std::async(std::launch::async, [key = m_Key, settings = m_Settings, irradiance = m_Irradiance, texels = m_PixelBufferData, size]() {
+				EnvironmentCache::Write(key, settings, irradiance, texels, size);
+			});
+			return false;
+		}
+		if (!IsFinished(m_Copy))
+			return false;
 
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		ReleasePixelBuffer();
+		return true;
+	}
 
+	uint32_t Environment::GetBRDFLut()
+	{
+		static uint32_t s_BRDFLut = 0;
+		if (s_BRDFLut)
+			return s_BRDFLut;
+		if (EnvironmentCache::LoadBRDFLut(s_BRDFLutSize, s_BRDFLut))
+			return s_BRDFLut;
+
+		SN_PROFILE_FUNCTION();
+		auto brdfLutShader = Shader::Create("assets/shaders/BRDFLut.glsl");
+		s_BRDFLut = EnvironmentCache::CreateTexture2D(s_BRDFLutSize, s_BRDFLutSize, GL_RG16F);
+
+		brdfLutShader->Bind();
+		glBindImageTexture(0, s_BRDFLut, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RG16F);
+		DispatchBake(s_BRDFLutSize, 1);
+		glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_TEXTURE_UPDATE_BARRIER_BIT);
+		glBindImageTexture(0, 0, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RG16F);
+
+		EnvironmentCache::SaveBRDFLut(s_BRDFLutSize, s_BRDFLut);
+		return s_BRDFLut;
 	}
 
 	void Environment::RenderCube()
@@ -205,16 +321,10 @@ namespace Syndra {
 		glDrawArrays(GL_TRIANGLES, 0, 36);
 	}
 
-	void Environment::RenderQuad()
-	{
-		m_QuadVAO->Bind();
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-	}
-
 	void Environment::RenderBackground()
 	{
 		m_BackgroundShader->Bind();
-		Texture2D::BindTexture(envCubemap, 0);
+		Texture2D::BindTexture(m_Textures.Cubemap, 0);
 		//Texture2D::BindTexture(m_IrradianceFBO->GetColorAttachmentRendererID(), 1);
 		m_BackgroundShader->SetMat4("cam.view", m_View);
 		m_BackgroundShader->SetMat4("cam.projection", m_Projection);
@@ -231,17 +341,17 @@ namespace Syndra {
 
 	uint32_t Environment::GetBackgroundTextureID() const
 	{
-		return m_HDRSkyMap->GetRendererID();
+		return m_Textures.Preview;
 	}
 
-	void Environment::BindIrradianceMap(uint32_t slot)
+	void Environment::BindIrradiance(uint32_t binding)
 	{
-		Texture2D::BindTexture(irradianceMap, slot);
+		m_IrradianceBuffer->Bind(binding);
 	}
 
 	void Environment::BindPreFilterMap(uint32_t slot)
 	{
-		Texture2D::BindTexture(prefilterMap, slot);
+		Texture2D::BindTexture(m_Textures.Prefilter, slot);
 	}
 
 	void Environment::BindBRDFMap(uint32_t slot)
@@ -307,20 +417,4 @@ namespace Syndra {
 		m_CubeVAO->AddVertexBuffer(cubeVBO);
 	}
 
-	void Environment::SetupFrameBuffer()
-	{
-		//FramebufferSpecification spec;
-		//spec.Attachments = { FramebufferTextureFormat::Cubemap, FramebufferTextureFormat::Depth };
-		//spec.Width = 2048;
-		//spec.Height = 2048;
-		//spec.Samples = 1;
-		//spec.ClearColor = { 0.0f, 0.0f, 0.0f, 1.0f };
-
-		/*m_CaptureFBO = FrameBuffer::Create(spec);*/
-
-		//spec.Width = 32;
-		//spec.Height = 32;
-		//m_IrradianceFBO = FrameBuffer::Create(spec);
-	}
-
-}
\ No newline at end of file
+}
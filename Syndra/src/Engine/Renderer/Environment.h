@@ -3,45 +3,100 @@
 #include "Engine/Renderer/Renderer.h"
 #include "Engine/Renderer/Texture.h"
 #include "Engine/Renderer/FrameBuffer.h"
+#include "Engine/Renderer/EnvironmentCache.h"
+#include "Engine/Renderer/UniformBuffer.h"
 
+#include <deque>
+#include <future>
 
 namespace Syndra {
 
+	//What the loading thread found for an HDR: its cached bake, or the decoded RGB float pixels
+	struct EnvironmentSource
+	{
+		uint64_t Key = 0;
+		bool Cached = false;
+		EnvironmentCacheData Cache;
+		std::vector<uint8_t> Pixels;
+		int Width = 0, Height = 0;
+	};
+
+	//The HDR is hashed, read from the environment cache or decoded on a worker thread, uploaded through a
+	//pixel buffer and baked one step per Update, so a new environment never stalls the frame. It can be
+	//used once IsReady is true, until then the previous environment keeps rendering.
 	class Environment {
 
 	public:
-		Environment(const Ref<Texture2D>& hdri);
+		Environment(const std::string& path);
+		~Environment();
+
+		//Runs the next loading or baking step, called once per frame
+		void Update();
+		bool IsReady() const { return m_Ready; }
+		//False once the environment is ready or could not be loaded
+		bool IsLoading() const { return !m_Ready && !m_Steps.empty(); }
+		//True when no worker thread uses the environment, destroying it before then waits for the workers
+		bool IsIdle() const;
+		//Runs every step at once, for tools that need the environment before the next frame
+		void WaitUntilReady();
 	
 		void RenderBackground();
-		void SetHDRTexture(const Ref<Texture2D>& hdri) { m_HDRSkyMap = hdri; }
 		void SetViewProjection(const glm::mat4& view, const glm::mat4& projection) { m_View = view; m_Projection = projection; }
 
 		void SetIntensity(float intensity);
 
 		uint32_t GetBackgroundTextureID() const;
-		std::string GetPath() { return m_HDRSkyMap->GetPath(); }
+		std::string GetPath() { return m_Path; }
 
-		void BindIrradianceMap(uint32_t slot);
+		//Binds the SH irradiance uniform block
+		void BindIrradiance(uint32_t binding);
+		const SHIrradiance& GetIrradiance() const { return m_Irradiance; }
 		void BindPreFilterMap(uint32_t slot);
 		void BindBRDFMap(uint32_t slot);
 
 	private:
 		void SetupCube();
-		void SetupFrameBuffer();
+		//Steps return false while they wait for a worker thread or the GPU
+		bool ReceiveSource();
+		bool UploadCache();
+		bool UploadHDR();
+		bool ConvertToCube();
+		bool ProjectIrradiance();
+		bool Prefilter(uint32_t mip);
+		bool Finish();
+		bool WriteCache();
+		//Copies data to a new pixel buffer on a worker thread
+		void StagePixelBuffer(std::vector<uint8_t>&& data);
+		void ReleasePixelBuffer();
+		//Computed once per process and kept in the cache, it does not depend on the HDR
+		static uint32_t GetBRDFLut();
 
 		void RenderCube();
-		void RenderQuad();
 
 	private:
-		unsigned int envCubemap;
-		unsigned int brdfLUTTexture;
-		unsigned int prefilterMap;
-		unsigned int irradianceMap;
-		Ref<Texture2D> m_HDRSkyMap;
-		Ref<Shader> m_EquirectangularToCube, m_BackgroundShader, m_IrradianceConvShader, m_PrefilterShader, m_BRDFLutShader;
-		Ref<VertexArray> m_CubeVAO, m_QuadVAO;
-		Ref<FrameBuffer> m_IrradianceFBO, m_PrefilterFBO;
+		std::string m_Path;
+		EnvironmentBakeSettings m_Settings;
+		std::deque<std::function<bool()>> m_Steps;
+		bool m_Ready = false;
+
+		std::future<EnvironmentSource> m_Source;
+		uint64_t m_Key = 0;
+		int m_HDRWidth = 0, m_HDRHeight = 0;
+		uint32_t m_HDRTexture = 0;
+		//Upload or readback buffer and the worker copying into or out of it
+		uint32_t m_PixelBuffer = 0;
+		void* m_PixelBufferData = nullptr;
+		std::future<void> m_Copy;
+		void* m_Fence = nullptr;
+		Ref<Shader> m_PrefilterShader;
+
+		EnvironmentTextures m_Textures;
+		SHIrradiance m_Irradiance;
+		Ref<UniformBuffer> m_IrradianceBuffer;
+		unsigned int brdfLUTTexture = 0;
+		Ref<Shader> m_BackgroundShader;
+		Ref<VertexArray> m_CubeVAO;
 		glm::mat4 m_View, m_Projection;
 	};
 
-}
\ No newline at end of file
+}
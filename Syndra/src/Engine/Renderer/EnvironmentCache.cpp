@@ -0,0 +1,230 @@
+#include "lpch.h"
+#include "Engine/Renderer/EnvironmentCache.h"
+#include "Engine/Utils/Hash.h"
+
+#include <glad/glad.h>
+#include <fstream>
+
+namespace Syndra {
+
+	//Bump when the bake shaders or the layout change, older files are then ignored
+	static constexpr uint32_t EnvironmentCacheVersion = 3;
+
+	struct EnvironmentCacheHeader
+	{
+		char Magic[4] = { 'S', 'N', 'E', 'V' };
+		uint32_t Version = EnvironmentCacheVersion;
+		uint64_t Key = 0;
+		EnvironmentBakeSettings Settings;
+	};
+
+	struct BRDFLutHeader
+	{
+		char Magic[4] = { 'S', 'N', 'B', 'R' };
+		uint32_t Version = EnvironmentCacheVersion;
+		uint32_t Size = 0;
+	};
+
+	static std::filesystem::path GetCacheDirectory()
+	{
+		return "assets/cache/environment";
+	}
+
+	static std::filesystem::path GetCachePath(uint64_t key)
+	{
+		std::stringstream name;
+		name << std::hex << key << ".snenv";
+		return GetCacheDirectory() / name.str();
+	}
+
+	static uint32_t MipSize(uint32_t size, uint32_t mip)
+	{
+		return std::max(size >> mip, 1u);
+	}
+
+	uint64_t EnvironmentCache::GetKey(uint64_t contentHash, const EnvironmentBakeSettings& settings)
+	{
+		uint64_t key = Hash::Combine(Hash::FNVOffset, contentHash);
+		key = Hash::Combine(key, settings);
+		return Hash::Combine(key, EnvironmentCacheVersion);
+	}
+
+	uint32_t EnvironmentCache::CreateCubemap(uint32_t size, uint32_t levels)
+	{
+		uint32_t texture;
+		glCreateTextures(GL_TEXTURE_CUBE_MAP, 1, &texture);
+		//RGBA so the bake shaders can write it as an image
+		glTextureStorage2D(texture, levels, GL_RGBA16F, size, size);
+		glTextureParameteri(texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(texture, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+		glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		return texture;
+	}
+
+	uint32_t EnvironmentCache::CreateTexture2D(uint32_t width, uint32_t height, uint32_t internalFormat)
+	{
+		uint32_t texture;
+		glCreateTextures(GL_TEXTURE_2D, 1, &texture);
+		glTextureStorage2D(texture, 1, internalFormat, width, height);
+		glTextureParameteri(texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		return texture;
+	}
+
+	std::vector<EnvironmentCacheImage> EnvironmentCache::GetImages(const EnvironmentBakeSettings& settings, const EnvironmentTextures& textures)
+	{
+		std::vector<EnvironmentCacheImage> images;
+		size_t offset = 0;
+		auto add = [&](uint32_t texture, uint32_t level, uint32_t width, uint32_t height, uint32_t layers) {
+			images.push_back({ texture, level, width, height, layers, offset });
+			//RGB9E5 is four bytes per texel
+			offset += (size_t)width * height * layers * sizeof(uint32_t);
+		};
+		add(textures.Cubemap, 0, settings.CubeSize, settings.CubeSize, 6);
+		for (uint32_t mip = 0; mip < settings.PrefilterMips; mip++)
+		{
+			uint32_t size = MipSize(settings.PrefilterSize, mip);
+			add(textures.Prefilter, mip, size, size, 6);
+		}
+		add(textures.Preview, 0, settings.PreviewWidth, settings.PreviewHeight, 1);
+		return images;
+	}
+
+	size_t EnvironmentCache::GetTexelDataSize(const EnvironmentBakeSettings& settings)
+	{
+		auto images = GetImages(settings, {});
+		const auto& last = images.back();
+		return last.Offset + (size_t)last.Width * last.Height * last.Layers * sizeof(uint32_t);
+	}
+
+	EnvironmentTextures EnvironmentCache::CreateTextures(const EnvironmentBakeSettings& settings)
+	{
+		EnvironmentTextures textures;
+		uint32_t cubeLevels = (uint32_t)std::floor(std::log2(settings.CubeSize)) + 1;
+		textures.Cubemap = CreateCubemap(settings.CubeSize, cubeLevels);
+		textures.Prefilter = CreateCubemap(settings.PrefilterSize, settings.PrefilterMips);
+		textures.Preview = CreateTexture2D(settings.PreviewWidth, settings.PreviewHeight, GL_RGB16F);
+		return textures;
+	}
+
+	void EnvironmentCache::UploadImages(const std::vector<EnvironmentCacheImage>& images, uint32_t pixelBuffer)
+	{
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffer);
+		for (auto& image : images)
+		{
+			//Cubemaps are uploaded as six layers, 2D textures have no layer dimension
+			if (image.Layers == 1)
+				glTextureSubImage2D(image.Texture, image.Level, 0, 0, image.Width, image.Height,
+					GL_RGB, GL_UNSIGNED_INT_5_9_9_9_REV, (const void*)image.Offset);
+			else
+				glTextureSubImage3D(image.Texture, image.Level, 0, 0, 0, image.Width, image.Height, image.Layers,
+					GL_RGB, GL_UNSIGNED_INT_5_9_9_9_REV, (const void*)image.Offset);
+		}
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	}
+
+	void EnvironmentCache::ReadImages(const std::vector<EnvironmentCacheImage>& images, uint32_t pixelBuffer)
+	{
+		glPixelStorei(GL_PACK_ALIGNMENT, 4);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffer);
+		for (auto& image : images)
+			glGetTextureImage(image.Texture, image.Level, GL_RGB, GL_UNSIGNED_INT_5_9_9_9_REV,
+				(GLsizei)((size_t)image.Width * image.Height * image.Layers * sizeof(uint32_t)), (void*)image.Offset);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	}
+
+	bool EnvironmentCache::Read(uint64_t key, const EnvironmentBakeSettings& settings, EnvironmentCacheData& data)
+	{
+		SN_PROFILE_FUNCTION();
+
+		std::ifstream in(GetCachePath(key), std::ios::in | std::ios::binary);
+		if (!in)
+			return false;
+		EnvironmentCacheHeader header, expected;
+		expected.Key = key;
+		expected.Settings = settings;
+		if (!in.read((char*)&header, sizeof(header)) || memcmp(&header, &expected, sizeof(header)) != 0) {
+			SN_CORE_WARN("Environment cache file {0} is outdated", GetCachePath(key).string());
+			return false;
+		}
+
+		data.Texels.resize(GetTexelDataSize(settings));
+		if (!in.read((char*)&data.Irradiance, sizeof(data.Irradiance)) || !in.read((char*)data.Texels.data(), data.Texels.size())) {
+			SN_CORE_WARN("Environment cache file {0} is truncated", GetCachePath(key).string());
+			return false;
+		}
+		return true;
+	}
+
+	void EnvironmentCache::Write(uint64_t key, const EnvironmentBakeSettings& settings, const SHIrradiance& irradiance, const void* texels, size_t size)
+	{
+		SN_PROFILE_FUNCTION();
+
+		std::filesystem::create_directories(GetCacheDirectory());
+		//Written under a temporary name, a reader never sees a partial file
+		auto path = GetCachePath(key);
+		auto temporaryPath = path;
+		temporaryPath += ".tmp";
+		{
+			std::ofstream out(temporaryPath, std::ios::out | std::ios::binary);
+			if (!out) {
+				SN_CORE_ERROR("Could not write the environment cache file {0}", path.string());
+				return;
+			}
+			EnvironmentCacheHeader header;
+			header.Key = key;
+			header.Settings = settings;
+			out.write((const char*)&header, sizeof(header));
+			out.write((const char*)&irradiance, sizeof(irradiance));
+			out.write((const char*)texels, size);
+		}
+		std::error_code error;
+		std::filesystem::rename(temporaryPath, path, error);
+	}
+
+	static std::filesystem::path GetBRDFLutPath()
+	{
+		return GetCacheDirectory() / "brdf_lut.snbrdf";
+	}
+
+	bool EnvironmentCache::LoadBRDFLut(uint32_t size, uint32_t& texture)
+	{
+		std::ifstream in(GetBRDFLutPath(), std::ios::in | std::ios::binary);
+		if (!in)
+			return false;
+		BRDFLutHeader header, expected;
+		expected.Size = size;
+		if (!in.read((char*)&header, sizeof(header)) || memcmp(&header, &expected, sizeof(header)) != 0)
+			return false;
+
+		//Two half floats per texel
+		std::vector<uint32_t> texels((size_t)size * size);
+		if (!in.read((char*)texels.data(), texels.size() * sizeof(uint32_t)))
+			return false;
+		texture = CreateTexture2D(size, size, GL_RG16F);
+		glTextureSubImage2D(texture, 0, 0, 0, size, size, GL_RG, GL_HALF_FLOAT, texels.data());
+		return true;
+	}
+
+	void EnvironmentCache::SaveBRDFLut(uint32_t size, uint32_t texture)
+	{
+		std::filesystem::create_directories(GetCacheDirectory());
+		std::ofstream out(GetBRDFLutPath(), std::ios::out | std::ios::binary);
+		if (!out)
+			return;
+		BRDFLutHeader header;
+		header.Size = size;
+		out.write((const char*)&header, sizeof(header));
+
+		std::vector<uint32_t> texels((size_t)size * size);
+		glPixelStorei(GL_PACK_ALIGNMENT, 4);
+		glGetTextureImage(texture, 0, GL_RG, GL_HALF_FLOAT, (GLsizei)(texels.size() * sizeof(uint32_t)), texels.data());
+		out.write((const char*)texels.data(), texels.size() * sizeof(uint32_t));
+	}
+
+}
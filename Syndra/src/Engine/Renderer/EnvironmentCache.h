@@ -0,0 +1,72 @@
+#pragma once
+#include "Engine/Renderer/SphericalHarmonics.h"
+
+namespace Syndra {
+
+	//Sizes of the baked environment maps, part of the cache key
+	struct EnvironmentBakeSettings
+	{
+		uint32_t CubeSize = 2048;
+		//Level of the cube the irradiance is projected from
+		uint32_t SHSourceSize = 32;
+		uint32_t PrefilterSize = 512;
+		uint32_t PrefilterMips = 5;
+		//Equirectangular thumbnail shown by the environment panel, the HDR itself is not decoded on a cache hit
+		uint32_t PreviewWidth = 512;
+		uint32_t PreviewHeight = 256;
+	};
+
+	//OpenGL textures of a baked environment
+	struct EnvironmentTextures
+	{
+		uint32_t Cubemap = 0;
+		uint32_t Prefilter = 0;
+		uint32_t Preview = 0;
+	};
+
+	//One image of a cache file, Offset is in bytes from the start of the texel data
+	struct EnvironmentCacheImage
+	{
+		uint32_t Texture;
+		uint32_t Level;
+		uint32_t Width, Height, Layers;
+		size_t Offset;
+	};
+
+	//CPU copy of a cache file
+	struct EnvironmentCacheData
+	{
+		SHIrradiance Irradiance;
+		std::vector<uint8_t> Texels;
+	};
+
+	//Bakes are stored in assets/cache/environment as one file per HDR content and bake settings. Texels are
+	//kept as RGB9E5, a 2048 cube with its preview is about 100MB and loads in a fraction of the bake time.
+	class EnvironmentCache
+	{
+	public:
+		//contentHash is Hash::HashFile of the HDR, renaming or moving it keeps its bake
+		static uint64_t GetKey(uint64_t contentHash, const EnvironmentBakeSettings& settings);
+
+		//File access only, safe to call from worker threads. Read is false when there is no valid file for the key.
+		static bool Read(uint64_t key, const EnvironmentBakeSettings& settings, EnvironmentCacheData& data);
+		static void Write(uint64_t key, const EnvironmentBakeSettings& settings, const SHIrradiance& irradiance, const void* texels, size_t size);
+
+		//Images in file order: the cube's first level, the prefilter mips and the preview
+		static std::vector<EnvironmentCacheImage> GetImages(const EnvironmentBakeSettings& settings, const EnvironmentTextures& textures);
+		static size_t GetTexelDataSize(const EnvironmentBakeSettings& settings);
+		static EnvironmentTextures CreateTextures(const EnvironmentBakeSettings& settings);
+		//Copies between the textures and a pixel buffer laid out like the file, the copies are asynchronous
+		static void UploadImages(const std::vector<EnvironmentCacheImage>& images, uint32_t pixelBuffer);
+		static void ReadImages(const std::vector<EnvironmentCacheImage>& images, uint32_t pixelBuffer);
+
+		//The BRDF LUT does not depend on the environment, it has its own file
+		static bool LoadBRDFLut(uint32_t size, uint32_t& texture);
+		static void SaveBRDFLut(uint32_t size, uint32_t texture);
+
+		//Immutable storage for the bake targets and the cache loads
+		static uint32_t CreateCubemap(uint32_t size, uint32_t levels);
+		static uint32_t CreateTexture2D(uint32_t width, uint32_t height, uint32_t internalFormat);
+	};
+
+}
@@ -13,6 +13,13 @@ namespace Syndra {
 		RGBA8,
 		RED_INTEGER,
 		RGBA16F,
+		//Unsigned normalized, used for octahedral encoded normals remapped to [0, 1].
+		//Snorm formats are not required to be renderable.
+		RG16,
+		//Stored in sRGB, sampling returns linear values
+		SRGB8_ALPHA8,
+		//Two half floats, used for motion vectors
+		RG16F,
 
 		Cubemap,
 
@@ -24,6 +31,17 @@ namespace Syndra {
 		Depth = DEPTH24STENCIL8
 	};
 
+	//Bytes a single sample of the format takes, used to estimate framebuffer bandwidth
+	inline uint32_t FramebufferTextureFormatSize(FramebufferTextureFormat format)
+	{
+		switch (format)
+		{
+		case FramebufferTextureFormat::RGBA16F:		return 8;
+		case FramebufferTextureFormat::None:		return 0;
+		default:									return 4;
+		}
+	}
+
 	struct FramebufferTextureSpecification
 	{
 		FramebufferTextureSpecification() = default;
@@ -48,6 +66,8 @@ namespace Syndra {
 		uint32_t Width = 0, Height = 0;
 		FramebufferAttachmentSpecification Attachments;
 		uint32_t Samples = 1;
+		//A layer count makes the depth attachment a 2D array texture, 0 keeps it a plain 2D texture
+		uint32_t Layers = 0;
 		glm::vec4 ClearColor;
 
 		bool SwapChainTarget = false;
@@ -63,6 +83,8 @@ namespace Syndra {
 
 		virtual void Resize(uint32_t width, uint32_t height) = 0;
 		virtual int ReadPixel(uint32_t attachmentIndex, int x, int y) = 0;
+		//Whole color attachment as RGBA8, rows bottom up. Used to save images of offscreen renders.
+		virtual void ReadPixels(uint32_t attachmentIndex, std::vector<uint8_t>& pixels) = 0;
 
 		virtual uint32_t GetRendererID() const = 0;
 		virtual void ClearAttachment(uint32_t attachmentIndex, int value) = 0;
@@ -71,6 +93,8 @@ namespace Syndra {
 		virtual uint32_t GetDepthAttachmentRendererID() const = 0;
 
 		virtual void BindCubemapFace(uint32_t index) const = 0;
+		//Renders into a single layer of a layered depth attachment
+		virtual void BindDepthLayer(uint32_t layer) const = 0;
 
 		virtual const FramebufferSpecification& GetSpecification() const = 0;
 		static Ref<FrameBuffer> Create(const FramebufferSpecification& spec);
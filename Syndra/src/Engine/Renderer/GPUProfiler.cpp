@@ -0,0 +1,106 @@
+#include "lpch.h"
+#include "Engine/Renderer/GPUProfiler.h"
+
+#include "Engine/Renderer/Renderer.h"
+#include "Platform/OpenGL/OpenGLGPUProfiler.h"
+
+#include <fstream>
+#include <cfloat>
+
+namespace Syndra {
+
+	Ref<GPUProfiler> GPUProfiler::Create()
+	{
+		switch (Renderer::GetAPI())
+		{
+		case RendererAPI::API::NONE:    SN_CORE_ASSERT(false, "RendererAPI::None is currently not supported!"); return nullptr;
+		case RendererAPI::API::OpenGL:  return CreateRef<OpenGLGPUProfiler>();
+		}
+
+		SN_CORE_ASSERT(false, "Unknown RendererAPI!");
+		return nullptr;
+	}
+
+	std::vector<GPUTimerStats> GPUProfiler::GetStats() const
+	{
+		std::vector<GPUTimerStats> stats;
+		stats.reserve(m_Series.size());
+		for (auto& series : m_Series)
+			stats.push_back(series.Stats);
+		return stats;
+	}
+
+	void GPUProfiler::Reset()
+	{
+		m_Series.clear();
+		m_Frame = Series();
+		m_Frame.Stats.Name = "Frame";
+		m_DroppedFrames = 0;
+	}
+
+	bool GPUProfiler::ExportCSV(const std::string& path) const
+	{
+		std::ofstream out(path);
+		if (!out) {
+			SN_CORE_ERROR("Could not write the GPU profile to {0}", path);
+			return false;
+		}
+
+		out << "Pass,Last (ms),Average (ms),Min (ms),Max (ms),Samples\n";
+		auto writeSeries = [&](const Series& series) {
+			auto& stats = series.Stats;
+			out << stats.Name << ',' << stats.Last << ',' << stats.Average << ',' << stats.Min << ',' << stats.Max << ',' << stats.Samples;
+			uint32_t count = (uint32_t)series.Samples.size();
+			//Once the window is full the oldest sample is the next one to be overwritten
+			uint32_t first = count < WindowSize ? 0 : series.Next;
+			for (uint32_t i = 0; i < count; i++)
+				out << ',' << series.Samples[(first + i) % count];
+			out << '\n';
+		};
+		for (auto& series : m_Series)
+			writeSeries(series);
+		writeSeries(m_Frame);
+		return true;
+	}
+
+	void GPUProfiler::AddSample(const std::string& name, float milliseconds)
+	{
+		auto it = std::find_if(m_Series.begin(), m_Series.end(), [&](const Series& series) { return series.Stats.Name == name; });
+		if (it == m_Series.end()) {
+			m_Series.emplace_back();
+			it = m_Series.end() - 1;
+			it->Stats.Name = name;
+		}
+		Push(*it, milliseconds);
+	}
+
+	void GPUProfiler::AddFrameSample(float milliseconds)
+	{
+		Push(m_Frame, milliseconds);
+	}
+
+	void GPUProfiler::Push(Series& series, float milliseconds)
+	{
+		if (series.Samples.size() < WindowSize)
+			series.Samples.push_back(milliseconds);
+		else
+			series.Samples[series.Next] = milliseconds;
+		series.Next = (series.Next + 1) % WindowSize;
+
+		auto& stats = series.Stats;
+		stats.Last = milliseconds;
+		stats.Samples = (uint32_t)series.Samples.size();
+		stats.Count++;
+		stats.Min = FLT_MAX;
+		stats.Max = 0.0f;
+		float sum = 0.0f;
+		for (auto sample : series.Samples)
+		{
+			stats.Min = std::min(stats.Min, sample);
+			stats.Max = std::max(stats.Max, sample);
+			sum += sample;
+		}
+		stats.Average = sum / stats.Samples;
+	}
+
+}
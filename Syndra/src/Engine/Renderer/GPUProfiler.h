@@ -0,0 +1,75 @@
+#pragma once
+
+namespace Syndra {
+
+	//Milliseconds over the rolling window of a timer
+	struct GPUTimerStats
+	{
+		std::string Name;
+		float Last = 0.0f;
+		float Average = 0.0f;
+		float Min = 0.0f;
+		float Max = 0.0f;
+		uint32_t Samples = 0;
+		//Samples since the last reset, tells readers polling the stats when a new sample arrived
+		uint32_t Count = 0;
+	};
+
+	//GPU time of named passes. Timers are read back a few frames after they were issued so reading them
+	//never waits on the GPU, frames whose results are still not available are dropped.
+	class GPUProfiler
+	{
+	public:
+		//Frames a timer stays in flight before it is read
+		static constexpr uint32_t FrameLatency = 4;
+		//Samples the rolling average, min and max are computed over
+		static constexpr uint32_t WindowSize = 120;
+
+		GPUProfiler() { m_Frame.Stats.Name = "Frame"; }
+		virtual ~GPUProfiler() = default;
+
+		//Reads back the oldest frame in flight and starts recording a new one
+		virtual void BeginFrame() = 0;
+		//Passes can nest, the frame time only sums the outermost ones
+		virtual void BeginPass(const std::string& name) = 0;
+		virtual void EndPass() = 0;
+
+		//Debug groups are still pushed while the timers are off
+		void SetEnabled(bool enabled) { m_Enabled = enabled; }
+		bool IsEnabled() const { return m_Enabled; }
+
+		//In the order the passes were first seen
+		std::vector<GPUTimerStats> GetStats() const;
+		const GPUTimerStats& GetFrameStats() const { return m_Frame.Stats; }
+		uint32_t GetDroppedFrames() const { return m_DroppedFrames; }
+		void Reset();
+
+		//One row per pass: stats followed by the samples of the window, oldest first
+		bool ExportCSV(const std::string& path) const;
+
+		static Ref<GPUProfiler> Create();
+
+	protected:
+		void AddSample(const std::string& name, float milliseconds);
+		void AddFrameSample(float milliseconds);
+
+	protected:
+		bool m_Enabled = true;
+		uint32_t m_DroppedFrames = 0;
+
+	private:
+		struct Series
+		{
+			GPUTimerStats Stats;
+			std::vector<float> Samples;
+			uint32_t Next = 0;
+		};
+
+		static void Push(Series& series, float milliseconds);
+
+	private:
+		std::vector<Series> m_Series;
+		Series m_Frame;
+	};
+
+}
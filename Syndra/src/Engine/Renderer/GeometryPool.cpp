@@ -0,0 +1,56 @@
+#include "lpch.h"
+#include "Engine/Renderer/GeometryPool.h"
+
+#include "Engine/Renderer/Renderer.h"
+#include "Platform/OpenGL/OpenGLGeometryPool.h"
+
+namespace Syndra {
+
+	GeometryAllocation::GeometryAllocation(const Ref<GeometryPool>& pool, uint32_t baseVertex, uint32_t vertexCount, uint32_t firstIndex, uint32_t indexCount)
+		:m_Pool(pool), m_BaseVertex(baseVertex), m_VertexCount(vertexCount), m_FirstIndex(firstIndex), m_IndexCount(indexCount)
+	{
+	}
+
+	GeometryAllocation::~GeometryAllocation()
+	{
+		m_Pool->Free(*this);
+	}
+
+	static std::string LayoutSignature(const BufferLayout& layout)
+	{
+		std::string signature;
+		for (const auto& element : layout)
+		{
+			signature += element.Name + ":" + std::to_string((int)element.Type) + ";";
+		}
+		return signature;
+	}
+
+	Ref<GeometryPool> GeometryPool::Get(const BufferLayout& layout)
+	{
+		static std::unordered_map<std::string, Ref<GeometryPool>> s_Pools;
+
+		auto signature = LayoutSignature(layout);
+		auto it = s_Pools.find(signature);
+		if (it != s_Pools.end())
+			return it->second;
+
+		//1M vertices and 3M indices to start with, pools grow when full
+		auto pool = Create(layout, 1 << 20, 3 << 20);
+		s_Pools[signature] = pool;
+		return pool;
+	}
+
+	Ref<GeometryPool> GeometryPool::Create(const BufferLayout& layout, uint32_t vertexCapacity, uint32_t indexCapacity)
+	{
+		switch (Renderer::GetAPI())
+		{
+		case RendererAPI::API::NONE:    SN_CORE_ASSERT(false, "RendererAPI::None is currently not supported!"); return nullptr;
+		case RendererAPI::API::OpenGL:  return CreateRef<OpenGLGeometryPool>(layout, vertexCapacity, indexCapacity);
+		}
+
+		SN_CORE_ASSERT(false, "Unknown RendererAPI!");
+		return nullptr;
+	}
+
+}
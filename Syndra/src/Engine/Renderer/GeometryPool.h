@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Engine/Renderer/Buffer.h"
+
+namespace Syndra {
+
+	class GeometryPool;
+
+	//A range of vertices and indices inside a pool, returned to the pool when the last reference dies
+	class GeometryAllocation
+	{
+	public:
+		GeometryAllocation(const Ref<GeometryPool>& pool, uint32_t baseVertex, uint32_t vertexCount, uint32_t firstIndex, uint32_t indexCount);
+		~GeometryAllocation();
+
+		uint32_t GetBaseVertex() const { return m_BaseVertex; }
+		uint32_t GetVertexCount() const { return m_VertexCount; }
+		uint32_t GetFirstIndex() const { return m_FirstIndex; }
+		uint32_t GetIndexCount() const { return m_IndexCount; }
+
+		const Ref<GeometryPool>& GetPool() const { return m_Pool; }
+
+	private:
+		Ref<GeometryPool> m_Pool;
+		uint32_t m_BaseVertex, m_VertexCount;
+		uint32_t m_FirstIndex, m_IndexCount;
+	};
+
+	//Shared vertex/index buffers for every mesh with the same vertex layout, drawn through a single vertex array.
+	//Meshes only keep an allocation (base vertex, first index) into the pool.
+	class GeometryPool : public std::enable_shared_from_this<GeometryPool>
+	{
+	public:
+		virtual ~GeometryPool() = default;
+
+		virtual void Bind() const = 0;
+
+		//vertices must follow the pool layout, indices are relative to the first vertex
+		virtual Ref<GeometryAllocation> Allocate(const void* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount) = 0;
+		virtual void Free(const GeometryAllocation& allocation) = 0;
+
+		virtual const BufferLayout& GetLayout() const = 0;
+		virtual uint32_t GetRendererID() const = 0;
+
+		//Returns the pool of the layout, creating it on first use
+		static Ref<GeometryPool> Get(const BufferLayout& layout);
+		static Ref<GeometryPool> Create(const BufferLayout& layout, uint32_t vertexCapacity, uint32_t indexCapacity);
+	};
+
+}
@@ -5,62 +5,164 @@ namespace Syndra {
 
 
 
-	LightManager::LightManager(uint32_t binding)
+	LightManager::LightManager(const Ref<RingBuffer>& ringBuffer, uint32_t uniformBinding, uint32_t storageBinding)
+		:m_RingBuffer(ringBuffer), m_UniformBinding(uniformBinding), m_StorageBinding(storageBinding)
 	{
-		m_LightBuffer = UniformBuffer::Create(sizeof(m_PointLights) + sizeof(m_SpotLights) + sizeof(m_DirLight), binding);
+		m_ClusterLights.resize(2 * ClusterCount);
+		m_ClusterRanges.resize(ClusterCount);
 	}
 
 	void LightManager::IntitializeLights()
 	{
-		for (auto& pointLight : m_PointLights)
+		m_PointLights.clear();
+		m_SpotLights.clear();
+
+		m_GridData.dirLight.color = glm::vec4(0);
+		m_GridData.dirLight.position = glm::vec4(0);
+		m_GridData.dirLight.direction = glm::vec4(0);
+	}
+
+	void LightManager::UpdateBuffer(const glm::mat4& view, const glm::mat4& projection, float nearClip, float farClip)
+	{
+		AssignLights(view, projection, nearClip, farClip);
+
+		float depthScale = (float)ClusterCountZ / glm::log(farClip / nearClip);
+		m_GridData.view = view;
+		m_GridData.clusterCount = { ClusterCountX, ClusterCountY, ClusterCountZ, 0 };
+		m_GridData.clusterDepth = { depthScale, glm::log(nearClip) * depthScale, nearClip, farClip };
+		m_RingBuffer->BindUniform(m_RingBuffer->Upload(&m_GridData, sizeof(LightGridData)), m_UniformBinding);
+
+		//Empty lists still need a buffer range bound
+		auto upload = [&](const void* data, size_t size, uint32_t binding) {
+			auto allocation = m_RingBuffer->Allocate((uint32_t)std::max(size, (size_t)16));
+			if (size > 0)
+				memcpy(allocation.Data, data, size);
+			m_RingBuffer->BindStorage(allocation, binding);
+		};
+		upload(m_PointLights.data(), m_PointLights.size() * sizeof(pointLight), m_StorageBinding);
+		upload(m_SpotLights.data(), m_SpotLights.size() * sizeof(spotLight), m_StorageBinding + 1);
+		upload(m_ClusterRanges.data(), m_ClusterRanges.size() * sizeof(glm::uvec2), m_StorageBinding + 2);
+		upload(m_LightIndices.data(), m_LightIndices.size() * sizeof(uint32_t), m_StorageBinding + 3);
+	}
+
+	void LightManager::AssignLights(const glm::mat4& view, const glm::mat4& projection, float nearClip, float farClip)
+	{
+		for (auto& lights : m_ClusterLights)
+			lights.clear();
+
+		for (uint32_t i = 0; i < m_PointLights.size(); i++)
 		{
-			pointLight.color = glm::vec4(0);
-			pointLight.position = glm::vec4(0);
-			pointLight.dist = 0.0f;
+			auto& light = m_PointLights[i];
+			AssignLight(0, i, glm::vec3(view * light.position), light.range, projection, nearClip, farClip);
 		}
-
-		for (auto& spot : m_SpotLights)
+		for (uint32_t i = 0; i < m_SpotLights.size(); i++)
 		{
-			spot.color = glm::vec4(0);
-			spot.position = glm::vec4(0);
-			spot.direction = glm::vec4(0);
-			spot.innerCutOff = glm::cos(glm::radians(12.5f));
-			spot.outerCutOff = glm::cos(glm::radians(15.0f));
+			auto& light = m_SpotLights[i];
+			AssignLight(1, i, glm::vec3(view * light.position), light.range, projection, nearClip, farClip);
 		}
 
-		m_DirLight.color = glm::vec4(0);
-		m_DirLight.position = glm::vec4(0);
-		m_DirLight.direction = glm::vec4(0);
+		//Flatten the per cluster lists, point lights of a cluster are followed by its spot lights
+		m_LightIndices.clear();
+		m_Stats = LightStats();
+		for (uint32_t cluster = 0; cluster < ClusterCount; cluster++)
+		{
+			auto& points = m_ClusterLights[cluster];
+			auto& spots = m_ClusterLights[ClusterCount + cluster];
+			m_ClusterRanges[cluster] = { (uint32_t)m_LightIndices.size(), (uint32_t)points.size() | (uint32_t)spots.size() << 16 };
+			m_LightIndices.insert(m_LightIndices.end(), points.begin(), points.end());
+			m_LightIndices.insert(m_LightIndices.end(), spots.begin(), spots.end());
+			m_Stats.maxPerCluster = std::max(m_Stats.maxPerCluster, (uint32_t)(points.size() + spots.size()));
+		}
+		m_Stats.pointLights = (uint32_t)m_PointLights.size();
+		m_Stats.spotLights = (uint32_t)m_SpotLights.size();
+		m_Stats.indices = (uint32_t)m_LightIndices.size();
 	}
 
-	void LightManager::UpdateBuffer()
+	//Adds the light to every cluster its bounding sphere overlaps. Each depth slice is tested with the
+	//part of the sphere inside it, projected conservatively at the slice depth that makes it largest.
+	void LightManager::AssignLight(uint32_t list, uint32_t index, const glm::vec3& viewPosition, float range,
+		const glm::mat4& projection, float nearClip, float farClip)
 	{
-		m_LightBuffer->SetData(&m_PointLights, sizeof(m_PointLights));
-		m_LightBuffer->SetData(&m_SpotLights, sizeof(m_SpotLights), sizeof(m_PointLights));
-		m_LightBuffer->SetData(&m_DirLight, sizeof(m_DirLight), sizeof(m_PointLights) + sizeof(m_SpotLights));
+		float depth = -viewPosition.z;
+		if (range <= 0.0f || depth + range < nearClip || depth - range > farClip)
+			return;
+
+		float logRatio = glm::log(farClip / nearClip);
+		auto sliceOf = [&](float z) {
+			return glm::clamp((int)(glm::log(z / nearClip) / logRatio * ClusterCountZ), 0, (int)ClusterCountZ - 1);
+		};
+		auto sliceDepth = [&](int slice) {
+			return nearClip * glm::pow(farClip / nearClip, (float)slice / ClusterCountZ);
+		};
+		//ndc to cluster coordinate
+		auto tileOf = [](float ndc, uint32_t count) {
+			return glm::clamp((int)((ndc * 0.5f + 0.5f) * count), 0, (int)count - 1);
+		};
+
+		float minDepth = std::max(depth - range, nearClip);
+		float maxDepth = std::min(depth + range, farClip);
+		int firstSlice = sliceOf(minDepth);
+		int lastSlice = sliceOf(maxDepth);
+		for (int slice = firstSlice; slice <= lastSlice; slice++)
+		{
+			float sliceNear = std::max(sliceDepth(slice), minDepth);
+			float sliceFar = std::min(sliceDepth(slice + 1), maxDepth);
+
+			//Radius of the sphere cross section closest to its center inside the slice
+			float closest = glm::clamp(depth, sliceNear, sliceFar) - depth;
+			float radius = glm::sqrt(std::max(range * range - closest * closest, 0.0f));
+
+			//Extents pointing away from the view axis project widest at the nearest depth, the others at the farthest
+			glm::vec2 minimum = glm::vec2(viewPosition) - radius;
+			glm::vec2 maximum = glm::vec2(viewPosition) + radius;
+			float minX = projection[0][0] * minimum.x / (minimum.x < 0.0f ? sliceNear : sliceFar);
+			float maxX = projection[0][0] * maximum.x / (maximum.x > 0.0f ? sliceNear : sliceFar);
+			float minY = projection[1][1] * minimum.y / (minimum.y < 0.0f ? sliceNear : sliceFar);
+			float maxY = projection[1][1] * maximum.y / (maximum.y > 0.0f ? sliceNear : sliceFar);
+			if (minX > 1.0f || maxX < -1.0f || minY > 1.0f || maxY < -1.0f)
+				continue;
+
+			int x0 = tileOf(minX, ClusterCountX), x1 = tileOf(maxX, ClusterCountX);
+			int y0 = tileOf(minY, ClusterCountY), y1 = tileOf(maxY, ClusterCountY);
+			for (int y = y0; y <= y1; y++)
+			{
+				for (int x = x0; x <= x1; x++)
+				{
+					uint32_t cluster = x + ClusterCountX * (y + ClusterCountY * slice);
+					m_ClusterLights[list * ClusterCount + cluster].push_back(index);
+				}
+			}
+		}
 	}
 
 	void LightManager::UpdateDirLight(DirectionalLight* dl, const glm::vec3& position)
 	{
-		m_DirLight.color = glm::vec4(dl->GetColor(), 0) * dl->GetIntensity();
-		m_DirLight.direction = glm::vec4(dl->GetDirection(), 0);
-		m_DirLight.position = glm::vec4(position, 0);
+		m_GridData.dirLight.color = glm::vec4(dl->GetColor(), 0) * dl->GetIntensity();
+		m_GridData.dirLight.direction = glm::vec4(dl->GetDirection(), 0);
+		m_GridData.dirLight.position = glm::vec4(position, 0);
 	}
 
-	void LightManager::UpdatePointLights(PointLight* pl, const glm::vec3& position, uint32_t index)
+	void LightManager::AddPointLight(PointLight* pl, const glm::vec3& position, int shadowIndex)
 	{
-		m_PointLights[index].color = glm::vec4(pl->GetColor(), 1) * pl->GetIntensity();
-		m_PointLights[index].position = glm::vec4(position, 1);
-		m_PointLights[index].dist = pl->GetRange();
+		pointLight light = {};
+		light.color = glm::vec4(pl->GetColor(), 1) * pl->GetIntensity();
+		light.position = glm::vec4(position, 1);
+		light.range = pl->GetRange();
+		light.shadowIndex = shadowIndex;
+		m_PointLights.push_back(light);
 	}
 
-	void LightManager::UpdateSpotLights(SpotLight* sl, const glm::vec3& position, uint32_t index)
+	void LightManager::AddSpotLight(SpotLight* sl, const glm::vec3& position, int shadowIndex)
 	{
-		m_SpotLights[index].color = glm::vec4(sl->GetColor(), 1) * sl->GetIntensity();
-		m_SpotLights[index].position = glm::vec4(position, 1);
-		m_SpotLights[index].direction = glm::vec4(sl->GetDirection(), 0);
-		m_SpotLights[index].innerCutOff = glm::cos(glm::radians(sl->GetInnerCutOff()));
-		m_SpotLights[index].outerCutOff = glm::cos(glm::radians(sl->GetOuterCutOff()));
+		spotLight light = {};
+		light.color = glm::vec4(sl->GetColor(), 1) * sl->GetIntensity();
+		light.position = glm::vec4(position, 1);
+		light.direction = glm::vec4(glm::normalize(sl->GetDirection()), 0);
+		light.innerCutOff = glm::cos(glm::radians(sl->GetInnerCutOff()));
+		light.outerCutOff = glm::cos(glm::radians(sl->GetOuterCutOff()));
+		light.range = sl->GetRange();
+		light.shadowIndex = shadowIndex;
+		m_SpotLights.push_back(light);
 	}
 
 }
@@ -1,15 +1,18 @@
 #pragma once
 #include "Engine/Scene/Light.h"
-#include "Engine/Renderer/UniformBuffer.h"
+#include "Engine/Renderer/RingBuffer.h"
 
 namespace Syndra {
 
+	//std430 layouts of the light storage buffers
 	struct pointLight
 	{
 		glm::vec4 position;
 		glm::vec4 color;
-		float dist;
-		glm::vec3 dummy;
+		float range;
+		//First of the six cube face tiles in the shadow tile buffer, -1 without shadows
+		int shadowIndex;
+		float padding[2];
 	};
 
 	struct spotLight {
@@ -18,7 +21,8 @@ namespace Syndra {
 		glm::vec4 direction;
 		float innerCutOff;
 		float outerCutOff;
-		glm::vec2 dummy;
+		float range;
+		int shadowIndex;
 	};
 
 	struct directionalLight
@@ -28,27 +32,72 @@ namespace Syndra {
 		glm::vec4 color;
 	};
 
+	//Uniform block shared by the lighting shaders, the cluster of a fragment is found from its
+	//screen uv and its view space depth: slice = log(depth) * depthScale - depthBias
+	struct LightGridData
+	{
+		glm::mat4 view;
+		directionalLight dirLight;
+		glm::uvec4 clusterCount;
+		//depth scale, depth bias, near, far
+		glm::vec4 clusterDepth;
+	};
+
+	struct LightStats
+	{
+		uint32_t pointLights = 0;
+		uint32_t spotLights = 0;
+		uint32_t indices = 0;
+		uint32_t maxPerCluster = 0;
+	};
+
+	//Local lights are binned on the CPU into a froxel grid built from the camera frustum
+	//(exponential depth slices), the lighting pass only evaluates the lights of its cluster.
+	//Bindings: uniform block (uniformBinding), storage buffers starting at storageBinding:
+	//point lights, spot lights, cluster ranges and light indices.
 	class LightManager {
 
 	public:
-		LightManager(uint32_t binding);
+		LightManager(const Ref<RingBuffer>& ringBuffer, uint32_t uniformBinding, uint32_t storageBinding);
 
 		void IntitializeLights();
-		void UpdateBuffer();
+		void UpdateBuffer(const glm::mat4& view, const glm::mat4& projection, float nearClip, float farClip);
 
 		void UpdateDirLight(DirectionalLight* dl, const glm::vec3& position);
-		void UpdatePointLights(PointLight* pl, const glm::vec3& position, uint32_t index);
-		void UpdateSpotLights(SpotLight* sl, const glm::vec3& position, uint32_t index);
+		void AddPointLight(PointLight* pl, const glm::vec3& position, int shadowIndex = -1);
+		void AddSpotLight(SpotLight* sl, const glm::vec3& position, int shadowIndex = -1);
+
+		const LightStats& GetStats() const { return m_Stats; }
 
 		~LightManager() = default;
 
+		static constexpr uint32_t ClusterCountX = 16;
+		static constexpr uint32_t ClusterCountY = 9;
+		static constexpr uint32_t ClusterCountZ = 24;
+		static constexpr uint32_t ClusterCount = ClusterCountX * ClusterCountY * ClusterCountZ;
+
 	private:
-		Ref<UniformBuffer> m_LightBuffer;
+		void AssignLights(const glm::mat4& view, const glm::mat4& projection, float nearClip, float farClip);
+		void AssignLight(uint32_t list, uint32_t index, const glm::vec3& viewPosition, float range,
+			const glm::mat4& projection, float nearClip, float farClip);
+
+	private:
+		//Lights are uploaded to the frame's ring buffer region every frame
+		Ref<RingBuffer> m_RingBuffer;
+		uint32_t m_UniformBinding;
+		uint32_t m_StorageBinding;
+
+		LightGridData m_GridData;
+		std::vector<pointLight> m_PointLights;
+		std::vector<spotLight> m_SpotLights;
 
-		directionalLight m_DirLight;
-		pointLight m_PointLights[4];
-		spotLight m_SpotLights[4];
+		//Light indices of every cluster, point lights in [0, ClusterCount) and spot lights in [ClusterCount, 2 * ClusterCount)
+		std::vector<std::vector<uint32_t>> m_ClusterLights;
+		//Per cluster: offset into the index list, point light count | spot light count << 16
+		std::vector<glm::uvec2> m_ClusterRanges;
+		std::vector<uint32_t> m_LightIndices;
 
+		LightStats m_Stats;
 	};
 
-}
\ No newline at end of file
+}
@@ -9,6 +9,31 @@ namespace Syndra {
 		m_Shader = shader;
 		m_Samplers = shader->GetSamplers();
 		m_PushConstants = shader->GetPushConstants();
+		ResolveParameters();
+	}
+
+	void Material::ResolveParameters()
+	{
+		m_Parameters.HasMap[0] = m_Shader->GetParameter<int>("push.HasAlbedoMap");
+		m_Parameters.HasMap[1] = m_Shader->GetParameter<int>("push.HasMetallicMap");
+		m_Parameters.HasMap[2] = m_Shader->GetParameter<int>("push.HasNormalMap");
+		m_Parameters.HasMap[3] = m_Shader->GetParameter<int>("push.HasRoughnessMap");
+		m_Parameters.HasMap[4] = m_Shader->GetParameter<int>("push.HasAOMap");
+		m_Parameters.MetallicFactor = m_Shader->GetParameter<float>("push.material.MetallicFactor");
+		m_Parameters.RoughnessFactor = m_Shader->GetParameter<float>("push.material.RoughnessFactor");
+		m_Parameters.AO = m_Shader->GetParameter<float>("push.material.AO");
+		m_Parameters.Color = m_Shader->GetParameter<glm::vec4>("push.material.color");
+		m_Parameters.Tiling = m_Shader->GetParameter<float>("push.tiling");
+
+		m_Parameters.HasMaterial = false;
+		for (auto& pushConstant : m_PushConstants)
+		{
+			for (auto& item : pushConstant.members)
+			{
+				if (item.name == "material")
+					m_Parameters.HasMaterial = true;
+			}
+		}
 	}
 
 	void Material::Set(const std::string& name, float value)
@@ -84,49 +109,30 @@ namespace Syndra {
 	{
 		m_Shader->Bind();
 		
-		//Binding textures
+		//Binding textures, the whole set goes in one multi-bind
+		uint32_t ids[MaxTextureSlots] = {};
+		uint32_t count = 0;
 		for (auto& sampler : m_Samplers)
 		{
 			auto& texture = m_Textures[sampler.binding];
-			if (sampler.isUsed && texture) {
-
-				if (sampler.binding == 0)
-					m_Shader->SetInt("push.HasAlbedoMap", 1);
-				if (sampler.binding == 1)
-					m_Shader->SetInt("push.HasMetallicMap", 1);
-				if (sampler.binding == 2)
-					m_Shader->SetInt("push.HasNormalMap", 1);
-				if (sampler.binding == 3)
-					m_Shader->SetInt("push.HasRoughnessMap", 1);
-				if (sampler.binding == 4)
-					m_Shader->SetInt("push.HasAOMap", 1);
-				texture->Bind(sampler.binding);
-			}
-			else
-			{
-				if (sampler.binding == 0)
-					m_Shader->SetInt("push.HasAlbedoMap", 0);
-				if (sampler.binding == 1)
-					m_Shader->SetInt("push.HasMetallicMap", 0);
-				if (sampler.binding == 2)
-					m_Shader->SetInt("push.HasNormalMap", 0);
-				if (sampler.binding == 3)
-					m_Shader->SetInt("push.HasRoughnessMap", 0);
-				if (sampler.binding == 4)
-					m_Shader->SetInt("push.HasAOMap", 0);
+			bool used = sampler.isUsed && texture;
+			if (sampler.binding < 5)
+				m_Shader->Set(m_Parameters.HasMap[sampler.binding], (int)used);
+			if (used && sampler.binding < MaxTextureSlots) {
+				ids[sampler.binding] = texture->GetRendererID();
+				count = std::max(count, sampler.binding + 1);
 			}
 		}
+		if (count)
+			Texture::BindTextures(0, count, ids);
 
 		//Binding push constants
-		for (auto& item : m_PushConstants[1].members) 
-		{
-			if (item.name == "material") {
-				m_Shader->SetFloat("push.material.MetallicFactor", m_Cbuffer.material.MetallicFactor);
-				m_Shader->SetFloat("push.material.RoughnessFactor", m_Cbuffer.material.RoughnessFactor);
-				m_Shader->SetFloat("push.material.AO", m_Cbuffer.material.AO);
-				m_Shader->SetFloat4("push.material.color", m_Cbuffer.material.color);
-				m_Shader->SetFloat("push.tiling", m_Cbuffer.tiling);
-			}
+		if (m_Parameters.HasMaterial) {
+			m_Shader->Set(m_Parameters.MetallicFactor, m_Cbuffer.material.MetallicFactor);
+			m_Shader->Set(m_Parameters.RoughnessFactor, m_Cbuffer.material.RoughnessFactor);
+			m_Shader->Set(m_Parameters.AO, m_Cbuffer.material.AO);
+			m_Shader->Set(m_Parameters.Color, m_Cbuffer.material.color);
+			m_Shader->Set(m_Parameters.Tiling, m_Cbuffer.tiling);
 		}
 	}
 
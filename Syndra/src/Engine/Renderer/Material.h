@@ -37,6 +37,7 @@ namespace Syndra {
 			m_PushConstants = m_Shader->GetPushConstants();
 			m_Textures = material.m_Textures;
 			m_Cbuffer = material.m_Cbuffer;
+			m_Parameters = material.m_Parameters;
 			SetSamplersUsed();
 		};
 		Material(Ref<Shader>& shader);
@@ -64,9 +65,24 @@ namespace Syndra {
 
 	private:
 		void SetSamplersUsed();
+		void ResolveParameters();
 
 
 	private:
+		static constexpr uint32_t MaxTextureSlots = 8;
+
+		//Uniform handles of the shader, resolved once instead of looked up by name on every bind
+		struct Parameters
+		{
+			//Indexed by the binding of the map they toggle
+			ShaderParameter<int> HasMap[5];
+			ShaderParameter<float> MetallicFactor;
+			ShaderParameter<float> RoughnessFactor;
+			ShaderParameter<float> AO;
+			ShaderParameter<glm::vec4> Color;
+			ShaderParameter<float> Tiling;
+			bool HasMaterial = false;
+		};
 
 		Ref<Shader> m_Shader;
 		CBuffer m_Cbuffer;
@@ -74,6 +90,7 @@ namespace Syndra {
 
 		std::vector<PushConstant> m_PushConstants;
 		std::vector<Sampler> m_Samplers;
+		Parameters m_Parameters;
 
 	};
 
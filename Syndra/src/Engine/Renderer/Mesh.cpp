@@ -1,26 +1,34 @@
 #include "lpch.h"
 #include "Engine/Renderer/Mesh.h"
+#include "Engine/Renderer/Texture.h"
 
 namespace Syndra {
 
-	Mesh::Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<texture> textures)
+	Mesh::Mesh(const Vertex* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount, std::vector<texture> textures, const Math::AABB& bounds)
+		:textures(std::move(textures)), bounds(bounds)
 	{
-		this->vertices = vertices;
-		this->indices = indices;
-		this->textures = textures;
-		setupMesh();
+		setupMesh(vertices, vertexCount, indices, indexCount);
 	}
 
-	void Mesh::setupMesh()
+	void Mesh::BindTextures() const
 	{
-		// create buffers/arrays
-		m_VertexArray = VertexArray::Create();
-		m_VertexBuffer = VertexBuffer::Create((float*)(&vertices[0]), vertices.size()*sizeof(Vertex));
-		m_IndexBuffer = IndexBuffer::Create(&indices[0], indices.size());
-
-		m_VertexArray->Bind();
+		//diffuse, specular, normal
+		uint32_t ids[3] = { 0, 0, 0 };
+		for (auto& texture : textures)
+		{
+			if (texture.type == "texture_diffuse")
+				ids[0] = texture.id;
+			else if (texture.type == "texture_specular")
+				ids[1] = texture.id;
+			else if (texture.type == "texture_normal")
+				ids[2] = texture.id;
+		}
+		Texture2D::BindTextures(0, 3, ids);
+	}
 
-		BufferLayout layout = {
+	void Mesh::setupMesh(const Vertex* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount)
+	{
+		static BufferLayout layout = {
 			{ShaderDataType::Float3,"a_pos"},
 			{ShaderDataType::Float2,"a_uv"},
 			{ShaderDataType::Float3,"a_normal"},
@@ -28,9 +36,7 @@ namespace Syndra {
 			{ShaderDataType::Float3,"a_bitangent"}
 		};
 
-		m_VertexBuffer->SetLayout(layout);
-		m_VertexArray->AddVertexBuffer(m_VertexBuffer);
-		m_VertexArray->SetIndexBuffer(m_IndexBuffer);
-		//vertexBuffer->Unbind();
+		auto pool = GeometryPool::Get(layout);
+		m_Geometry = pool->Allocate(vertices, vertexCount, indices, indexCount);
 	}
 }
\ No newline at end of file
@@ -3,7 +3,8 @@
 #include <glm/gtc/matrix_transform.hpp>
 
 #include "Engine/Renderer/Shader.h"
-#include "Engine/Renderer/VertexArray.h"
+#include "Engine/Renderer/GeometryPool.h"
+#include "Engine/Utils/Math.h"
 
 namespace Syndra {
 
@@ -25,21 +26,24 @@ namespace Syndra {
 	{
 	public:
 
-		std::vector<Vertex> vertices;
-		std::vector<unsigned int> indices;
 		std::vector<texture> textures;
+		//Local space bounds, computed at import
+		Math::AABB bounds;
 		
-		Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<texture> textures);
+		//The vertices and indices are copied into the geometry pool, the mesh keeps no CPU copy
+		Mesh(const Vertex* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount, std::vector<texture> textures, const Math::AABB& bounds);
 		~Mesh() = default;
 
-		Ref<VertexArray> GetVertexArray() const  { return m_VertexArray; }
-		void BindVertexArray() const { m_VertexArray->Bind(); }
+		const Ref<GeometryAllocation>& GetGeometry() const { return m_Geometry; }
+		const Ref<GeometryPool>& GetGeometryPool() const { return m_Geometry->GetPool(); }
+		void BindVertexArray() const { m_Geometry->GetPool()->Bind(); }
+		//Binds the imported textures (diffuse 0, specular 1, normal 2)
+		void BindTextures() const;
 
 	private:
-		Ref<VertexArray> m_VertexArray;
-		Ref<VertexBuffer> m_VertexBuffer;
-		Ref<IndexBuffer> m_IndexBuffer;
-		void setupMesh();
+		//Vertices and indices live in the shared pool of the mesh layout
+		Ref<GeometryAllocation> m_Geometry;
+		void setupMesh(const Vertex* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount);
 	};
 
 }
\ No newline at end of file
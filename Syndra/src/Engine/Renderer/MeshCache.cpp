@@ -0,0 +1,172 @@
+#include "lpch.h"
+#include "Engine/Renderer/MeshCache.h"
+
+#include <fstream>
+
+namespace Syndra {
+
+	//Bump when the vertex layout or the record layout change
+	static constexpr uint32_t MeshCacheVersion = 1;
+
+	struct MeshCacheHeader
+	{
+		char Magic[4] = { 'S', 'N', 'M', 'H' };
+		uint32_t Version = MeshCacheVersion;
+		uint32_t VertexSize = sizeof(Vertex);
+		uint32_t MeshCount = 0;
+	};
+
+	struct MeshRecordHeader
+	{
+		uint32_t VertexCount;
+		uint32_t IndexCount;
+		uint32_t TextureCount;
+		glm::vec3 Min, Max;
+	};
+
+	//Strings are stored with their length, padded so the vertex data stays 4 byte aligned
+	static size_t AlignTo4(size_t size)
+	{
+		return (size + 3) & ~(size_t)3;
+	}
+
+	std::string MeshCache::GetCachePath(const std::string& sourcePath)
+	{
+		return sourcePath + ".snmesh";
+	}
+
+	bool MeshCacheReader::Open(const std::string& sourcePath)
+	{
+		SN_PROFILE_FUNCTION();
+		std::error_code error;
+		auto cachePath = MeshCache::GetCachePath(sourcePath);
+		auto cacheTime = std::filesystem::last_write_time(cachePath, error);
+		if (error)
+			return false;
+		//A missing source keeps the cache usable, assets can be shipped without it
+		auto sourceTime = std::filesystem::last_write_time(sourcePath, error);
+		if (!error && sourceTime > cacheTime)
+			return false;
+
+		m_File = CreateScope<MappedFile>(cachePath);
+		MeshCacheHeader expected, header;
+		if (!m_File->IsOpen() || m_File->GetSize() < sizeof(header))
+			return false;
+		memcpy(&header, m_File->GetData(), sizeof(header));
+		if (memcmp(header.Magic, expected.Magic, sizeof(header.Magic)) != 0 || header.Version != expected.Version || header.VertexSize != expected.VertexSize)
+			return false;
+
+		m_Offset = sizeof(header);
+		m_MeshCount = header.MeshCount;
+		m_MeshIndex = 0;
+		return true;
+	}
+
+	bool MeshCacheReader::Next(MeshCacheRecord& record)
+	{
+		if (m_MeshIndex == m_MeshCount)
+			return false;
+
+		const uint8_t* data = m_File->GetData();
+		size_t size = m_File->GetSize();
+		auto read = [&](void* destination, size_t bytes) {
+			if (m_Offset + bytes > size)
+				return false;
+			memcpy(destination, data + m_Offset, bytes);
+			m_Offset += bytes;
+			return true;
+		};
+		auto readString = [&](std::string& string) {
+			uint32_t length;
+			if (!read(&length, sizeof(length)) || m_Offset + length > size)
+				return false;
+			string.assign((const char*)data + m_Offset, length);
+			m_Offset += AlignTo4(length);
+			return true;
+		};
+
+		MeshRecordHeader header;
+		if (!read(&header, sizeof(header)))
+			return false;
+		record.Bounds = Math::AABB(header.Min, header.Max);
+		record.Textures.resize(header.TextureCount);
+		for (auto& [type, path] : record.Textures)
+		{
+			if (!readString(type) || !readString(path))
+				return false;
+		}
+
+		size_t vertexBytes = (size_t)header.VertexCount * sizeof(Vertex);
+		size_t indexBytes = (size_t)header.IndexCount * sizeof(uint32_t);
+		if (m_Offset + vertexBytes + indexBytes > size)
+			return false;
+		record.Vertices = (const Vertex*)(data + m_Offset);
+		record.VertexCount = header.VertexCount;
+		m_Offset += vertexBytes;
+		record.Indices = (const uint32_t*)(data + m_Offset);
+		record.IndexCount = header.IndexCount;
+		m_Offset += indexBytes;
+
+		m_MeshIndex++;
+		return true;
+	}
+
+	MeshCacheWriter::MeshCacheWriter()
+	{
+		MeshCacheHeader header;
+		Append(&header, 1);
+	}
+
+	template<typename T>
+	void MeshCacheWriter::Append(const T* data, size_t count)
+	{
+		auto bytes = (const uint8_t*)data;
+		m_Data.insert(m_Data.end(), bytes, bytes + count * sizeof(T));
+	}
+
+	void MeshCacheWriter::AddMesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, const std::vector<texture>& textures, const Math::AABB& bounds)
+	{
+		MeshRecordHeader header = { (uint32_t)vertices.size(), (uint32_t)indices.size(), (uint32_t)textures.size(), bounds.Min, bounds.Max };
+		Append(&header, 1);
+		auto appendString = [&](const std::string& string) {
+			uint32_t length = (uint32_t)string.size();
+			Append(&length, 1);
+			Append(string.data(), string.size());
+			m_Data.resize(AlignTo4(m_Data.size()));
+		};
+		for (auto& texture : textures)
+		{
+			appendString(texture.type);
+			appendString(texture.path);
+		}
+		Append(vertices.data(), vertices.size());
+		Append(indices.data(), indices.size());
+		m_MeshCount++;
+	}
+
+	void MeshCacheWriter::Write(const std::string& sourcePath)
+	{
+		SN_PROFILE_FUNCTION();
+		((MeshCacheHeader*)m_Data.data())->MeshCount = m_MeshCount;
+
+		//Written under a temporary name, a reader never maps a partial file
+		std::filesystem::path path = MeshCache::GetCachePath(sourcePath);
+		auto temporaryPath = path;
+		temporaryPath += ".tmp";
+		{
+			std::ofstream out(temporaryPath, std::ios::out | std::ios::binary);
+			if (!out) {
+				SN_CORE_WARN("Could not write the mesh cache {0}", path.string());
+				return;
+			}
+			out.write((const char*)m_Data.data(), m_Data.size());
+		}
+		std::error_code error;
+		std::filesystem::rename(temporaryPath, path, error);
+		if (error) {
+			SN_CORE_WARN("Could not write the mesh cache {0}: {1}", path.string(), error.message());
+			std::filesystem::remove(temporaryPath, error);
+		}
+	}
+
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "Engine/Renderer/Mesh.h"
+#include "Engine/Utils/MappedFile.h"
+
+namespace Syndra {
+
+	//Meshes of an imported model, stored next to the source as <source>.snmesh so later loads skip Assimp.
+	//Each record holds the bounds, the texture references and the vertex and index data in their GPU layout.
+	class MeshCache
+	{
+	public:
+		static std::string GetCachePath(const std::string& sourcePath);
+	};
+
+	//One mesh of a cache file, the vertex and index pointers point into the mapped file
+	struct MeshCacheRecord
+	{
+		const Vertex* Vertices = nullptr;
+		uint32_t VertexCount = 0;
+		const uint32_t* Indices = nullptr;
+		uint32_t IndexCount = 0;
+		Math::AABB Bounds;
+		//Type and path of each texture, as found in the source
+		std::vector<std::pair<std::string, std::string>> Textures;
+	};
+
+	class MeshCacheReader
+	{
+	public:
+		//False when the cache is missing, older than the source or written by another version
+		bool Open(const std::string& sourcePath);
+		uint32_t GetMeshCount() const { return m_MeshCount; }
+		//Reads the records in order, false at the end or on a damaged file
+		bool Next(MeshCacheRecord& record);
+
+	private:
+		Scope<MappedFile> m_File;
+		size_t m_Offset = 0;
+		uint32_t m_MeshCount = 0;
+		uint32_t m_MeshIndex = 0;
+	};
+
+	//Collects the meshes while a model is imported
+	class MeshCacheWriter
+	{
+	public:
+		MeshCacheWriter();
+
+		void AddMesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, const std::vector<texture>& textures, const Math::AABB& bounds);
+		void Write(const std::string& sourcePath);
+
+	private:
+		template<typename T>
+		void Append(const T* data, size_t count);
+
+	private:
+		std::vector<uint8_t> m_Data;
+		uint32_t m_MeshCount = 0;
+	};
+
+}
@@ -1,15 +1,21 @@
 #include "lpch.h"
 #include "Engine/Renderer/Model.h"
+#include "Engine/Renderer/AssetManager.h"
 
 namespace Syndra {
 
-	Model::Model(std::string& path, bool gamma) :gammaCorrection(gamma)
+	Model::Model(const std::string& path, bool gamma) :gammaCorrection(gamma)
 	{
 		loadModel(path);
 	}
 
 	void Model::loadModel(std::string const& path)
 	{
+		SN_PROFILE_FUNCTION();
+		// retrieve the directory path of the filepath
+		directory = path.substr(0, path.find_last_of('\\'));
+		if (loadCachedModel(path))
+			return;
 		// read file via ASSIMP
 		Assimp::Importer importer;
 		const aiScene* scene = importer.ReadFile(path,aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
@@ -18,12 +24,44 @@ namespace Syndra {
 		if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) // if is Not Zero
 		{
 			SN_CORE_ERROR("ERROR::ASSIMP:: {0}", importer.GetErrorString());
+			m_Scene = nullptr;
 			return;
 		}
-		// retrieve the directory path of the filepath
-		directory = path.substr(0, path.find_last_of('\\'));
 		// process ASSIMP's root node recursively
+		MeshCacheWriter writer;
+		m_CacheWriter = &writer;
 		processNode(scene->mRootNode, scene);
+		m_CacheWriter = nullptr;
+		m_Scene = nullptr;
+		if (m_Cacheable)
+			writer.Write(path);
+	}
+
+	bool Model::loadCachedModel(std::string const& path)
+	{
+		MeshCacheReader reader;
+		if (!reader.Open(path))
+			return false;
+
+		std::vector<Mesh> cached;
+		cached.reserve(reader.GetMeshCount());
+		MeshCacheRecord record;
+		while (reader.Next(record))
+		{
+			std::vector<texture> textures;
+			for (auto& [type, texturePath] : record.Textures)
+				loadTexture(texturePath, type, textures);
+			cached.emplace_back(record.Vertices, record.VertexCount, record.Indices, record.IndexCount, std::move(textures), record.Bounds);
+		}
+		if (cached.size() != reader.GetMeshCount())
+		{
+			SN_CORE_WARN("Mesh cache of {0} is damaged, importing the source", path);
+			textures_loaded.clear();
+			syndraTextures.clear();
+			return false;
+		}
+		meshes = std::move(cached);
+		return true;
 	}
 
 	void Model::processNode(aiNode* node, const aiScene* scene)
@@ -50,6 +88,7 @@ namespace Syndra {
 		std::vector<Vertex> vertices;
 		std::vector<unsigned int> indices;
 		std::vector<texture> textures;
+		Math::AABB bounds;
 
 
 		// walk through each of the mesh's vertices
@@ -62,6 +101,7 @@ namespace Syndra {
 			vector.y = mesh->mVertices[i].y;
 			vector.z = mesh->mVertices[i].z;
 			vertex.Position = vector;
+			bounds.Expand(vector);
 			// normals
 			if (mesh->HasNormals())
 			{
@@ -121,8 +161,10 @@ namespace Syndra {
 		std::vector<texture> heightMaps = loadMaterialTextures(material, aiTextureType_AMBIENT, "texture_height");
 		textures.insert(textures.end(), heightMaps.begin(), heightMaps.end());
 
+		if (m_CacheWriter)
+			m_CacheWriter->AddMesh(vertices, indices, textures, bounds);
 		// return a mesh object created from the extracted mesh data
-		return Mesh(vertices, indices, textures);
+		return Mesh(vertices.data(), (uint32_t)vertices.size(), indices.data(), (uint32_t)indices.size(), std::move(textures), bounds);
 	}
 
 	std::vector<texture> Model::loadMaterialTextures(aiMaterial* mat, aiTextureType type, std::string typeName)
@@ -133,42 +175,44 @@ namespace Syndra {
 			aiString str;
 			mat->GetTexture(type, i, &str);
 			SN_CORE_TRACE(str.C_Str());
-			bool skip = false;
-			for (unsigned int j = 0; j < textures_loaded.size(); j++)
+			loadTexture(str.C_Str(), typeName, textures);
+		}
+		return textures;
+	}
+
+	void Model::loadTexture(const std::string& path, const std::string& typeName, std::vector<texture>& textures)
+	{
+		for (unsigned int j = 0; j < textures_loaded.size(); j++)
+		{
+			if (textures_loaded[j].path == path)
 			{
-				if (std::strcmp(textures_loaded[j].path.data(), str.C_Str()) == 0)
-				{
-					textures.push_back(textures_loaded[j]);
-					skip = true;
-					break;
-				}
-			}
-			if (!skip)
-			{   // if texture hasn't been loaded already, load it
-				texture texture;
-				std::string filename = str.C_Str();
-				filename = directory + '\\' + filename;
-				Ref<Texture2D> syndraTexture;
-				if (auto tex = m_Scene->GetEmbeddedTexture(str.C_Str())) {
-					auto width = tex->mWidth;
-					auto height = tex->mHeight;
-					syndraTexture = Texture2D::Create(width,height,reinterpret_cast<unsigned char*>(tex->pcData));
-				}
-				else
-				{
-					syndraTexture = Texture2D::Create(filename);
-				}
-				if (syndraTexture) {
-					syndraTextures.push_back(syndraTexture);
-					texture.id = syndraTexture->GetRendererID();
-					texture.type = typeName;
-					texture.path = str.C_Str();
-					textures.push_back(texture);
-					textures_loaded.push_back(texture); // add to loaded textures
-				}
+				textures.push_back(textures_loaded[j]);
+				return;
 			}
 		}
-		return textures;
+		// if texture hasn't been loaded already, load it
+		texture texture;
+		std::string filename = directory + '\\' + path;
+		Ref<Texture2D> syndraTexture;
+		const aiTexture* tex = m_Scene ? m_Scene->GetEmbeddedTexture(path.c_str()) : nullptr;
+		if (tex) {
+			auto width = tex->mWidth;
+			auto height = tex->mHeight;
+			syndraTexture = Texture2D::Create(width,height,reinterpret_cast<unsigned char*>(tex->pcData));
+			m_Cacheable = false;
+		}
+		else
+		{
+			syndraTexture = AssetManager::LoadTexture(filename);
+		}
+		if (syndraTexture) {
+			syndraTextures.push_back(syndraTexture);
+			texture.id = syndraTexture->GetRendererID();
+			texture.type = typeName;
+			texture.path = path;
+			textures.push_back(texture);
+			textures_loaded.push_back(texture); // add to loaded textures
+		}
 	}
 
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 #include "Engine/Renderer/Mesh.h"
 #include "Engine/Renderer/Texture.h"
+#include "Engine/Renderer/MeshCache.h"
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
@@ -17,14 +18,20 @@ namespace Syndra {
 		bool gammaCorrection;
 		Model() = default;
 		~Model() = default;
-		Model(std::string& path, bool gamma = false);
+		Model(const std::string& path, bool gamma = false);
 
 	private:
-		const aiScene* m_Scene;
+		const aiScene* m_Scene = nullptr;
+		//Set while importing with Assimp, collects the meshes for the mesh cache
+		MeshCacheWriter* m_CacheWriter = nullptr;
+		//Embedded textures are not kept in the mesh cache
+		bool m_Cacheable = true;
 		void loadModel(std::string const& path);
+		bool loadCachedModel(std::string const& path);
 		void processNode(aiNode* node, const aiScene* scene);
 		Mesh processMesh(aiMesh* mesh, const aiScene* scene);
 		std::vector<texture> loadMaterialTextures(aiMaterial* mat, aiTextureType type, std::string typeName);
+		void loadTexture(const std::string& path, const std::string& typeName, std::vector<texture>& textures);
 	};
 
 }
\ No newline at end of file
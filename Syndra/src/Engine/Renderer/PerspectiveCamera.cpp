@@ -21,6 +21,12 @@ namespace Syndra{
 		m_Projection = glm::perspective(glm::radians(m_FOV), m_AspectRatio, m_NearClip, m_FarClip);
 	}
 
+	glm::mat4 PerspectiveCamera::GetJitteredProjection(const glm::vec2& offset) const
+	{
+		//Applied after the projection, clip space is translated by offset * w so ndc moves by the offset
+		return glm::translate(glm::mat4(1.0f), glm::vec3(offset, 0.0f)) * m_Projection;
+	}
+
 	void PerspectiveCamera::UpdateView()
 	{
 		// m_Yaw = m_Pitch = 0.0f; // Lock the camera's rotation
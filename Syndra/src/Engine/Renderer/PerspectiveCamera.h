@@ -26,6 +26,9 @@ namespace Syndra {
 
 		const glm::mat4& GetViewMatrix() const { return m_ViewMatrix; }
 		glm::mat4 GetViewProjection() const { return m_Projection * m_ViewMatrix; }
+		//Projection moved by a sub pixel offset in ndc, the temporal resolve samples a different spot of each pixel every frame
+		glm::mat4 GetJitteredProjection(const glm::vec2& offset) const;
+		glm::mat4 GetJitteredViewProjection(const glm::vec2& offset) const { return GetJitteredProjection(offset) * m_ViewMatrix; }
 
 		glm::vec3 GetUpDirection() const;
 		glm::vec3 GetRightDirection() const;
@@ -38,13 +41,13 @@ namespace Syndra {
 
 		void SetYawPitch(float yaw, float pitch);
 
-		float GetFOV() { return m_FOV; }
+		float GetFOV() const { return m_FOV; }
 		void SetFov(float fov) { m_FOV = fov; UpdateProjection(); }
 
-		float GetNear() { return m_NearClip; }
+		float GetNear() const { return m_NearClip; }
 		void SetNearClip(float nearClip) { m_NearClip = nearClip; UpdateProjection(); }
 
-		float GetFar() { return m_FarClip; }
+		float GetFar() const { return m_FarClip; }
 		void SetFarClip(float farClip) { m_FarClip = farClip; UpdateProjection(); }
 	private:
 		void UpdateProjection();
@@ -16,6 +16,11 @@ namespace Syndra {
 			s_RendererAPI->SetViewport(x, y, width, height);
 		}
 
+		static void SetScissor(uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+		{
+			s_RendererAPI->SetScissor(x, y, width, height);
+		}
+
 		static void SetClearColor(const glm::vec4& color)
 		{
 			s_RendererAPI->SetClearColor(color);
@@ -26,16 +31,87 @@ namespace Syndra {
 			s_RendererAPI->Clear();
 		}
 
+		static void ClearColorBuffer()
+		{
+			s_RendererAPI->ClearColorBuffer();
+		}
+
 		static void DrawIndexed(const Ref<VertexArray>& vertexArray)
 		{
 			s_RendererAPI->DrawIndexed(vertexArray);
 		}
 
+		static void DrawIndexed(uint32_t indexCount, uint32_t firstIndex, uint32_t baseVertex)
+		{
+			s_RendererAPI->DrawIndexed(indexCount, firstIndex, baseVertex);
+		}
+
+		static void MultiDrawIndexedIndirect(uint32_t drawCount, uint64_t offset)
+		{
+			s_RendererAPI->MultiDrawIndexedIndirect(drawCount, offset);
+		}
+
 		static void SetState(RenderState stateID, bool on) 
 		{
 			s_RendererAPI->SetState(stateID, on);
 		}
 
+		static void SetDepthFunc(DepthFunc func)
+		{
+			s_RendererAPI->SetDepthFunc(func);
+		}
+
+		static void SetDepthMask(bool write)
+		{
+			s_RendererAPI->SetDepthMask(write);
+		}
+
+		static void SetColorMask(bool write)
+		{
+			s_RendererAPI->SetColorMask(write);
+		}
+
+		static void SetStencil(StencilFunc func, uint32_t reference, bool write)
+		{
+			s_RendererAPI->SetStencil(func, reference, write);
+		}
+
+		static void CopyDepth(const Ref<FrameBuffer>& source, const Ref<FrameBuffer>& destination)
+		{
+			s_RendererAPI->CopyDepth(source, destination);
+		}
+
+		static void CopyDepth(const Ref<FrameBuffer>& source, const Ref<FrameBuffer>& destination, uint32_t sourceX, uint32_t sourceY,
+			uint32_t destinationX, uint32_t destinationY, uint32_t width, uint32_t height)
+		{
+			s_RendererAPI->CopyDepth(source, destination, sourceX, sourceY, destinationX, destinationY, width, height);
+		}
+
+		static void CopyColor(const Ref<FrameBuffer>& source, const Ref<FrameBuffer>& destination)
+		{
+			s_RendererAPI->CopyColor(source, destination);
+		}
+
+		static void StorageBarrier()
+		{
+			s_RendererAPI->StorageBarrier();
+		}
+
+		static void InvalidateState()
+		{
+			s_RendererAPI->InvalidateState();
+		}
+
+		static RenderStateStats GetStateStats()
+		{
+			return s_RendererAPI->GetStateStats();
+		}
+
+		static void ResetStateStats()
+		{
+			s_RendererAPI->ResetStateStats();
+		}
+
 		static std::string GetInfo() 
 		{
 			return s_RendererAPI->GetRendererInfo();
@@ -0,0 +1,349 @@
+#include "lpch.h"
+#include "Engine/Renderer/RenderGraph.h"
+#include "Engine/Renderer/RenderCommand.h"
+
+#include <queue>
+#include <chrono>
+
+namespace Syndra {
+
+	//Two transient targets can share a framebuffer when their attachments match, the clear color does not matter
+	static bool IsCompatible(const FramebufferSpecification& a, const FramebufferSpecification& b)
+	{
+		if (a.Width != b.Width || a.Height != b.Height || a.Samples != b.Samples || a.Layers != b.Layers)
+			return false;
+		auto& first = a.Attachments.Attachments;
+		auto& second = b.Attachments.Attachments;
+		if (first.size() != second.size())
+			return false;
+		for (size_t i = 0; i < first.size(); i++)
+		{
+			if (first[i].TextureFormat != second[i].TextureFormat)
+				return false;
+		}
+		return true;
+	}
+
+	RenderGraphResource RenderGraph::Import(const std::string& name, const Ref<FrameBuffer>& frameBuffer)
+	{
+		Resource resource;
+		resource.Name = name;
+		resource.Specification = frameBuffer->GetSpecification();
+		resource.Imported = true;
+		resource.Target = frameBuffer;
+		m_Resources.push_back(resource);
+		m_Dirty = true;
+		return (RenderGraphResource)m_Resources.size() - 1;
+	}
+
+	RenderGraphResource RenderGraph::Create(const std::string& name, const FramebufferSpecification& spec, bool viewportSized)
+	{
+		Resource resource;
+		resource.Name = name;
+		resource.Specification = spec;
+		resource.ViewportSized = viewportSized;
+		m_Resources.push_back(resource);
+		m_Dirty = true;
+		return (RenderGraphResource)m_Resources.size() - 1;
+	}
+
+	void RenderGraph::AddPass(const RenderGraphPassSpecification& spec)
+	{
+		SN_CORE_ASSERT(spec.Target < m_Resources.size(), "Render graph passes need a target");
+		Pass pass;
+		pass.Specification = spec;
+		m_Passes.push_back(pass);
+		m_Dirty = true;
+	}
+
+	void RenderGraph::SetOutput(RenderGraphResource resource)
+	{
+		if (m_Output != resource) {
+			m_Output = resource;
+			m_Dirty = true;
+		}
+	}
+
+	void RenderGraph::Resize(uint32_t width, uint32_t height)
+	{
+		for (auto& resource : m_Resources)
+		{
+			if (resource.Imported) {
+				resource.Specification = resource.Target->GetSpecification();
+				continue;
+			}
+			if (resource.ViewportSized) {
+				resource.Specification.Width = width;
+				resource.Specification.Height = height;
+			}
+		}
+		m_Dirty = true;
+	}
+
+	void RenderGraph::SetSpecification(RenderGraphResource resource, const FramebufferSpecification& spec)
+	{
+		SN_CORE_ASSERT(!m_Resources[resource].Imported, "Imported framebuffers are changed by their owner");
+		m_Resources[resource].Specification = spec;
+		m_Dirty = true;
+	}
+
+	void RenderGraph::SetFrameBuffer(RenderGraphResource resource, const Ref<FrameBuffer>& frameBuffer)
+	{
+		SN_CORE_ASSERT(m_Resources[resource].Imported, "Transient framebuffers are owned by the graph");
+		m_Resources[resource].Target = frameBuffer;
+		m_Resources[resource].Specification = frameBuffer->GetSpecification();
+		m_Dirty = true;
+	}
+
+	Ref<FrameBuffer> RenderGraph::GetFrameBuffer(RenderGraphResource resource) const
+	{
+		return m_Resources[resource].Target;
+	}
+
+	const FramebufferSpecification& RenderGraph::GetSpecification(RenderGraphResource resource) const
+	{
+		return m_Resources[resource].Specification;
+	}
+
+	void RenderGraph::Compile()
+	{
+		SN_PROFILE_FUNCTION();
+		SN_CORE_ASSERT(m_Output != InvalidRenderGraphResource, "Render graph has no output");
+		auto sorted = SortPasses();
+		CullPasses(sorted);
+		ComputeLifetimes();
+		AssignFrameBuffers();
+
+		for (auto index : m_Order)
+		{
+			auto& pass = m_Passes[index];
+			RenderPassSpecification spec;
+			spec.TargetFrameBuffer = m_Resources[pass.Specification.Target].Target;
+			pass.TargetPass = RenderPass::Create(spec);
+		}
+		m_Dirty = false;
+	}
+
+	//Readers run after every writer of what they read, writers of the same target keep the order they were added in.
+	//Among passes that are ready, the one added first runs first.
+	std::vector<uint32_t> RenderGraph::SortPasses() const
+	{
+		size_t count = m_Passes.size();
+		std::vector<std::vector<uint32_t>> dependents(count);
+		std::vector<uint32_t> dependencies(count, 0);
+
+		auto addEdge = [&](uint32_t from, uint32_t to) {
+			dependents[from].push_back(to);
+			dependencies[to]++;
+		};
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			auto& spec = m_Passes[i].Specification;
+			for (uint32_t j = 0; j < count; j++)
+			{
+				if (i == j)
+					continue;
+				RenderGraphResource written = m_Passes[j].Specification.Target;
+				bool reads = std::find(spec.Reads.begin(), spec.Reads.end(), written) != spec.Reads.end() || spec.DepthSource == written;
+				bool sameTarget = spec.Target == written && j < i;
+				if (reads || sameTarget)
+					addEdge(j, i);
+			}
+		}
+
+		std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<uint32_t>> ready;
+		for (uint32_t i = 0; i < count; i++)
+		{
+			if (dependencies[i] == 0)
+				ready.push(i);
+		}
+
+		std::vector<uint32_t> order;
+		while (!ready.empty())
+		{
+			uint32_t index = ready.top();
+			ready.pop();
+			order.push_back(index);
+			for (auto dependent : dependents[index])
+			{
+				if (--dependencies[dependent] == 0)
+					ready.push(dependent);
+			}
+		}
+		SN_CORE_ASSERT(order.size() == count, "Render graph has a cycle");
+		return order;
+	}
+
+	//Walks back from the output, a pass is alive when something alive needs what it writes
+	void RenderGraph::CullPasses(const std::vector<uint32_t>& sorted)
+	{
+		std::vector<bool> needed(m_Resources.size(), false);
+		needed[m_Output] = true;
+
+		for (auto& pass : m_Passes)
+			pass.Alive = false;
+
+		for (auto it = sorted.rbegin(); it != sorted.rend(); ++it)
+		{
+			auto& pass = m_Passes[*it];
+			auto& spec = pass.Specification;
+			if (!needed[spec.Target])
+				continue;
+
+			pass.Alive = true;
+			if (spec.ClearsTarget)
+				needed[spec.Target] = false;
+			for (auto read : spec.Reads)
+				needed[read] = true;
+			if (spec.DepthSource != InvalidRenderGraphResource)
+				needed[spec.DepthSource] = true;
+		}
+
+		m_Order.clear();
+		for (auto index : sorted)
+		{
+			if (m_Passes[index].Alive)
+				m_Order.push_back(index);
+		}
+	}
+
+	void RenderGraph::ComputeLifetimes()
+	{
+		for (auto& resource : m_Resources)
+			resource.FirstUse = resource.LastUse = -1;
+
+		auto use = [&](RenderGraphResource handle, int32_t position) {
+			auto& resource = m_Resources[handle];
+			if (resource.FirstUse < 0)
+				resource.FirstUse = position;
+			resource.LastUse = position;
+		};
+
+		//Whether the last writer of a resource wrote through image stores
+		std::vector<bool> storageWritten(m_Resources.size(), false);
+		for (int32_t position = 0; position < (int32_t)m_Order.size(); position++)
+		{
+			auto& pass = m_Passes[m_Order[position]];
+			auto& spec = pass.Specification;
+
+			pass.NeedsBarrier = false;
+			for (auto read : spec.Reads)
+			{
+				use(read, position);
+				pass.NeedsBarrier |= storageWritten[read];
+			}
+			if (spec.DepthSource != InvalidRenderGraphResource) {
+				use(spec.DepthSource, position);
+				pass.NeedsBarrier |= storageWritten[spec.DepthSource];
+			}
+			use(spec.Target, position);
+			storageWritten[spec.Target] = spec.WritesStorage;
+		}
+
+		//The output is displayed after the frame
+		m_Resources[m_Output].LastUse = INT32_MAX;
+	}
+
+	void RenderGraph::AssignFrameBuffers()
+	{
+		std::vector<uint32_t> transients;
+		for (uint32_t i = 0; i < m_Resources.size(); i++)
+		{
+			auto& resource = m_Resources[i];
+			if (resource.Imported)
+				continue;
+			resource.Target = nullptr;
+			if (resource.FirstUse >= 0)
+				transients.push_back(i);
+		}
+		std::sort(transients.begin(), transients.end(), [&](uint32_t a, uint32_t b) {
+			return m_Resources[a].FirstUse < m_Resources[b].FirstUse;
+		});
+
+		for (auto& pooled : m_Pool)
+			pooled.LastUse = -1;
+		std::vector<bool> used(m_Pool.size(), false);
+
+		for (auto index : transients)
+		{
+			auto& resource = m_Resources[index];
+			PooledFrameBuffer* match = nullptr;
+			for (size_t i = 0; i < m_Pool.size(); i++)
+			{
+				auto& pooled = m_Pool[i];
+				if (pooled.LastUse < resource.FirstUse && IsCompatible(pooled.Target->GetSpecification(), resource.Specification)) {
+					match = &pooled;
+					used[i] = true;
+					break;
+				}
+			}
+			if (!match) {
+				m_Pool.push_back({ FrameBuffer::Create(resource.Specification), -1 });
+				used.push_back(true);
+				match = &m_Pool.back();
+			}
+			match->LastUse = resource.LastUse;
+			resource.Target = match->Target;
+		}
+
+		//Framebuffers nothing uses anymore (culled passes, old viewport size) are released
+		size_t kept = 0;
+		for (size_t i = 0; i < m_Pool.size(); i++)
+		{
+			if (used[i])
+				m_Pool[kept++] = m_Pool[i];
+		}
+		m_Pool.resize(kept);
+	}
+
+	void RenderGraph::Execute()
+	{
+		SN_PROFILE_FUNCTION();
+		if (m_Dirty)
+			Compile();
+
+		for (auto& pass : m_Passes)
+			pass.CPUTime = 0.0f;
+
+		Ref<RenderPass> last;
+		for (auto index : m_Order)
+		{
+			auto& pass = m_Passes[index];
+			auto& spec = pass.Specification;
+			auto& target = m_Resources[spec.Target].Target;
+			auto start = std::chrono::steady_clock::now();
+
+			//The depth copy and barrier are counted to the pass that needs them
+			SN_PROFILE_SCOPE(spec.Name.c_str());
+			if (m_Profiler)
+				m_Profiler->BeginPass(spec.Name);
+			if (spec.DepthSource != InvalidRenderGraphResource) {
+				auto& source = m_Resources[spec.DepthSource].Target;
+				if (source != target)
+					RenderCommand::CopyDepth(source, target);
+			}
+			if (pass.NeedsBarrier)
+				RenderCommand::StorageBarrier();
+
+			pass.TargetPass->BindTargetFrameBuffer();
+			spec.Execute(*this);
+			last = pass.TargetPass;
+			if (m_Profiler)
+				m_Profiler->EndPass();
+			pass.CPUTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+		}
+		if (last)
+			last->UnbindTargetFrameBuffer();
+	}
+
+	std::vector<std::pair<std::string, float>> RenderGraph::GetCPUTimes() const
+	{
+		std::vector<std::pair<std::string, float>> times;
+		times.reserve(m_Passes.size());
+		for (auto& pass : m_Passes)
+			times.emplace_back(pass.Specification.Name, pass.CPUTime);
+		return times;
+	}
+
+}
@@ -0,0 +1,113 @@
+#pragma once
+#include "Engine/Renderer/RenderPass.h"
+#include "Engine/Renderer/GPUProfiler.h"
+
+namespace Syndra {
+
+	using RenderGraphResource = uint32_t;
+	static constexpr RenderGraphResource InvalidRenderGraphResource = UINT32_MAX;
+
+	class RenderGraph;
+
+	struct RenderGraphPassSpecification
+	{
+		std::string Name;
+		//Render targets sampled by the pass
+		std::vector<RenderGraphResource> Reads;
+		RenderGraphResource Target = InvalidRenderGraphResource;
+		//Depth the target needs before the pass runs, copied only when it lives in another framebuffer
+		RenderGraphResource DepthSource = InvalidRenderGraphResource;
+		//The pass overwrites its whole target, earlier writes to it are not needed
+		bool ClearsTarget = false;
+		//The pass writes images or storage buffers, readers need a barrier
+		bool WritesStorage = false;
+		std::function<void(RenderGraph&)> Execute;
+	};
+
+	//Passes declare the render targets they read and write, the graph derives the execution order,
+	//culls passes that do not contribute to the output and backs transient targets with pooled
+	//framebuffers, targets whose lifetimes do not overlap share the same framebuffer.
+	class RenderGraph
+	{
+	public:
+		RenderGraph() = default;
+		~RenderGraph() = default;
+
+		//Framebuffers owned outside the graph, they keep their content between frames
+		RenderGraphResource Import(const std::string& name, const Ref<FrameBuffer>& frameBuffer);
+		//Framebuffers that only live during the frame, viewport sized ones follow Resize
+		RenderGraphResource Create(const std::string& name, const FramebufferSpecification& spec, bool viewportSized = true);
+
+		void AddPass(const RenderGraphPassSpecification& spec);
+		void SetOutput(RenderGraphResource resource);
+
+		void Resize(uint32_t width, uint32_t height);
+		//Changes the attachments or size of a transient target, it gets a new framebuffer when the graph compiles
+		void SetSpecification(RenderGraphResource resource, const FramebufferSpecification& spec);
+		//Replaces the framebuffer behind an imported resource
+		void SetFrameBuffer(RenderGraphResource resource, const Ref<FrameBuffer>& frameBuffer);
+
+		//Compiles the graph when it changed and runs the passes that are still alive
+		void Execute();
+		//Every pass is timed and labeled under its name
+		void SetProfiler(const Ref<GPUProfiler>& profiler) { m_Profiler = profiler; }
+
+		//Valid after the graph was compiled, nullptr for culled resources
+		Ref<FrameBuffer> GetFrameBuffer(RenderGraphResource resource) const;
+		//Pooled framebuffers are shared, the clear color of a resource is only kept here
+		const FramebufferSpecification& GetSpecification(RenderGraphResource resource) const;
+		RenderGraphResource GetOutput() const { return m_Output; }
+
+		uint32_t GetAlivePassCount() const { return (uint32_t)m_Order.size(); }
+		uint32_t GetPassCount() const { return (uint32_t)m_Passes.size(); }
+		uint32_t GetFrameBufferCount() const { return (uint32_t)m_Pool.size(); }
+		//CPU time of every pass in the last execution, in the order the passes were added
+		std::vector<std::pair<std::string, float>> GetCPUTimes() const;
+
+	private:
+		void Compile();
+		std::vector<uint32_t> SortPasses() const;
+		void CullPasses(const std::vector<uint32_t>& sorted);
+		void ComputeLifetimes();
+		void AssignFrameBuffers();
+
+	private:
+		struct Resource
+		{
+			std::string Name;
+			FramebufferSpecification Specification;
+			bool Imported = false;
+			bool ViewportSized = false;
+			Ref<FrameBuffer> Target;
+			//First and last position in the execution order using the resource
+			int32_t FirstUse = -1, LastUse = -1;
+		};
+
+		struct Pass
+		{
+			RenderGraphPassSpecification Specification;
+			Ref<RenderPass> TargetPass;
+			bool Alive = false;
+			bool NeedsBarrier = false;
+			//Milliseconds the CPU spent recording the pass in the last frame, 0 for culled passes
+			float CPUTime = 0.0f;
+		};
+
+		struct PooledFrameBuffer
+		{
+			Ref<FrameBuffer> Target;
+			int32_t LastUse = -1;
+		};
+
+		std::vector<Resource> m_Resources;
+		std::vector<Pass> m_Passes;
+		//Alive passes in execution order
+		std::vector<uint32_t> m_Order;
+		std::vector<PooledFrameBuffer> m_Pool;
+
+		RenderGraphResource m_Output = InvalidRenderGraphResource;
+		bool m_Dirty = true;
+		Ref<GPUProfiler> m_Profiler;
+	};
+
+}
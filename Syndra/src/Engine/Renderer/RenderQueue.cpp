@@ -0,0 +1,150 @@
+#include "lpch.h"
+#include "Engine/Renderer/RenderQueue.h"
+
+namespace Syndra {
+
+	void RenderQueue::Clear()
+	{
+		m_Packets.clear();
+		m_Sorted.clear();
+		m_Keys.clear();
+		m_MaterialIndices.clear();
+		m_TextureIndices.clear();
+		m_NextMaterialIndex = 0;
+		m_ShaderIndices.clear();
+		m_PoolIndices.clear();
+	}
+
+	void RenderQueue::Submit(RenderQueuePass pass, const Ref<Shader>& shader, Material* material, const Mesh& mesh,
+		const glm::mat4& transform, uint32_t entityID, float depth)
+	{
+		//Depth only passes do not care about materials
+		uint32_t materialIndex = m_DepthOnly || pass < RenderQueuePass::Geometry ? 0 : GetMaterialIndex(material, mesh);
+
+		RenderPacket packet;
+		SN_CORE_ASSERT(materialIndex <= 0xFFFF, "Too many materials for the render queue key");
+		uint32_t shaderIndex = GetIndex(m_ShaderIndices, shader->GetRendererID(), 12);
+		uint32_t poolIndex = GetIndex(m_PoolIndices, mesh.GetGeometryPool()->GetRendererID(), 16);
+		packet.Key = GenerateKey(pass, shaderIndex, materialIndex, poolIndex, depth);
+		packet.EntityID = entityID;
+		packet.InstanceKey = (uint64_t)(uintptr_t)mesh.GetGeometry().get();
+		packet.MeshData = &mesh;
+		packet.MaterialData = material;
+		packet.Transform = transform;
+
+		m_Keys.emplace_back(packet.Key, (uint32_t)m_Packets.size());
+		m_Packets.push_back(packet);
+	}
+
+	void RenderQueue::Sort()
+	{
+		RadixSort();
+
+		m_Sorted.resize(m_Packets.size());
+		for (size_t i = 0; i < m_Keys.size(); i++)
+		{
+			m_Sorted[i] = m_Packets[m_Keys[i].second];
+		}
+	}
+
+	const RenderPacket* RenderQueue::Begin(RenderQueuePass pass) const
+	{
+		auto it = std::lower_bound(m_Sorted.begin(), m_Sorted.end(), (uint64_t)pass << 60,
+			[](const RenderPacket& packet, uint64_t key) { return packet.Key < key; });
+		return m_Sorted.data() + (it - m_Sorted.begin());
+	}
+
+	const RenderPacket* RenderQueue::End(RenderQueuePass pass) const
+	{
+		//The next pass value would not fit in the key
+		if ((uint8_t)pass == 0xF)
+			return m_Sorted.data() + m_Sorted.size();
+		return Begin((RenderQueuePass)((uint8_t)pass + 1));
+	}
+
+	uint64_t RenderQueue::GenerateKey(RenderQueuePass pass, uint32_t shader, uint32_t material, uint32_t geometryPool, float depth)
+	{
+		uint64_t quantizedDepth = (uint64_t)(glm::clamp(depth, 0.0f, 1.0f) * 65535.0f);
+		return ((uint64_t)pass & 0xF) << 60
+			| ((uint64_t)shader & 0xFFF) << 48
+			| ((uint64_t)material & 0xFFFF) << 32
+			| ((uint64_t)geometryPool & 0xFFFF) << 16
+			| quantizedDepth;
+	}
+
+	uint32_t RenderQueue::GetIndex(std::unordered_map<uint32_t, uint32_t>& indices, uint32_t id, uint32_t bits)
+	{
+		auto it = indices.find(id);
+		if (it != indices.end())
+			return it->second;
+		uint32_t index = (uint32_t)indices.size();
+		SN_CORE_ASSERT(index < (1u << bits), "Render queue key field overflow");
+		return indices[id] = index;
+	}
+
+	uint32_t RenderQueue::GetMaterialIndex(Material* material, const Mesh& mesh)
+	{
+		if (material) {
+			auto it = m_MaterialIndices.find(material);
+			if (it != m_MaterialIndices.end())
+				return it->second;
+			return m_MaterialIndices[material] = ++m_NextMaterialIndex;
+		}
+
+		uint32_t diffuse = 0;
+		for (auto& texture : mesh.textures)
+		{
+			if (texture.type == "texture_diffuse")
+				diffuse = texture.id;
+		}
+		auto it = m_TextureIndices.find(diffuse);
+		if (it != m_TextureIndices.end())
+			return it->second;
+		return m_TextureIndices[diffuse] = ++m_NextMaterialIndex;
+	}
+
+	//LSD radix sort on the keys, one byte per pass. Bytes that are identical for
+	//every key (usually the high bits of a frame with a single shader) are skipped.
+	void RenderQueue::RadixSort()
+	{
+		size_t count = m_Keys.size();
+		if (count == 0)
+			return;
+		m_Scratch.resize(count);
+
+		uint32_t histograms[8][256] = {};
+		for (auto& key : m_Keys)
+		{
+			for (int byte = 0; byte < 8; byte++)
+				histograms[byte][(key.first >> (byte * 8)) & 0xFF]++;
+		}
+
+		auto* src = &m_Keys;
+		auto* dst = &m_Scratch;
+		for (int byte = 0; byte < 8; byte++)
+		{
+			auto& histogram = histograms[byte];
+			uint8_t first = (uint8_t)(((*src)[0].first >> (byte * 8)) & 0xFF);
+			if (histogram[first] == count)
+				continue;
+
+			uint32_t offsets[256];
+			uint32_t sum = 0;
+			for (int i = 0; i < 256; i++)
+			{
+				offsets[i] = sum;
+				sum += histogram[i];
+			}
+
+			for (auto& key : *src)
+			{
+				(*dst)[offsets[(key.first >> (byte * 8)) & 0xFF]++] = key;
+			}
+			std::swap(src, dst);
+		}
+
+		if (src != &m_Keys)
+			m_Keys.swap(m_Scratch);
+	}
+
+}
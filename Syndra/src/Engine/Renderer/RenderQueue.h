@@ -0,0 +1,86 @@
+#pragma once
+#include "Engine/Renderer/Mesh.h"
+#include "Engine/Renderer/Material.h"
+
+#include <glm/glm.hpp>
+
+namespace Syndra {
+
+	//Passes 0 to 3 are the static casters of the shadow cascades, 4 to 7 the dynamic ones
+	enum class RenderQueuePass : uint8_t
+	{
+		Shadow = 0, DynamicShadow = 4, Geometry = 8
+	};
+
+	struct RenderPacket
+	{
+		uint64_t Key;
+		uint32_t EntityID;
+		//The geometry allocation of the mesh, packets with the same key draw identical geometry and can be instanced
+		uint64_t InstanceKey;
+		const Mesh* MeshData;
+		//nullptr means the mesh is drawn with its imported textures
+		Material* MaterialData;
+		glm::mat4 Transform;
+	};
+
+	//Collects the draws of a frame and orders them by a 64 bit key so state changes
+	//(shader, material, geometry pool) only happen when the key actually changes.
+	//Key layout, from the most significant bit:
+	//| pass : 4 | shader : 12 | material : 16 | geometry pool : 16 | depth : 16 |
+	//Shaders, materials and pools are stored as dense per-frame indices, never as truncated GL names.
+	class RenderQueue
+	{
+	public:
+		//A depth only queue never looks up materials, whatever its pass numbers are
+		RenderQueue(bool depthOnly = false) :m_DepthOnly(depthOnly) {}
+		~RenderQueue() = default;
+
+		void Clear();
+
+		//depth should be normalized to [0, 1], nearer draws are sorted first
+		void Submit(RenderQueuePass pass, const Ref<Shader>& shader, Material* material, const Mesh& mesh,
+			const glm::mat4& transform, uint32_t entityID, float depth);
+
+		void Sort();
+
+		//Sorted packets of a single pass, valid after Sort()
+		const RenderPacket* Begin(RenderQueuePass pass) const;
+		const RenderPacket* End(RenderQueuePass pass) const;
+		const std::vector<RenderPacket>& GetSortedPackets() const { return m_Sorted; }
+
+		size_t Size() const { return m_Packets.size(); }
+
+		static uint64_t GenerateKey(RenderQueuePass pass, uint32_t shader, uint32_t material, uint32_t geometryPool, float depth);
+		static RenderQueuePass GetPass(uint64_t key) { return (RenderQueuePass)(key >> 60); }
+		static RenderQueuePass ShadowCascade(uint32_t cascade, bool dynamic)
+		{
+			return (RenderQueuePass)((uint8_t)(dynamic ? RenderQueuePass::DynamicShadow : RenderQueuePass::Shadow) + cascade);
+		}
+		static uint32_t GetMaterial(uint64_t key) { return (uint32_t)(key >> 32) & 0xFFFF; }
+
+	private:
+		uint32_t GetMaterialIndex(Material* material, const Mesh& mesh);
+		//Dense index of a GL object name, asserted to fit a key field of the given bit count
+		static uint32_t GetIndex(std::unordered_map<uint32_t, uint32_t>& indices, uint32_t id, uint32_t bits);
+		void RadixSort();
+
+	private:
+		bool m_DepthOnly;
+		std::vector<RenderPacket> m_Packets;
+		std::vector<RenderPacket> m_Sorted;
+
+		//(key, packet index) pairs, ping-ponged by the radix sort
+		std::vector<std::pair<uint64_t, uint32_t>> m_Keys;
+		std::vector<std::pair<uint64_t, uint32_t>> m_Scratch;
+
+		//Materials get a dense per-frame index so the key does not depend on pointer values.
+		//Draws without a material are grouped by the texture they are drawn with.
+		std::unordered_map<Material*, uint32_t> m_MaterialIndices;
+		std::unordered_map<uint32_t, uint32_t> m_TextureIndices;
+		uint32_t m_NextMaterialIndex = 0;
+		std::unordered_map<uint32_t, uint32_t> m_ShaderIndices;
+		std::unordered_map<uint32_t, uint32_t> m_PoolIndices;
+	};
+
+}
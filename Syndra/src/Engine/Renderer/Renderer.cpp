@@ -50,9 +50,9 @@ namespace Syndra {
 				//	number = std::to_string(heightNr++); // transfer unsigned int to stream
 			}
 
-			auto vertexArray = mesh.GetVertexArray();
-			vertexArray->Bind();
-			RenderCommand::DrawIndexed(vertexArray);
+			auto& geometry = mesh.GetGeometry();
+			mesh.BindVertexArray();
+			RenderCommand::DrawIndexed(geometry->GetIndexCount(), geometry->GetFirstIndex(), geometry->GetBaseVertex());
 		}
 	}
 
@@ -61,9 +61,9 @@ namespace Syndra {
 		material.Bind();
 		auto& meshes = model.meshes;
 		for (auto& mesh : meshes) {
-			auto vertexArray = mesh.GetVertexArray();
-			vertexArray->Bind();
-			RenderCommand::DrawIndexed(vertexArray);
+			auto& geometry = mesh.GetGeometry();
+			mesh.BindVertexArray();
+			RenderCommand::DrawIndexed(geometry->GetIndexCount(), geometry->GetFirstIndex(), geometry->GetBaseVertex());
 		}
 	}
 
@@ -1,15 +1,50 @@
 #pragma once
 #include <glm/glm.hpp>
 #include "Engine/Renderer/VertexArray.h"
+#include "Engine/Renderer/FrameBuffer.h"
 
 namespace Syndra {
 
+	//Matches the layout glMultiDrawElementsIndirect expects
+	struct DrawIndexedIndirectCommand
+	{
+		uint32_t IndexCount;
+		uint32_t InstanceCount;
+		uint32_t FirstIndex;
+		int32_t  BaseVertex;
+		uint32_t BaseInstance;
+	};
+
 	enum class RenderState
 	{
 		DEPTH_TEST,
 		BLEND,
 		CULL,
-		SRGB
+		SRGB,
+		SCISSOR,
+		STENCIL_TEST
+	};
+
+	enum class DepthFunc
+	{
+		LESS,
+		LEQUAL,
+		EQUAL,
+		ALWAYS
+	};
+
+	enum class StencilFunc
+	{
+		ALWAYS,
+		EQUAL,
+		NOTEQUAL
+	};
+
+	//Calls that reached the driver vs. calls dropped because the state was already set
+	struct RenderStateStats
+	{
+		uint32_t issued = 0;
+		uint32_t filtered = 0;
 	};
 
 	class RendererAPI {
@@ -25,10 +60,38 @@ namespace Syndra {
 
 		virtual void Init() = 0;
 		virtual void SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) = 0;
+		//Only used while RenderState::SCISSOR is on
+		virtual void SetScissor(uint32_t x, uint32_t y, uint32_t width, uint32_t height) = 0;
 		virtual void SetClearColor(const glm::vec4 & color) = 0;
+		//Clears color, depth and stencil
 		virtual void Clear() = 0;
+		//Clears the color attachments only, depth and stencil are kept
+		virtual void ClearColorBuffer() = 0;
 		virtual void DrawIndexed(const Ref<VertexArray>&vertexArray) = 0;
+		virtual void DrawIndexed(uint32_t indexCount, uint32_t firstIndex, uint32_t baseVertex) = 0;
+		//Draws from the indirect buffer that is currently bound, offset is in bytes
+		virtual void MultiDrawIndexedIndirect(uint32_t drawCount, uint64_t offset) = 0;
 		virtual void SetState(RenderState stateID, bool on) = 0;
+		virtual void SetDepthFunc(DepthFunc func) = 0;
+		//Depth and color writes are on by default, a pass turning them off turns them back on
+		virtual void SetDepthMask(bool write) = 0;
+		virtual void SetColorMask(bool write) = 0;
+		//Only used while RenderState::STENCIL_TEST is on, with write set fragments that pass store the reference
+		virtual void SetStencil(StencilFunc func, uint32_t reference, bool write) = 0;
+
+		virtual void CopyDepth(const Ref<FrameBuffer>& source, const Ref<FrameBuffer>& destination) = 0;
+		//Copies a width x height region of depth without scaling
+		virtual void CopyDepth(const Ref<FrameBuffer>& source, const Ref<FrameBuffer>& destination, uint32_t sourceX, uint32_t sourceY,
+			uint32_t destinationX, uint32_t destinationY, uint32_t width, uint32_t height) = 0;
+		//Copies the first color attachment, filtered when the sizes differ
+		virtual void CopyColor(const Ref<FrameBuffer>& source, const Ref<FrameBuffer>& destination) = 0;
+		//Makes image and storage buffer writes visible to the following draws
+		virtual void StorageBarrier() = 0;
+
+		//Forgets the tracked state, needed after something outside the renderer (ImGui) changed it
+		virtual void InvalidateState() = 0;
+		virtual RenderStateStats GetStateStats() = 0;
+		virtual void ResetStateStats() = 0;
 
 		virtual std::string GetRendererInfo() = 0;
 
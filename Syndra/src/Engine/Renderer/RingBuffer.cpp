@@ -0,0 +1,21 @@
+#include "lpch.h"
+#include "Engine/Renderer/RingBuffer.h"
+
+#include "Engine/Renderer/Renderer.h"
+#include "Platform/OpenGL/OpenGLRingBuffer.h"
+
+namespace Syndra {
+
+	Ref<RingBuffer> RingBuffer::Create(uint32_t regionSize, uint32_t regionCount)
+	{
+		switch (Renderer::GetAPI())
+		{
+		case RendererAPI::API::NONE:    SN_CORE_ASSERT(false, "RendererAPI::None is currently not supported!"); return nullptr;
+		case RendererAPI::API::OpenGL:  return CreateRef<OpenGLRingBuffer>(regionSize, regionCount);
+		}
+
+		SN_CORE_ASSERT(false, "Unknown RendererAPI!");
+		return nullptr;
+	}
+
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Engine/Core/Core.h"
+#include <cstring>
+
+namespace Syndra {
+
+	//A block of the ring buffer, Data stays writable until the region it lives in is reused
+	struct RingAllocation
+	{
+		void* Data = nullptr;
+		uint32_t Buffer = 0;
+		uint32_t Offset = 0;
+		uint32_t Size = 0;
+	};
+
+	//Per frame constants written straight into persistently mapped memory.
+	//The buffer is split in regions, one per frame in flight. A frame writes its region
+	//linearly and fences it at EndFrame, BeginFrame only waits when the GPU still reads
+	//the region that is about to be reused.
+	class RingBuffer
+	{
+	public:
+		virtual ~RingBuffer() {}
+
+		virtual void BeginFrame() = 0;
+		virtual void EndFrame() = 0;
+
+		//Allocations are aligned so they can be bound as uniform or storage buffer ranges
+		virtual RingAllocation Allocate(uint32_t size) = 0;
+		RingAllocation Upload(const void* data, uint32_t size)
+		{
+			auto allocation = Allocate(size);
+			memcpy(allocation.Data, data, size);
+			return allocation;
+		}
+
+		virtual void BindUniform(const RingAllocation& allocation, uint32_t binding) const = 0;
+		virtual void BindStorage(const RingAllocation& allocation, uint32_t binding) const = 0;
+		virtual void BindIndirect(const RingAllocation& allocation) const = 0;
+
+		virtual uint32_t GetRegionSize() const = 0;
+
+		static Ref<RingBuffer> Create(uint32_t regionSize, uint32_t regionCount = 3);
+	};
+
+}
@@ -11,7 +11,7 @@
 #include "Engine/Scene/Scene.h"
 
 #include "Engine/Utils/PoissonGenerator.h"
-#include <glad/glad.h>
+#include "Engine/Utils/Hash.h"
 
 namespace Syndra {
 
@@ -39,28 +39,845 @@ namespace Syndra {
 		sampler = Texture1D::Create(numSamples, &data[0]);
 	}
 
-	void SceneRenderer::Initialize()
+	//Packets sharing pass, shader, material and geometry pool form a bucket. Inside a bucket packets drawing the same
+	//geometry allocation become one indirect command whose instances are laid out contiguously in the instance buffer.
+	static void BuildBuckets(const RenderQueue& queue, RenderQueuePass pass, std::vector<SceneRenderer::DrawBucket>& buckets)
 	{
+		static std::unordered_map<uint64_t, uint32_t> groups;
+		static std::vector<std::vector<const RenderPacket*>> instances;
 
-		//------------------------------------------------Deferred Geometry Render Pass----------------------------------------//
-		FramebufferSpecification GeoFbSpec;
-		GeoFbSpec.Attachments =
-		{
-			FramebufferTextureFormat::RGBA16F,			// Position texture attachment
-			FramebufferTextureFormat::RGBA16F,			// Normal texture attachment
-			FramebufferTextureFormat::RGBA16F,			// Albedo texture attachment
-			FramebufferTextureFormat::RGBA16F,		    // Roughness-Metallic-AO texture attachment
-			FramebufferTextureFormat::RED_INTEGER,		// Entities ID texture attachment
-			FramebufferTextureFormat::DEPTH24STENCIL8	// default depth map
+		buckets.clear();
+		auto end = queue.End(pass);
+		auto first = queue.Begin(pass);
+		while (first != end)
+		{
+			auto last = first + 1;
+			while (last != end && (last->Key >> 16) == (first->Key >> 16))
+				last++;
+
+			//Groups keep the order of their first packet so the bucket stays roughly front to back
+			groups.clear();
+			uint32_t groupCount = 0;
+			for (auto packet = first; packet != last; packet++)
+			{
+				auto [it, inserted] = groups.try_emplace(packet->InstanceKey, groupCount);
+				if (inserted) {
+					if (instances.size() <= groupCount)
+						instances.resize(groupCount + 1);
+					instances[groupCount++].clear();
+				}
+				instances[it->second].push_back(&(*packet));
+			}
+
+			SceneRenderer::DrawBucket bucket = { (uint32_t)s_Data.drawCommands.size(), groupCount, &(*first) };
+			for (uint32_t group = 0; group < groupCount; group++)
+			{
+				auto& geometry = instances[group][0]->MeshData->GetGeometry();
+				DrawIndexedIndirectCommand command = { geometry->GetIndexCount(), (uint32_t)instances[group].size(),
+					geometry->GetFirstIndex(), (int32_t)geometry->GetBaseVertex(), (uint32_t)s_Data.instanceData.size() };
+				s_Data.drawCommands.push_back(command);
+				for (auto packet : instances[group])
+				{
+					SceneRenderer::InstanceData data;
+					data.transform = packet->Transform;
+					auto motion = s_Data.entityMotion.find(packet->EntityID);
+					data.previousTransform = motion != s_Data.entityMotion.end() ? motion->second.previousTransform : packet->Transform;
+					data.id = packet->EntityID;
+					s_Data.instanceData.push_back(data);
+				}
+			}
+			buckets.push_back(bucket);
+			first = last;
+		}
+	}
+
+	//bindState binds the shader and material state of the bucket
+	static void DrawBuckets(const std::vector<SceneRenderer::DrawBucket>& buckets, const std::function<void(const RenderPacket&)>& bindState)
+	{
+		for (auto& bucket : buckets)
+		{
+			bindState(*bucket.packet);
+			bucket.packet->MeshData->BindVertexArray();
+			RenderCommand::MultiDrawIndexedIndirect(bucket.commandCount, s_Data.drawCommandAllocation.Offset + bucket.firstCommand * sizeof(DrawIndexedIndirectCommand));
+			s_Data.drawStats.drawCalls++;
+			for (uint32_t i = 0; i < bucket.commandCount; i++)
+			{
+				auto& command = s_Data.drawCommands[bucket.firstCommand + i];
+				s_Data.drawStats.triangles += (uint64_t)command.IndexCount / 3 * command.InstanceCount;
+			}
+		}
+	}
+
+	//Splits the camera frustum up to the shadow distance, each cascade is fitted to the bounding sphere of its
+	//slice so its size does not change when the camera moves. The light view is a rotation only, the center is
+	//snapped to shadow map texels and the depth window to steps of the radius, see CascadePlacement.
+	static void UpdateCascades(const glm::vec3& direction)
+	{
+		auto& shadow = s_Data.shadowData;
+		float nearClip = s_Data.cameraNear;
+		float farClip = std::min(s_Data.shadowDistance, s_Data.cameraFar);
+		glm::mat4 inverseView = glm::inverse(s_Data.cameraView);
+		float tanX = 1.0f / s_Data.cameraProjection[0][0];
+		float tanY = 1.0f / s_Data.cameraProjection[1][1];
+		glm::vec3 lightDirection = glm::normalize(direction);
+		glm::vec3 up = glm::abs(lightDirection.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+		glm::mat4 lightView = glm::lookAt(glm::vec3(0.0f), lightDirection, up);
+
+		float splitNear = nearClip;
+		for (int i = 0; i < s_Data.cascadeCount; i++)
+		{
+			//Blend of uniform and logarithmic splits
+			float ratio = (i + 1) / (float)s_Data.cascadeCount;
+			float logSplit = nearClip * glm::pow(farClip / nearClip, ratio);
+			float uniformSplit = nearClip + (farClip - nearClip) * ratio;
+			float splitFar = glm::mix(uniformSplit, logSplit, s_Data.cascadeSplitLambda);
+
+			//Camera space corners, the radius then does not depend on where the camera is
+			glm::vec3 corners[8];
+			glm::vec3 center(0.0f);
+			for (int c = 0; c < 8; c++)
+			{
+				float depth = c < 4 ? splitNear : splitFar;
+				corners[c] = glm::vec3((c & 1 ? 1.0f : -1.0f) * tanX * depth, (c & 2 ? 1.0f : -1.0f) * tanY * depth, -depth);
+				center += corners[c];
+			}
+			center /= 8.0f;
+			float radius = 0.0f;
+			for (auto& corner : corners)
+				radius = std::max(radius, glm::length(corner - center));
+			radius = glm::ceil(radius * 16.0f) / 16.0f;
+
+			auto& placement = s_Data.cascadePlacements[i];
+			glm::vec3 lightCenter = glm::vec3(lightView * inverseView * glm::vec4(center, 1.0f));
+			float texel = 2.0f * radius / s_Data.shadowResolution;
+			float step = radius;
+			placement.view = lightView;
+			placement.radius = radius;
+			placement.origin = glm::ivec2(glm::round(glm::vec2(lightCenter) / texel));
+			placement.nearDepth = glm::floor((-lightCenter.z - radius - s_Data.casterDistance) / step) * step;
+			placement.farDepth = placement.nearDepth + 2.0f * radius + s_Data.casterDistance + step;
+
+			glm::vec2 origin = glm::vec2(placement.origin) * texel;
+			glm::mat4 projection = glm::ortho(origin.x - radius, origin.x + radius, origin.y - radius, origin.y + radius, placement.nearDepth, placement.farDepth);
+			shadow.cascadeViewProj[i] = projection * lightView;
+			shadow.cascadeSplits[i] = splitFar;
+			shadow.cascadeScales[i] = radius;
+			splitNear = splitFar;
+		}
+		for (int i = s_Data.cascadeCount - 1; i >= 0; i--)
+			shadow.cascadeScales[i] = shadow.cascadeScales[0] / shadow.cascadeScales[i];
+		shadow.cascadeCount = s_Data.cascadeCount;
+		shadow.cascadeBlend = s_Data.cascadeBlend;
+	}
+
+	static glm::vec4 EmptyRect()
+	{
+		return { FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX };
+	}
+
+	static glm::vec4 MergeRects(const glm::vec4& a, const glm::vec4& b)
+	{
+		return { std::min(a.x, b.x), std::min(a.y, b.y), std::max(a.z, b.z), std::max(a.w, b.w) };
+	}
+
+	//ndc footprint of a box in an orthographic cascade
+	static glm::vec4 LightSpaceRect(const Math::AABB& bounds, const glm::mat4& viewProj)
+	{
+		glm::vec4 rect = EmptyRect();
+		for (int c = 0; c < 8; c++)
+		{
+			glm::vec3 corner(c & 1 ? bounds.Max.x : bounds.Min.x, c & 2 ? bounds.Max.y : bounds.Min.y, c & 4 ? bounds.Max.z : bounds.Min.z);
+			glm::vec4 position = viewProj * glm::vec4(corner, 1.0f);
+			rect = MergeRects(rect, { position.x, position.y, position.x, position.y });
+		}
+		return rect;
+	}
+
+	//Changes when a caster moves or its model is replaced
+	static uint64_t CasterSignature(entt::entity entity, const glm::mat4& transform, const Mesh& mesh)
+	{
+		uint64_t hash = Hash::Combine(Hash::FNVOffset, transform);
+		hash = Hash::Combine(hash, (uintptr_t)&mesh);
+		return Hash::Combine(hash, entity);
+	}
+
+	//A caster that appeared or changed dirties where it was and where it is now
+	static void TrackStaticCaster(uint32_t cascade, uint64_t key, uint64_t signature, const Math::AABB& bounds)
+	{
+		auto& cache = s_Data.shadowCaches[cascade];
+		auto [it, inserted] = cache.casters.try_emplace(key);
+		auto& caster = it->second;
+		if (inserted || caster.signature != signature) {
+			glm::vec4 rect = LightSpaceRect(bounds, cache.viewProj);
+			cache.dirtyRects[0] = MergeRects(cache.dirtyRects[0], inserted ? rect : MergeRects(rect, caster.rect));
+			caster.signature = signature;
+			caster.rect = rect;
+		}
+		caster.frame = s_Data.frameIndex;
+	}
+
+	static bool IsEmpty(const glm::vec4& rect)
+	{
+		return rect.x > rect.z || rect.y > rect.w;
+	}
+
+	static bool IsDirty(const SceneRenderer::ShadowCache& cache)
+	{
+		for (auto& rect : cache.dirtyRects)
+		{
+			if (!IsEmpty(rect))
+				return true;
+		}
+		return false;
+	}
+
+	//Keeps the cache when the camera only moved the cascade origin: the content is shifted by the scroll and the
+	//columns and rows that came into view are marked dirty. Any other change redraws the whole cascade.
+	static void UpdateShadowCache(SceneRenderer::ShadowCache& cache, const SceneRenderer::CascadePlacement& placement, const glm::mat4& viewProj)
+	{
+		int resolution = s_Data.shadowResolution;
+		glm::ivec2 scroll = placement.origin - cache.placement.origin;
+		for (auto& rect : cache.dirtyRects)
+			rect = EmptyRect();
+		cache.scroll = glm::ivec2(0);
+
+		if (!cache.placement.SharesWindow(placement) || glm::abs(scroll.x) >= resolution || glm::abs(scroll.y) >= resolution) {
+			cache.valid = false;
+			cache.casters.clear();
+		}
+		else if (cache.valid && scroll != glm::ivec2(0))
+		{
+			cache.scroll = scroll;
+			glm::vec2 shift = glm::vec2(scroll) * 2.0f / (float)resolution;
+			for (auto& [key, caster] : cache.casters)
+				caster.rect -= glm::vec4(shift, shift);
+			if (scroll.x > 0)
+				cache.dirtyRects[1] = { 1.0f - shift.x, -1.0f, 1.0f, 1.0f };
+			else if (scroll.x < 0)
+				cache.dirtyRects[1] = { -1.0f, -1.0f, -1.0f - shift.x, 1.0f };
+			if (scroll.y > 0)
+				cache.dirtyRects[2] = { -1.0f, 1.0f - shift.y, 1.0f, 1.0f };
+			else if (scroll.y < 0)
+				cache.dirtyRects[2] = { -1.0f, -1.0f, 1.0f, -1.0f - shift.y };
+		}
+		cache.placement = placement;
+		cache.viewProj = viewProj;
+		if (!cache.valid)
+			cache.dirtyRects[0] = glm::vec4(-1.0f, -1.0f, 1.0f, 1.0f);
+	}
+
+	//Static casters are drawn into the cache only where they changed, the cache is then copied into the
+	//shadow map and dynamic casters are drawn on top. Cascades where nothing changed are left untouched.
+	static void ShadowPass(RenderGraph& graph)
+	{
+		RenderCommand::SetState(RenderState::DEPTH_TEST, true);
+		RenderCommand::SetClearColor(graph.GetSpecification(s_Data.shadowTarget).ClearColor);
+		auto& shadowMap = s_Data.shadowMap;
+		auto& staticShadowMap = s_Data.staticShadowMap;
+		float resolution = (float)shadowMap->GetSpecification().Width;
+		s_Data.depth->Bind();
+		for (int cascade = 0; cascade < s_Data.cascadeCount; cascade++)
+		{
+			auto& cache = s_Data.shadowCaches[cascade];
+			bool redraw = IsDirty(cache);
+			bool hasDynamicCasters = !s_Data.dynamicShadowBuckets[cascade].empty();
+			//Dynamic casters of the last frame have to be erased even if none are left
+			if (!redraw && !hasDynamicCasters && !cache.hadDynamicCasters)
+				continue;
+			cache.hadDynamicCasters = hasDynamicCasters;
+			s_Data.drawStats.shadowUpdates++;
+
+			s_Data.depth->Set(s_Data.depthView, cascade);
+			staticShadowMap->BindDepthLayer(cascade);
+			if (cache.scroll != glm::ivec2(0)) {
+				//Through the shadow map, a blit inside one texture may not overlap
+				s_Data.drawStats.staticScrolls++;
+				int size = (int)resolution;
+				glm::ivec2 source = glm::max(cache.scroll, glm::ivec2(0));
+				glm::ivec2 destination = glm::max(-cache.scroll, glm::ivec2(0));
+				shadowMap->BindDepthLayer(cascade);
+				RenderCommand::CopyDepth(staticShadowMap, shadowMap);
+				RenderCommand::CopyDepth(shadowMap, staticShadowMap, source.x, source.y, destination.x, destination.y,
+					size - glm::abs(cache.scroll.x), size - glm::abs(cache.scroll.y));
+			}
+			if (redraw) {
+				s_Data.drawStats.staticRedraws++;
+				staticShadowMap->Bind();
+				RenderCommand::SetState(RenderState::SCISSOR, true);
+				for (auto& dirtyRect : cache.dirtyRects)
+				{
+					if (IsEmpty(dirtyRect))
+						continue;
+					//One texel wider than the dirty region to cover rasterization
+					glm::vec4 rect = glm::clamp((dirtyRect * 0.5f + 0.5f) * resolution + glm::vec4(-1.0f, -1.0f, 1.0f, 1.0f), 0.0f, resolution);
+					uint32_t x = (uint32_t)glm::floor(rect.x), y = (uint32_t)glm::floor(rect.y);
+					RenderCommand::SetScissor(x, y, (uint32_t)glm::ceil(rect.z) - x, (uint32_t)glm::ceil(rect.w) - y);
+					RenderCommand::Clear();
+					DrawBuckets(s_Data.staticShadowBuckets[cascade], [](const RenderPacket& packet) {});
+				}
+				//The scissor would clip the copy as well
+				RenderCommand::SetState(RenderState::SCISSOR, false);
+				cache.valid = true;
+			}
+
+			shadowMap->BindDepthLayer(cascade);
+			RenderCommand::CopyDepth(staticShadowMap, shadowMap);
+			shadowMap->Bind();
+			DrawBuckets(s_Data.dynamicShadowBuckets[cascade], [](const RenderPacket& packet) {});
+		}
+	}
+
+	static FramebufferSpecification ShadowMapSpecification()
+	{
+		FramebufferSpecification shadowSpec;
+		shadowSpec.Attachments = { FramebufferTextureFormat::DEPTH32 };
+		shadowSpec.Width = s_Data.shadowResolution;
+		shadowSpec.Height = s_Data.shadowResolution;
+		shadowSpec.Layers = s_Data.cascadeCount;
+		shadowSpec.Samples = 1;
+		shadowSpec.ClearColor = { 0.0f, 0.0f, 0.0f, 1.0f };
+		return shadowSpec;
+	}
+
+	static void CreateShadowMaps()
+	{
+		auto spec = ShadowMapSpecification();
+		s_Data.shadowMap = FrameBuffer::Create(spec);
+		s_Data.staticShadowMap = FrameBuffer::Create(spec);
+		for (auto& cache : s_Data.shadowCaches)
+			cache = SceneRenderer::ShadowCache();
+	}
+
+	//View projections of a spot light cone or of the six cube faces of a point light
+	static void LocalShadowViews(const glm::vec3& position, const glm::vec3& direction, float range, float outerCutOff, uint32_t faces, glm::mat4* viewProj)
+	{
+		float nearClip = std::max(range * 0.001f, 0.05f);
+		if (faces == 1) {
+			glm::vec3 up = glm::abs(direction.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+			glm::mat4 projection = glm::perspective(glm::radians(std::min(2.0f * outerCutOff, 170.0f)), 1.0f, nearClip, range);
+			viewProj[0] = projection * glm::lookAt(position, position + direction, up);
+			return;
+		}
+		static const glm::vec3 directions[6] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+		static const glm::vec3 ups[6] = { { 0, -1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 }, { 0, -1, 0 }, { 0, -1, 0 } };
+		glm::mat4 projection = glm::perspective(glm::radians(90.0f), 1.0f, nearClip, range);
+		for (uint32_t face = 0; face < 6; face++)
+			viewProj[face] = projection * glm::lookAt(position, position + directions[face], ups[face]);
+	}
+
+	static void FreeLocalShadow(SceneRenderer::LocalShadow& shadow)
+	{
+		for (auto& tile : shadow.tiles)
+			s_Data.atlasAllocator->Free(tile);
+		shadow.tiles.clear();
+		shadow.tileSize = 0;
+		shadow.lastUpdate = 0;
+	}
+
+	//Smaller tiles are tried until the light fits, it stays unshadowed when even the smallest does not
+	static void AllocateLocalShadow(SceneRenderer::LocalShadow& shadow, uint32_t tileSize, uint32_t faces)
+	{
+		auto& atlas = *s_Data.atlasAllocator;
+		for (; tileSize >= atlas.GetMinTileSize(); tileSize /= 2)
+		{
+			ShadowAtlasTile tile;
+			while (shadow.tiles.size() < faces && atlas.Allocate(tileSize, tile))
+				shadow.tiles.push_back(tile);
+			if (shadow.tiles.size() == faces) {
+				shadow.tileSize = tileSize;
+				return;
+			}
+			FreeLocalShadow(shadow);
+		}
+	}
+
+	//World transform, bounds and caster signature of every mesh, the entity motion is advanced on the way
+	static void GatherMeshes()
+	{
+		s_Data.meshInstances.clear();
+		auto view = s_Data.scene->m_Registry.view<TransformComponent, MeshComponent>();
+		for (auto ent : view)
+		{
+			auto& mc = view.get<MeshComponent>(ent);
+			if (!mc.model)
+				continue;
+
+			Material* material = nullptr;
+			if (s_Data.scene->m_Registry.has<MaterialComponent>(ent)) {
+				material = &s_Data.scene->m_Registry.get<MaterialComponent>(ent).m_Material;
+			}
+
+			auto transform = view.get<TransformComponent>(ent).GetTransform();
+			auto& motion = s_Data.entityMotion[(uint32_t)ent];
+			bool tracked = motion.frame != 0 && motion.frame + 1 == s_Data.frameIndex;
+			motion.previousTransform = tracked ? motion.transform : transform;
+			motion.transform = transform;
+			motion.frame = s_Data.frameIndex;
+			for (size_t i = 0; i < mc.model->meshes.size(); i++)
+			{
+				auto& mesh = mc.model->meshes[i];
+				s_Data.meshInstances.push_back({ ent, &mesh, (uint32_t)i, material, mc.isStatic, transform,
+					mesh.bounds.Transform(transform), CasterSignature(ent, transform, mesh) });
+			}
+		}
+	}
+
+	//Shadowed point and spot lights in view get atlas tiles sized by how large they are on screen. Lights that moved
+	//or got new tiles are drawn first. Lights whose casters changed are drawn once they are older than their refresh
+	//interval, which grows as their tiles get smaller, and lights where nothing changed keep their tiles whatever
+	//their size. At most localShadowBudget tiles are drawn per frame.
+	static void UpdateLocalShadows()
+	{
+		struct Candidate
+		{
+			uint32_t key;
+			glm::vec3 position, direction;
+			float range, outerCutOff;
+			uint32_t faces, maxTileSize;
+			uint64_t signature, casterSignature;
+			float priority;
 		};
-		GeoFbSpec.Width = 1280;
-		GeoFbSpec.Height = 720;
-		GeoFbSpec.Samples = 1;
-		GeoFbSpec.ClearColor = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+		static std::vector<Candidate> candidates;
+		candidates.clear();
+
+		auto& atlas = *s_Data.atlasAllocator;
+		Math::Frustum cameraFrustum(s_Data.CameraBuffer.ViewProjection);
+		glm::vec3 cameraPos = glm::vec3(s_Data.CameraBuffer.position);
+		auto viewLights = s_Data.scene->m_Registry.view<TransformComponent, LightComponent>();
+		for (auto ent : viewLights)
+		{
+			auto& tc = viewLights.get<TransformComponent>(ent);
+			auto& lc = viewLights.get<LightComponent>(ent);
+			if (lc.type == LightType::Directional || !lc.light->GetCastShadows())
+				continue;
+
+			Candidate candidate = {};
+			candidate.key = (uint32_t)ent;
+			candidate.position = tc.Translation;
+			if (lc.type == LightType::Spot) {
+				auto p = dynamic_cast<SpotLight*>(lc.light.get());
+				candidate.direction = glm::normalize(p->GetDirection());
+				candidate.range = p->GetRange();
+				candidate.outerCutOff = p->GetOuterCutOff();
+				candidate.faces = 1;
+				candidate.maxTileSize = s_Data.maxLocalShadowTile;
+			}
+			else
+			{
+				candidate.range = dynamic_cast<PointLight*>(lc.light.get())->GetRange();
+				candidate.faces = 6;
+				//Six faces share the resolution a spot light gets from one tile
+				candidate.maxTileSize = std::max((uint32_t)s_Data.maxLocalShadowTile / 2, atlas.GetMinTileSize());
+			}
+			if (candidate.range <= 0.0f || !cameraFrustum.Intersects(Math::AABB(tc.Translation - candidate.range, tc.Translation + candidate.range)))
+				continue;
+
+			float values[] = { (float)candidate.faces, candidate.position.x, candidate.position.y, candidate.position.z,
+				candidate.direction.x, candidate.direction.y, candidate.direction.z, candidate.range, candidate.outerCutOff };
+			candidate.signature = Hash::FNV1a(values, sizeof(values));
+			s_Data.localShadows[candidate.key].frame = s_Data.frameIndex;
+			candidates.push_back(candidate);
+		}
+
+		//Meshes in a light's range, drawn with the transform and model they have now
+		for (auto& candidate : candidates)
+		{
+			Math::AABB range(candidate.position - candidate.range, candidate.position + candidate.range);
+			uint64_t hash = Hash::FNVOffset;
+			for (auto& instance : s_Data.meshInstances)
+			{
+				if (range.Intersects(instance.bounds))
+					hash = Hash::Combine(hash, instance.signature);
+			}
+			candidate.casterSignature = hash;
+		}
+
+		//Lights that were removed, turned off or left the view give their tiles back first
+		for (auto it = s_Data.localShadows.begin(); it != s_Data.localShadows.end();)
+		{
+			if (it->second.frame != s_Data.frameIndex) {
+				FreeLocalShadow(it->second);
+				it = s_Data.localShadows.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+
+		//Screen height of the light's range rounded up to a power of two, lights the camera is inside get the largest tiles
+		auto desiredTileSize = [&](const Candidate& candidate) {
+			float distance = glm::length(candidate.position - cameraPos);
+			float screenSize = distance > candidate.range ? candidate.range / distance * s_Data.cameraProjection[1][1] * s_Data.viewportHeight : FLT_MAX;
+			uint32_t tileSize = atlas.GetMinTileSize();
+			while (tileSize < candidate.maxTileSize && tileSize < screenSize)
+				tileSize *= 2;
+			return tileSize;
+		};
+		//Tiles that changed size are released before any are allocated, larger ones are placed first
+		std::sort(candidates.begin(), candidates.end(), [&](const Candidate& a, const Candidate& b) {
+			return desiredTileSize(a) * a.faces > desiredTileSize(b) * b.faces;
+		});
+		for (auto& candidate : candidates)
+		{
+			auto& shadow = s_Data.localShadows[candidate.key];
+			if (shadow.tiles.size() != candidate.faces || shadow.tileSize != desiredTileSize(candidate))
+				FreeLocalShadow(shadow);
+		}
+		for (auto& candidate : candidates)
+		{
+			auto& shadow = s_Data.localShadows[candidate.key];
+			if (shadow.tiles.empty())
+				AllocateLocalShadow(shadow, desiredTileSize(candidate), candidate.faces);
+		}
+
+		for (auto& candidate : candidates)
+		{
+			auto& shadow = s_Data.localShadows[candidate.key];
+			uint32_t age = s_Data.frameIndex - shadow.lastUpdate;
+			uint32_t interval = shadow.tileSize > 0 ? candidate.maxTileSize / shadow.tileSize : 0;
+			if (shadow.tiles.empty())
+				candidate.priority = -1.0f;
+			else if (shadow.lastUpdate == 0 || shadow.signature != candidate.signature)
+				candidate.priority = FLT_MAX;
+			else if (shadow.casterSignature != candidate.casterSignature)
+				candidate.priority = age >= interval ? (float)age / interval : -1.0f;
+			else
+				candidate.priority = -1.0f;
+		}
+		std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+			return a.priority > b.priority;
+		});
+
+		s_Data.localShadowUpdates.clear();
+		s_Data.shadowViews.resize(SceneRenderer::MaxCascades);
+		uint32_t budget = std::min((uint32_t)s_Data.localShadowBudget, SceneRenderer::MaxLocalShadowUpdates);
+		for (auto& candidate : candidates)
+		{
+			if (candidate.priority < 0.0f)
+				break;
+			if (s_Data.localShadowUpdates.size() + candidate.faces > budget)
+				continue;
+
+			auto& shadow = s_Data.localShadows[candidate.key];
+			LocalShadowViews(candidate.position, candidate.direction, candidate.range, candidate.outerCutOff, candidate.faces, shadow.viewProj);
+			float fov = candidate.faces == 1 ? std::min(2.0f * candidate.outerCutOff, 170.0f) : 90.0f;
+			//Two texels along the normal at unit distance
+			shadow.normalOffset = 4.0f * glm::tan(glm::radians(fov) * 0.5f) / shadow.tileSize;
+			shadow.signature = candidate.signature;
+			shadow.casterSignature = candidate.casterSignature;
+			shadow.lastUpdate = s_Data.frameIndex;
+			for (uint32_t face = 0; face < candidate.faces; face++)
+			{
+				s_Data.localShadowUpdates.push_back({ shadow.tiles[face], (uint32_t)s_Data.shadowViews.size(), candidate.position, candidate.range });
+				s_Data.shadowViews.push_back(shadow.viewProj[face]);
+			}
+		}
+
+		//Lights are looked up with the matrices their tiles were drawn with
+		s_Data.shadowTiles.clear();
+		float atlasSize = (float)atlas.GetSize();
+		for (auto& [key, shadow] : s_Data.localShadows)
+		{
+			shadow.tileIndex = -1;
+			if (shadow.tiles.empty() || shadow.lastUpdate == 0)
+				continue;
+			shadow.tileIndex = (int)s_Data.shadowTiles.size();
+			for (size_t face = 0; face < shadow.tiles.size(); face++)
+			{
+				auto& tile = shadow.tiles[face];
+				glm::vec4 rect(tile.X / atlasSize, tile.Y / atlasSize, tile.Size / atlasSize, shadow.normalOffset);
+				s_Data.shadowTiles.push_back({ shadow.viewProj[face], rect });
+			}
+		}
+		s_Data.drawStats.localShadows = (uint32_t)candidates.size();
+		s_Data.drawStats.localShadowUpdates = (uint32_t)s_Data.localShadowUpdates.size();
+	}
+
+	//Each tile drawn this frame is cleared and drawn through its own viewport, the rest of the atlas is kept
+	static void LocalShadowPass(RenderGraph& graph)
+	{
+		RenderCommand::SetState(RenderState::DEPTH_TEST, true);
+		RenderCommand::SetState(RenderState::SCISSOR, true);
+		s_Data.depth->Bind();
+		for (uint32_t update = 0; update < s_Data.localShadowUpdates.size(); update++)
+		{
+			auto& tile = s_Data.localShadowUpdates[update].tile;
+			RenderCommand::SetViewport(tile.X, tile.Y, tile.Size, tile.Size);
+			RenderCommand::SetScissor(tile.X, tile.Y, tile.Size, tile.Size);
+			RenderCommand::Clear();
+			s_Data.depth->Set(s_Data.depthView, (int)s_Data.localShadowUpdates[update].view);
+			DrawBuckets(s_Data.localShadowBuckets[update], [](const RenderPacket& packet) {});
+		}
+		RenderCommand::SetState(RenderState::SCISSOR, false);
+	}
+
+	static FramebufferSpecification GBufferSpecification(SceneRenderer::GBufferLayout layout, uint32_t width, uint32_t height)
+	{
+		FramebufferSpecification spec;
+		if (layout == SceneRenderer::GBufferLayout::Packed) {
+			spec.Attachments =
+			{
+				FramebufferTextureFormat::RG16,				// Octahedral normal
+				FramebufferTextureFormat::SRGB8_ALPHA8,		// Albedo
+				FramebufferTextureFormat::RGBA8,			// Roughness-Metallic-AO
+				FramebufferTextureFormat::RED_INTEGER,		// Entities ID
+				FramebufferTextureFormat::RG16F,			// Velocity
+				FramebufferTextureFormat::DEPTH24STENCIL8	// Depth, positions are rebuilt from it
+			};
+		}
+		else
+		{
+			spec.Attachments =
+			{
+				FramebufferTextureFormat::RGBA16F,			// Position texture attachment
+				FramebufferTextureFormat::RGBA16F,			// Normal texture attachment
+				FramebufferTextureFormat::RGBA16F,			// Albedo texture attachment
+				FramebufferTextureFormat::RGBA16F,		    // Roughness-Metallic-AO texture attachment
+				FramebufferTextureFormat::RED_INTEGER,		// Entities ID texture attachment
+				FramebufferTextureFormat::RG16F,			// Velocity texture attachment
+				FramebufferTextureFormat::DEPTH24STENCIL8	// default depth map
+			};
+		}
+		spec.Width = width;
+		spec.Height = height;
+		spec.Samples = 1;
+		spec.ClearColor = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+		return spec;
+	}
+
+	static uint32_t BytesPerPixel(const FramebufferSpecification& spec)
+	{
+		uint32_t bytes = 0;
+		for (auto& attachment : spec.Attachments.Attachments)
+			bytes += FramebufferTextureFormatSize(attachment.TextureFormat);
+		return bytes;
+	}
+
+	//Index of the normal target, albedo and material follow it
+	static uint32_t GBufferNormalAttachment()
+	{
+		return s_Data.gBufferLayout == SceneRenderer::GBufferLayout::Packed ? 0 : 1;
+	}
+
+	//The geometry and lighting shaders are compiled for the layout, materials keep their shader
+	static void UpdateGBufferShaders()
+	{
+		std::vector<std::string> defines;
+		if (s_Data.gBufferLayout == SceneRenderer::GBufferLayout::Packed)
+			defines.push_back("PACKED_GBUFFER");
+		s_Data.geoShader->SetDefines(defines);
+		s_Data.deferredLighting->SetDefines(defines);
+	}
+
+	static void SetGBufferLayout(SceneRenderer::GBufferLayout layout)
+	{
+		s_Data.gBufferLayout = layout;
+		auto& spec = s_Data.gBuffer->GetSpecification();
+		s_Data.gBuffer = FrameBuffer::Create(GBufferSpecification(layout, spec.Width, spec.Height));
+		s_Data.graph->SetFrameBuffer(s_Data.gBufferTarget, s_Data.gBuffer);
+		UpdateGBufferShaders();
+	}
+
+	//Screen space motion of every G-buffer texel, it follows the entity ID
+	static uint32_t GBufferVelocityAttachment()
+	{
+		return SceneRenderer::GetEntityIDAttachment() + 1;
+	}
+
+	//Radical inverse in the given base, the 2, 3 sequence spreads the jitter evenly over the pixel
+	static float Halton(uint32_t index, uint32_t base)
+	{
+		float result = 0.0f;
+		float fraction = 1.0f;
+		while (index > 0)
+		{
+			fraction /= base;
+			result += fraction * (index % base);
+			index /= base;
+		}
+		return result;
+	}
+
+	//The smoothed frame time moves the scale toward the target, pixel count and so fill cost follow the square of the scale.
+	//A moving editor camera drops to the moving scale, the temporal resolve hides it and refines the image once it stops.
+	static void UpdateRenderScale(float frameTime, bool cameraMoving)
+	{
+		s_Data.frameTime = s_Data.frameTime > 0.0f ? glm::mix(s_Data.frameTime, frameTime, 0.1f) : frameTime;
+		if (s_Data.antiAliasing != SceneRenderer::AntiAliasing::Temporal) {
+			//Without the resolve nothing upsamples the scaled image
+			s_Data.renderScale = 1.0f;
+			return;
+		}
+
+		float& scale = s_Data.dynamicScale;
+		if (s_Data.dynamicResolution && s_Data.frameTime > 0.0f) {
+			float ratio = s_Data.targetFrameTime / s_Data.frameTime;
+			if (ratio < 0.95f || ratio > 1.05f)
+				scale *= glm::clamp(glm::sqrt(ratio), 0.97f, 1.03f);
+		}
+		else
+		{
+			scale = s_Data.maxRenderScale;
+		}
+		scale = glm::clamp(scale, s_Data.minRenderScale, s_Data.maxRenderScale);
+
+		float applied = scale;
+		if (s_Data.lowerScaleWhileMoving && cameraMoving)
+			applied = std::min(applied, s_Data.movingRenderScale);
+		//Steps of 1/64 keep small frame time changes from resizing the drawn area every frame
+		s_Data.renderScale = glm::clamp(glm::round(applied * 64.0f) / 64.0f, 0.25f, 1.0f);
+	}
+
+	//The geometry, lighting and sky passes draw into the lower left part of their full size targets
+	static void SetRenderViewport()
+	{
+		RenderCommand::SetViewport(0, 0, s_Data.renderSize.x, s_Data.renderSize.y);
+	}
 
-		RenderPassSpecification GeoPassSpec;
-		GeoPassSpec.TargetFrameBuffer = FrameBuffer::Create(GeoFbSpec);
-		s_Data.geoPass = RenderPass::Create(GeoPassSpec);
+	static void GeometryPass(RenderGraph& graph)
+	{
+		SetRenderViewport();
+		RenderCommand::SetState(RenderState::DEPTH_TEST, true);
+		RenderCommand::SetClearColor(graph.GetSpecification(s_Data.gBufferTarget).ClearColor);
+		s_Data.gBuffer->ClearAttachment(SceneRenderer::GetEntityIDAttachment(), -1);
+		RenderCommand::Clear();
+		//Pixels covered by geometry get stencil 1, the lighting pass skips the rest
+		RenderCommand::SetState(RenderState::STENCIL_TEST, true);
+		RenderCommand::SetStencil(StencilFunc::ALWAYS, 1, true);
+		if (s_Data.useDepthPrepass) {
+			RenderCommand::SetColorMask(false);
+			s_Data.depthPrepass->Bind();
+			DrawBuckets(s_Data.geometryBuckets, [](const RenderPacket& packet) {});
+			RenderCommand::SetColorMask(true);
+			//Only the fragment that won the pre-pass is shaded
+			RenderCommand::SetDepthFunc(DepthFunc::EQUAL);
+			RenderCommand::SetDepthMask(false);
+		}
+		s_Data.geoShader->Bind();
+		DrawBuckets(s_Data.geometryBuckets, [](const RenderPacket& packet)
+		{
+			if (packet.MaterialData) {
+				packet.MaterialData->Bind();
+				return;
+			}
+			auto& shader = s_Data.geoShader;
+			auto& parameters = s_Data.geoParameters;
+			shader->Bind();
+			shader->Set(parameters.HasAlbedoMap, 1);
+			shader->Set(parameters.Tiling, 1.0f);
+			shader->Set(parameters.HasNormalMap, 0);
+			shader->Set(parameters.HasMetallicMap, 0);
+			shader->Set(parameters.HasRoughnessMap, 0);
+			shader->Set(parameters.HasAOMap, 0);
+			shader->Set(parameters.MetallicFactor, 0.0f);
+			shader->Set(parameters.RoughnessFactor, 1.0f);
+			shader->Set(parameters.AO, 1.0f);
+			packet.MeshData->BindTextures();
+		});
+		s_Data.geoShader->Unbind();
+		if (s_Data.useDepthPrepass) {
+			RenderCommand::SetDepthFunc(DepthFunc::LESS);
+			RenderCommand::SetDepthMask(true);
+		}
+		RenderCommand::SetStencil(StencilFunc::ALWAYS, 0, false);
+		RenderCommand::SetState(RenderState::STENCIL_TEST, false);
+	}
+
+	static void LightingPass(RenderGraph& graph)
+	{
+		SetRenderViewport();
+		RenderCommand::SetState(RenderState::DEPTH_TEST, false);
+		//Depth and stencil come from the G-buffer, sky pixels are left to the sky pass
+		RenderCommand::SetClearColor(graph.GetSpecification(s_Data.lightingTarget).ClearColor);
+		RenderCommand::ClearColorBuffer();
+		RenderCommand::SetState(RenderState::STENCIL_TEST, true);
+		RenderCommand::SetStencil(StencilFunc::EQUAL, 1, false);
+		s_Data.screenVao->Bind();
+
+		s_Data.deferredLighting->Bind();
+		//shadow map samplers
+		Texture2D::BindTexture(graph.GetFrameBuffer(s_Data.shadowTarget)->GetDepthAttachmentRendererID(), 3);
+		Texture1D::BindTexture(s_Data.distributionSampler0->GetRendererID(), 4);
+		Texture1D::BindTexture(s_Data.distributionSampler1->GetRendererID(), 5);
+		Texture2D::BindTexture(graph.GetFrameBuffer(s_Data.shadowAtlasTarget)->GetDepthAttachmentRendererID(), 10);
+
+		//Push constant variables
+		s_Data.deferredLighting->SetFloat("pc.size", s_Data.lightSize * 0.002f);
+		s_Data.deferredLighting->SetInt("pc.numPCFSamples", s_Data.numPCF);
+		s_Data.deferredLighting->SetInt("pc.numBlockerSearchSamples", s_Data.numBlocker);
+		s_Data.deferredLighting->SetInt("pc.softShadow", (int)s_Data.softShadow);
+		s_Data.deferredLighting->SetFloat("pc.exposure", s_Data.exposure);
+		s_Data.deferredLighting->SetFloat("pc.gamma", s_Data.gamma);
+		s_Data.deferredLighting->SetFloat("pc.intensity", s_Data.intensity);
+		//GBuffer samplers, the packed layout reads depth instead of positions
+		auto gBuffer = graph.GetFrameBuffer(s_Data.gBufferTarget);
+		uint32_t normal = GBufferNormalAttachment();
+		bool packed = s_Data.gBufferLayout == GBufferLayout::Packed;
+		Texture2D::BindTexture(packed ? gBuffer->GetDepthAttachmentRendererID() : gBuffer->GetColorAttachmentRendererID(0), 0);
+		Texture2D::BindTexture(gBuffer->GetColorAttachmentRendererID(normal), 1);
+		Texture2D::BindTexture(gBuffer->GetColorAttachmentRendererID(normal + 1), 2);
+		Texture2D::BindTexture(gBuffer->GetColorAttachmentRendererID(normal + 2), 6);
+		if (s_Data.environment) {
+			s_Data.environment->SetIntensity(s_Data.intensity);
+			s_Data.environment->BindIrradiance(4);
+			s_Data.environment->BindPreFilterMap(8);
+			s_Data.environment->BindBRDFMap(9);
+		}
+		Renderer::Submit(s_Data.deferredLighting, s_Data.screenVao);
+
+		s_Data.deferredLighting->Unbind();
+		RenderCommand::SetStencil(StencilFunc::ALWAYS, 0, false);
+		RenderCommand::SetState(RenderState::STENCIL_TEST, false);
+	}
+
+	static void SkyPass(RenderGraph& graph)
+	{
+		if (s_Data.environment) {
+			SetRenderViewport();
+			RenderCommand::SetState(RenderState::DEPTH_TEST, true);
+			RenderCommand::SetDepthFunc(DepthFunc::LEQUAL);
+			s_Data.environment->RenderBackground();
+			RenderCommand::SetDepthFunc(DepthFunc::LESS);
+		}
+	}
+
+	static void AntiAliasingPass(RenderGraph& graph)
+	{
+		auto& spec = graph.GetSpecification(s_Data.aaTarget);
+		s_Data.fxaa->Bind();
+		s_Data.fxaa->SetFloat("pc.width", (float)spec.Width);
+		s_Data.fxaa->SetFloat("pc.height", (float)spec.Height);
+		Texture2D::BindTexture(graph.GetFrameBuffer(s_Data.lightingTarget)->GetColorAttachmentRendererID(0), 0);
+		Renderer::Submit(s_Data.fxaa, s_Data.screenVao);
+		s_Data.fxaa->Unbind();
+	}
+
+	static void TemporalResolvePass(RenderGraph& graph)
+	{
+		auto gBuffer = graph.GetFrameBuffer(s_Data.gBufferTarget);
+		auto& resolve = s_Data.temporalResolve;
+		resolve->Bind();
+		resolve->SetFloat4("pc.scaleJitter", { s_Data.renderScale, s_Data.renderScale, s_Data.jitter.x, s_Data.jitter.y });
+		resolve->SetFloat("pc.feedback", s_Data.temporalFeedback);
+		resolve->SetInt("pc.historyValid", (int)s_Data.historyValid);
+		Texture2D::BindTexture(graph.GetFrameBuffer(s_Data.lightingTarget)->GetColorAttachmentRendererID(0), 0);
+		Texture2D::BindTexture(gBuffer->GetColorAttachmentRendererID(GBufferVelocityAttachment()), 1);
+		Texture2D::BindTexture(gBuffer->GetDepthAttachmentRendererID(), 2);
+		Texture2D::BindTexture(s_Data.temporalHistory->GetColorAttachmentRendererID(0), 3);
+		Renderer::Submit(resolve, s_Data.screenVao);
+		resolve->Unbind();
+
+		RenderCommand::CopyColor(graph.GetFrameBuffer(s_Data.temporalTarget), s_Data.temporalHistory);
+		s_Data.historyValid = true;
+	}
+
+	void SceneRenderer::Initialize()
+	{
+		SN_PROFILE_FUNCTION();
+		//------------------------------------------------Deferred Geometry Render Pass----------------------------------------//
+		//The editor reads entity IDs and the debug views read the G-buffer after the frame, so it is owned here
+		s_Data.gBuffer = FrameBuffer::Create(GBufferSpecification(s_Data.gBufferLayout, 1280, 720));
 
 		//-------------------------------------------Lighting and Post Processing Pass---------------------------//
 		FramebufferSpecification postProcFB;
@@ -70,23 +887,19 @@ namespace Syndra {
 		postProcFB.Samples = 1;
 		postProcFB.ClearColor = glm::vec4(0.196f, 0.196f, 0.196f, 1.0f);
 
-		RenderPassSpecification finalPassSpec;
-		finalPassSpec.TargetFrameBuffer = FrameBuffer::Create(postProcFB);
-		s_Data.lightingPass = RenderPass::Create(finalPassSpec);
-
 		//-----------------------------------------------Shadow Pass---------------------------------------------//
 
-		//Directional Light shadow map
-		FramebufferSpecification shadowSpec;
-		shadowSpec.Attachments = { FramebufferTextureFormat::DEPTH32 };
-		shadowSpec.Width = 4096;
-		shadowSpec.Height = 4096;
-		shadowSpec.Samples = 1;
-		shadowSpec.ClearColor = { 0.0f, 0.0f, 0.0f, 1.0f };
+		//Directional Light shadow cascades, one layer each, and the cache of their static casters
+		CreateShadowMaps();
 
-		RenderPassSpecification shadowPassSpec;
-		shadowPassSpec.TargetFrameBuffer = FrameBuffer::Create(shadowSpec);
-		s_Data.shadowPass = RenderPass::Create(shadowPassSpec);
+		//Point and spot light shadows, drawn into tiles of one depth texture
+		FramebufferSpecification atlasSpec;
+		atlasSpec.Attachments = { FramebufferTextureFormat::DEPTH32 };
+		atlasSpec.Width = s_Data.atlasResolution;
+		atlasSpec.Height = s_Data.atlasResolution;
+		atlasSpec.Samples = 1;
+		s_Data.shadowAtlas = FrameBuffer::Create(atlasSpec);
+		s_Data.atlasAllocator = CreateScope<ShadowAtlas>(s_Data.atlasResolution, 128);
 
 		//-----------------------------------------------Anti Aliasing------------------------------------------//
 		FramebufferSpecification aaFB;
@@ -96,9 +909,81 @@ namespace Syndra {
 		aaFB.Samples = 1;
 		aaFB.ClearColor = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
 
-		RenderPassSpecification aaPassSpec;
-		aaPassSpec.TargetFrameBuffer = FrameBuffer::Create(aaFB);
-		s_Data.aaPass = RenderPass::Create(aaPassSpec);
+		//Temporal output and history, half floats so the slow blend does not band
+		FramebufferSpecification temporalFB;
+		temporalFB.Attachments = { FramebufferTextureFormat::RGBA16F };
+		temporalFB.Width = 1280;
+		temporalFB.Height = 720;
+		temporalFB.Samples = 1;
+		s_Data.temporalOutput = FrameBuffer::Create(temporalFB);
+		s_Data.temporalHistory = FrameBuffer::Create(temporalFB);
+
+		//-----------------------------------------------Render Graph-------------------------------------------//
+		s_Data.graph = CreateRef<RenderGraph>();
+		s_Data.gpuProfiler = GPUProfiler::Create();
+		s_Data.graph->SetProfiler(s_Data.gpuProfiler);
+		auto& graph = *s_Data.graph;
+		s_Data.shadowTarget = graph.Import("Shadow map", s_Data.shadowMap);
+		s_Data.shadowAtlasTarget = graph.Import("Shadow atlas", s_Data.shadowAtlas);
+		s_Data.gBufferTarget = graph.Import("G-buffer", s_Data.gBuffer);
+		s_Data.lightingTarget = graph.Create("Lighting", postProcFB);
+		s_Data.aaTarget = graph.Create("Anti aliasing", aaFB);
+		s_Data.temporalTarget = graph.Import("Temporal resolve", s_Data.temporalOutput);
+
+		RenderGraphPassSpecification shadowPass;
+		shadowPass.Name = "Shadow";
+		shadowPass.Target = s_Data.shadowTarget;
+		shadowPass.ClearsTarget = true;
+		shadowPass.Execute = ShadowPass;
+		graph.AddPass(shadowPass);
+
+		//Only the tiles drawn this frame are cleared
+		RenderGraphPassSpecification localShadowPass;
+		localShadowPass.Name = "Local shadows";
+		localShadowPass.Target = s_Data.shadowAtlasTarget;
+		localShadowPass.Execute = LocalShadowPass;
+		graph.AddPass(localShadowPass);
+
+		RenderGraphPassSpecification geometryPass;
+		geometryPass.Name = "Geometry";
+		geometryPass.Target = s_Data.gBufferTarget;
+		geometryPass.ClearsTarget = true;
+		geometryPass.Execute = GeometryPass;
+		graph.AddPass(geometryPass);
+
+		RenderGraphPassSpecification lightingPass;
+		lightingPass.Name = "Lighting";
+		lightingPass.Reads = { s_Data.gBufferTarget, s_Data.shadowTarget, s_Data.shadowAtlasTarget };
+		lightingPass.Target = s_Data.lightingTarget;
+		lightingPass.DepthSource = s_Data.gBufferTarget;
+		lightingPass.ClearsTarget = true;
+		lightingPass.Execute = LightingPass;
+		graph.AddPass(lightingPass);
+
+		//Drawn over the lit image where the G-buffer depth copied by the lighting pass is empty
+		RenderGraphPassSpecification skyPass;
+		skyPass.Name = "Sky";
+		skyPass.Target = s_Data.lightingTarget;
+		skyPass.Execute = SkyPass;
+		graph.AddPass(skyPass);
+
+		RenderGraphPassSpecification aaPass;
+		aaPass.Name = "FXAA";
+		aaPass.Reads = { s_Data.lightingTarget };
+		aaPass.Target = s_Data.aaTarget;
+		aaPass.ClearsTarget = true;
+		aaPass.Execute = AntiAliasingPass;
+		graph.AddPass(aaPass);
+
+		RenderGraphPassSpecification temporalPass;
+		temporalPass.Name = "Temporal resolve";
+		temporalPass.Reads = { s_Data.lightingTarget, s_Data.gBufferTarget };
+		temporalPass.Target = s_Data.temporalTarget;
+		temporalPass.ClearsTarget = true;
+		temporalPass.Execute = TemporalResolvePass;
+		graph.AddPass(temporalPass);
+
+		graph.SetOutput(s_Data.lightingTarget);
 
 		//------------------------------------------------Shaders-----------------------------------------------//
 
@@ -110,15 +995,31 @@ namespace Syndra {
 			s_Data.shaders.Load("assets/shaders/main.glsl");
 			s_Data.shaders.Load("assets/shaders/DeferredLighting.glsl");
 			s_Data.shaders.Load("assets/shaders/GeometryPass.glsl");
+			s_Data.shaders.Load("assets/shaders/TemporalResolve.glsl");
 			//s_Data.shaders.Load("assets/shaders/mouse.glsl");
 			//s_Data.shaders.Load("assets/shaders/outline.glsl");
 		}
 		s_Data.depth = Shader::Create("assets/shaders/depth.glsl");
+		s_Data.depthView = s_Data.depth->GetParameter<int>("pc.view");
+		s_Data.depthPrepass = Shader::Create("assets/shaders/DepthPrepass.glsl");
 		s_Data.geoShader = s_Data.shaders.Get("GeometryPass");
 		s_Data.fxaa = s_Data.shaders.Get("FXAA");
 		s_Data.diffuse = s_Data.shaders.Get("diffuse");
 		s_Data.main = s_Data.shaders.Get("main");
 		s_Data.deferredLighting = s_Data.shaders.Get("DeferredLighting");
+		s_Data.temporalResolve = s_Data.shaders.Get("TemporalResolve");
+		UpdateGBufferShaders();
+
+		auto& geoParameters = s_Data.geoParameters;
+		geoParameters.HasAlbedoMap = s_Data.geoShader->GetParameter<int>("push.HasAlbedoMap");
+		geoParameters.HasNormalMap = s_Data.geoShader->GetParameter<int>("push.HasNormalMap");
+		geoParameters.HasMetallicMap = s_Data.geoShader->GetParameter<int>("push.HasMetallicMap");
+		geoParameters.HasRoughnessMap = s_Data.geoShader->GetParameter<int>("push.HasRoughnessMap");
+		geoParameters.HasAOMap = s_Data.geoShader->GetParameter<int>("push.HasAOMap");
+		geoParameters.Tiling = s_Data.geoShader->GetParameter<float>("push.tiling");
+		geoParameters.MetallicFactor = s_Data.geoShader->GetParameter<float>("push.material.MetallicFactor");
+		geoParameters.RoughnessFactor = s_Data.geoShader->GetParameter<float>("push.material.RoughnessFactor");
+		geoParameters.AO = s_Data.geoShader->GetParameter<float>("push.material.AO");
 
 		//----------------------------------------------SCREEN QUAD---------------------------------------------//
 		s_Data.screenVao = VertexArray::Create();
@@ -143,49 +1044,117 @@ namespace Syndra {
 		s_Data.screenVao->SetIndexBuffer(eb);
 
 		//----------------------------------------------Uniform BUffers---------------------------------------------//
-		//TODO Should be moved to a different class?
-		s_Data.CameraUniformBuffer = UniformBuffer::Create(sizeof(CameraData), 0);
+		//The environment irradiance (uniform binding 4) is owned by the environment.
+		//Camera (uniform binding 0), lights (2), shadow (3), draw commands, instance data (storage binding 0),
+		//light clusters (storage bindings 1 to 4), shadow views (5) and atlas tiles (6) are rewritten every frame
+		//into a triple buffered ring
+		s_Data.frameConstants = RingBuffer::Create(1024 * (sizeof(InstanceData) + sizeof(DrawIndexedIndirectCommand)) + 256 * 1024);
 
 		s_Data.exposure = 0.5f;
 		s_Data.gamma = 1.9f;
 		s_Data.lightSize = 1.0f;
-		s_Data.orthoSize = 20.0f;
-		s_Data.lightNear = 20.0f;
-		s_Data.lightFar = 200.0f;
 	
-		//Light uniform Buffer layout: -- point lights -- spotlights -- directional light--Binding point 2
-		s_Data.lightManager = CreateRef<LightManager>(2);
+		//Light grid and directional light: uniform binding 2
+		//Point lights, spot lights, cluster ranges and light indices: storage bindings 1 to 4
+		s_Data.lightManager = CreateRef<LightManager>(s_Data.frameConstants, 2, 1);
 
 		GeneratePoissonDisk(s_Data.distributionSampler0, 64);
 		GeneratePoissonDisk(s_Data.distributionSampler1, 64);
 
-		s_Data.deferredLighting->Bind();
-		s_Data.deferredLighting->SetFloat("pc.near", s_Data.lightNear);
-
 		s_Data.diffuse->Bind();
 		Texture1D::BindTexture(s_Data.distributionSampler0->GetRendererID(), 4);
 		Texture1D::BindTexture(s_Data.distributionSampler1->GetRendererID(), 5);
 		s_Data.diffuse->Unbind();
 
-		float dSize = s_Data.orthoSize;
-		s_Data.lightProj = glm::ortho(-dSize, dSize, -dSize, dSize, s_Data.lightNear, s_Data.lightFar);
-		//s_Data.lightProj = glm::perspective(45.0f, 1.0f, s_Data.lightNear, s_Data.lightFar);
-		s_Data.ShadowBuffer = UniformBuffer::Create(sizeof(glm::mat4)*25, 3);
 		s_Data.intensity = 1.0f;
 
 	}
 
+	//Dropping an environment while a worker still reads or writes its buffers would block the frame until the
+	//worker is done, it is kept aside instead
+	static void RetireEnvironment(Ref<Environment>& environment)
+	{
+		if (environment)
+			s_Data.retiredEnvironments.push_back(std::move(environment));
+		environment = nullptr;
+	}
+
+	static void LoadEnvironment(const std::string& path)
+	{
+		RetireEnvironment(s_Data.pendingEnvironment);
+		s_Data.pendingEnvironment = CreateRef<Environment>(path);
+	}
+
+	//Advances the environment that is loading and swaps it in between frames once it is baked
+	static void UpdateEnvironment()
+	{
+		auto& retired = s_Data.retiredEnvironments;
+		retired.erase(std::remove_if(retired.begin(), retired.end(), [](const Ref<Environment>& environment) { return environment->IsIdle(); }), retired.end());
+
+		if (s_Data.pendingEnvironment) {
+			s_Data.pendingEnvironment->Update();
+			if (s_Data.pendingEnvironment->IsReady()) {
+				RetireEnvironment(s_Data.environment);
+				s_Data.environment = std::move(s_Data.pendingEnvironment);
+			}
+			else if (!s_Data.pendingEnvironment->IsLoading())
+				RetireEnvironment(s_Data.pendingEnvironment);
+		}
+		//Writes the cache file of the last bake
+		if (s_Data.environment)
+			s_Data.environment->Update();
+	}
+
 	//Initializing camera, uniform buffers and environment map
-	void SceneRenderer::BeginScene(const PerspectiveCamera& camera)
+	void SceneRenderer::BeginScene(const PerspectiveCamera& camera, Timestep ts)
 	{
+		SN_PROFILE_FUNCTION();
+		UpdateEnvironment();
 		if (s_Data.environment)
 		{
 			s_Data.environment->SetViewProjection(camera.GetViewMatrix(), camera.GetProjection());
 		}
 
-		s_Data.CameraBuffer.ViewProjection = camera.GetViewProjection();
+		s_Data.gpuProfiler->BeginFrame();
+
+		//GPU time when the timers are on, V-Sync does not cap it like the frame delta
+		auto& gpuFrame = s_Data.gpuProfiler->GetFrameStats();
+		float frameTime = s_Data.gpuProfiler->IsEnabled() && gpuFrame.Samples > 0 ? gpuFrame.Last : ts.GetMilliseconds();
+		glm::mat4 viewProjection = camera.GetViewProjection();
+		bool cameraMoving = viewProjection != s_Data.CameraBuffer.UnjitteredViewProjection;
+		UpdateRenderScale(frameTime, cameraMoving);
+		s_Data.renderSize.x = std::max(1u, (uint32_t)glm::round(s_Data.viewportWidth * s_Data.renderScale));
+		s_Data.renderSize.y = std::max(1u, (uint32_t)glm::round(s_Data.viewportHeight * s_Data.renderScale));
+
+		//Sub pixel offsets of the drawn resolution, 8 frames of the Halton sequence
+		s_Data.jitter = glm::vec2(0.0f);
+		if (s_Data.antiAliasing == AntiAliasing::Temporal) {
+			s_Data.jitterIndex = (s_Data.jitterIndex + 1) % 8;
+			glm::vec2 sample(Halton(s_Data.jitterIndex + 1, 2), Halton(s_Data.jitterIndex + 1, 3));
+			s_Data.jitter = (sample - 0.5f) * 2.0f / glm::vec2(s_Data.renderSize);
+		}
+		else
+		{
+			s_Data.historyValid = false;
+		}
+
+		s_Data.CameraBuffer.PreviousViewProjection = s_Data.CameraBuffer.UnjitteredViewProjection;
+		s_Data.CameraBuffer.UnjitteredViewProjection = viewProjection;
+		s_Data.CameraBuffer.ViewProjection = camera.GetJitteredViewProjection(s_Data.jitter);
+		s_Data.CameraBuffer.InverseViewProjection = glm::inverse(s_Data.CameraBuffer.ViewProjection);
 		s_Data.CameraBuffer.position = glm::vec4(camera.GetPosition(), 0);
-		s_Data.CameraUniformBuffer->SetData(&s_Data.CameraBuffer, sizeof(CameraData));
+		s_Data.cameraForward = camera.GetForwardDirection();
+		s_Data.cameraView = camera.GetViewMatrix();
+		s_Data.cameraProjection = camera.GetProjection();
+		s_Data.cameraNear = camera.GetNear();
+		s_Data.cameraFar = camera.GetFar();
+		//ImGui and the panels change GL state between frames
+		RenderCommand::InvalidateState();
+		RenderCommand::ResetStateStats();
+
+		s_Data.frameConstants->BeginFrame();
+		auto& frameConstants = s_Data.frameConstants;
+		frameConstants->BindUniform(frameConstants->Upload(&s_Data.CameraBuffer, sizeof(CameraData)), 0);
 
 		s_Data.lightManager->IntitializeLights();
 		Renderer::BeginScene(camera);
@@ -193,190 +1162,200 @@ namespace Syndra {
 
 	void SceneRenderer::UpdateLights()
 	{
+		SN_PROFILE_FUNCTION();
+		s_Data.frameIndex++;
+		GatherMeshes();
+		UpdateLocalShadows();
+
 		auto viewLights = s_Data.scene->m_Registry.view<TransformComponent, LightComponent>();
-		//point light index
-		int pIndex = 0;
-		//spot light index
-		int sIndex = 0;
+		//No cascades are drawn or sampled without a directional light
+		s_Data.shadowData.cascadeCount = 0;
 		//Set light values for each entity that has a light component
 		for (auto ent : viewLights)
 		{
 			auto& tc = viewLights.get<TransformComponent>(ent);
 			auto& lc = viewLights.get<LightComponent>(ent);
+			auto shadow = s_Data.localShadows.find((uint32_t)ent);
+			int shadowIndex = shadow != s_Data.localShadows.end() ? shadow->second.tileIndex : -1;
 
 			if (lc.type == LightType::Directional) {
 				auto p = dynamic_cast<DirectionalLight*>(lc.light.get());
 				s_Data.lightManager->UpdateDirLight(p, tc.Translation);
 				//shadow
-				s_Data.lightView = glm::lookAt(-(glm::normalize(p->GetDirection()) * s_Data.lightFar / 4.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-				s_Data.shadowData.lightViewProj = s_Data.lightProj * s_Data.lightView;
-				s_Data.ShadowBuffer->SetData(&s_Data.shadowData, sizeof(glm::mat4));
+				UpdateCascades(p->GetDirection());
 				p = nullptr;
 			}
 			if (lc.type == LightType::Point) {
-				if (pIndex < 4) {
-					auto p = dynamic_cast<PointLight*>(lc.light.get());
-					s_Data.lightManager->UpdatePointLights(p, tc.Translation, pIndex);
-					pIndex++;
-					p = nullptr;
-				}
+				auto p = dynamic_cast<PointLight*>(lc.light.get());
+				s_Data.lightManager->AddPointLight(p, tc.Translation, shadowIndex);
+				p = nullptr;
 			}
 			if (lc.type == LightType::Spot) {
-				if (sIndex < 4) {
-					auto p = dynamic_cast<SpotLight*>(lc.light.get());
-					s_Data.lightManager->UpdateSpotLights(p, tc.Translation, sIndex);
-					sIndex++;
-					p = nullptr;
-				}
+				auto p = dynamic_cast<SpotLight*>(lc.light.get());
+				s_Data.lightManager->AddSpotLight(p, tc.Translation, shadowIndex);
+				p = nullptr;
 			}
 		}
 
-		//Filling light buffer data with different light values
-		s_Data.lightManager->UpdateBuffer();
+		//Bins the local lights into the camera clusters and fills the light buffers
+		s_Data.lightManager->UpdateBuffer(s_Data.cameraView, s_Data.cameraProjection, s_Data.cameraNear, s_Data.cameraFar);
+		auto& frameConstants = s_Data.frameConstants;
+		frameConstants->BindUniform(frameConstants->Upload(&s_Data.shadowData, sizeof(ShadowData)), 3);
+
+		//Views of the depth shader and atlas tiles of the lighting pass
+		for (int cascade = 0; cascade < s_Data.shadowData.cascadeCount; cascade++)
+			s_Data.shadowViews[cascade] = s_Data.shadowData.cascadeViewProj[cascade];
+		frameConstants->BindStorage(frameConstants->Upload(s_Data.shadowViews.data(), (uint32_t)(s_Data.shadowViews.size() * sizeof(glm::mat4))), 5);
+		auto tiles = frameConstants->Allocate((uint32_t)std::max(s_Data.shadowTiles.size() * sizeof(ShadowTile), (size_t)16));
+		if (!s_Data.shadowTiles.empty())
+			memcpy(tiles.Data, s_Data.shadowTiles.data(), s_Data.shadowTiles.size() * sizeof(ShadowTile));
+		frameConstants->BindStorage(tiles, 6);
 	}
 
 	void SceneRenderer::RenderScene()
 	{
-
+		SN_PROFILE_FUNCTION();
+		s_Data.drawStats = DrawStats();
 		UpdateLights();
 
-		auto view = s_Data.scene->m_Registry.view<TransformComponent, MeshComponent>();
-		//---------------------------------------------------------SHADOW PASS------------------------------------------//
-		s_Data.shadowPass->BindTargetFrameBuffer();
-		RenderCommand::SetState(RenderState::DEPTH_TEST, true);
-		RenderCommand::SetClearColor(s_Data.shadowPass->GetSpecification().TargetFrameBuffer->GetSpecification().ClearColor);
-		s_Data.depth->Bind();
-		RenderCommand::Clear();
-		for (auto ent : view)
+		//---------------------------------------------------------RENDER QUEUE-----------------------------------------//
+		s_Data.queue.Clear();
+		s_Data.localShadowQueue.Clear();
+		glm::vec3 cameraPos = glm::vec3(s_Data.CameraBuffer.position);
+		Math::Frustum cameraFrustum(s_Data.CameraBuffer.ViewProjection);
+		Math::Frustum cascadeFrusta[MaxCascades];
+		Math::Frustum localShadowFrusta[MaxLocalShadowUpdates];
+		for (size_t update = 0; update < s_Data.localShadowUpdates.size(); update++)
+			localShadowFrusta[update] = Math::Frustum(s_Data.shadowViews[s_Data.localShadowUpdates[update].view]);
+		for (int cascade = 0; cascade < s_Data.shadowData.cascadeCount; cascade++)
 		{
-			auto& tc = view.get<TransformComponent>(ent);
-			auto& mc = view.get<MeshComponent>(ent);
-			if (!mc.path.empty())
+			auto& viewProj = s_Data.shadowData.cascadeViewProj[cascade];
+			cascadeFrusta[cascade] = Math::Frustum(viewProj);
+
+			UpdateShadowCache(s_Data.shadowCaches[cascade], s_Data.cascadePlacements[cascade], viewProj);
+		}
+		for (auto& instance : s_Data.meshInstances)
+		{
+			auto& mesh = *instance.mesh;
+			auto& bounds = instance.bounds;
+			auto& transform = instance.transform;
+			uint32_t ent = (uint32_t)instance.entity;
+			const Ref<Shader>& shader = instance.material ? instance.material->GetShader() : s_Data.geoShader;
+			s_Data.drawStats.meshes++;
+			auto center = bounds.GetCenter();
+			uint64_t casterKey = (uint64_t)ent << 32 | instance.meshIndex;
+
+			//Front to back from the light and from the camera
+			bool castsShadow = false;
+			for (int cascade = 0; cascade < s_Data.shadowData.cascadeCount; cascade++)
+			{
+				if (!cascadeFrusta[cascade].Intersects(bounds))
+					continue;
+				if (instance.isStatic)
+					TrackStaticCaster(cascade, casterKey, instance.signature, bounds);
+				auto& placement = s_Data.cascadePlacements[cascade];
+				float lightDepth = (-(placement.view * glm::vec4(center, 1.0f)).z - placement.nearDepth) / (placement.farDepth - placement.nearDepth);
+				s_Data.queue.Submit(RenderQueue::ShadowCascade(cascade, !instance.isStatic), s_Data.depth, nullptr, mesh, transform, ent, lightDepth);
+				castsShadow = true;
+			}
+			if (!castsShadow)
+				s_Data.drawStats.shadowCulled++;
+
+			for (uint32_t update = 0; update < s_Data.localShadowUpdates.size(); update++)
 			{
-				s_Data.depth->SetMat4("transform.u_trans", tc.GetTransform());
-				SceneRenderer::RenderEntity(ent, mc, s_Data.depth);
+				if (!localShadowFrusta[update].Intersects(bounds))
+					continue;
+				auto& local = s_Data.localShadowUpdates[update];
+				float lightDepth = glm::length(center - local.lightPosition) / local.range;
+				s_Data.localShadowQueue.Submit((RenderQueuePass)update, s_Data.depth, nullptr, mesh, transform, ent, lightDepth);
+			}
+
+			if (cameraFrustum.Intersects(bounds)) {
+				float cameraDepth = glm::dot(center - cameraPos, s_Data.cameraForward) / s_Data.cameraFar;
+				s_Data.queue.Submit(RenderQueuePass::Geometry, shader, instance.material, mesh, transform, ent, cameraDepth);
+			}
+			else
+			{
+				s_Data.drawStats.cameraCulled++;
 			}
 		}
-		s_Data.shadowPass->UnbindTargetFrameBuffer();
+		s_Data.queue.Sort();
+		s_Data.localShadowQueue.Sort();
 
-		//--------------------------------------------------GEOMETRY PASS----------------------------------------------//
-		s_Data.geoPass->BindTargetFrameBuffer();
-		RenderCommand::SetState(RenderState::DEPTH_TEST, true);
-		RenderCommand::SetClearColor(s_Data.geoPass->GetSpecification().TargetFrameBuffer->GetSpecification().ClearColor);
-		s_Data.geoPass->GetSpecification().TargetFrameBuffer->ClearAttachment(4, -1);
-		s_Data.geoShader->Bind();
-		RenderCommand::Clear();
-		for (auto ent : view)
+		//Static casters that were removed or left the cascade dirty where they were
+		for (int cascade = 0; cascade < s_Data.shadowData.cascadeCount; cascade++)
 		{
-			auto& tc = view.get<TransformComponent>(ent);
-			auto& mc = view.get<MeshComponent>(ent);
-			if (!mc.path.empty())
+			auto& cache = s_Data.shadowCaches[cascade];
+			for (auto it = cache.casters.begin(); it != cache.casters.end();)
 			{
-				if (s_Data.scene->m_Registry.has<MaterialComponent>(ent)) {
-					auto& mat = s_Data.scene->m_Registry.get<MaterialComponent>(ent);
-					s_Data.geoShader->SetInt("transform.id", (uint32_t)ent);
-					s_Data.geoShader->SetMat4("transform.u_trans", tc.GetTransform());
-					SceneRenderer::RenderEntity(ent, mc, mat);
+				if (it->second.frame != s_Data.frameIndex) {
+					cache.dirtyRects[0] = MergeRects(cache.dirtyRects[0], it->second.rect);
+					it = cache.casters.erase(it);
 				}
 				else
 				{
-					s_Data.geoShader->SetInt("push.HasAlbedoMap", 1);
-					s_Data.geoShader->SetFloat("push.tiling", 1.0f);
-					s_Data.geoShader->SetInt("push.HasNormalMap", 0);
-					s_Data.geoShader->SetInt("push.HasMetallicMap", 0);
-					s_Data.geoShader->SetInt("push.HasRoughnessMap", 0);
-					s_Data.geoShader->SetInt("push.HasAOMap", 0);
-					s_Data.geoShader->SetFloat("push.material.MetallicFactor", 0);
-					s_Data.geoShader->SetFloat("push.material.RoughnessFactor", 1);
-					s_Data.geoShader->SetFloat("push.material.AO", 1);
-					s_Data.geoShader->SetMat4("transform.u_trans", tc.GetTransform());
-					s_Data.geoShader->SetInt("transform.id", (uint32_t)ent);
-					SceneRenderer::RenderEntity(ent, mc, s_Data.geoShader);
+					++it;
 				}
 			}
 		}
-		s_Data.geoShader->Unbind();
-		s_Data.geoPass->UnbindTargetFrameBuffer();
+
+		s_Data.drawCommands.clear();
+		s_Data.instanceData.clear();
+		for (uint32_t cascade = 0; cascade < MaxCascades; cascade++)
+		{
+			//Static casters are only drawn when their cache is redrawn
+			if (IsDirty(s_Data.shadowCaches[cascade]))
+				BuildBuckets(s_Data.queue, RenderQueue::ShadowCascade(cascade, false), s_Data.staticShadowBuckets[cascade]);
+			else
+				s_Data.staticShadowBuckets[cascade].clear();
+			BuildBuckets(s_Data.queue, RenderQueue::ShadowCascade(cascade, true), s_Data.dynamicShadowBuckets[cascade]);
+		}
+		for (uint32_t update = 0; update < MaxLocalShadowUpdates; update++)
+			BuildBuckets(s_Data.localShadowQueue, (RenderQueuePass)update, s_Data.localShadowBuckets[update]);
+		BuildBuckets(s_Data.queue, RenderQueuePass::Geometry, s_Data.geometryBuckets);
+		s_Data.drawStats.drawCommands = (uint32_t)s_Data.drawCommands.size();
+		s_Data.drawStats.instances = (uint32_t)s_Data.instanceData.size();
+		if (!s_Data.drawCommands.empty()) {
+			auto& frameConstants = s_Data.frameConstants;
+			s_Data.drawCommandAllocation = frameConstants->Upload(s_Data.drawCommands.data(), (uint32_t)(s_Data.drawCommands.size() * sizeof(DrawIndexedIndirectCommand)));
+			frameConstants->BindIndirect(s_Data.drawCommandAllocation);
+			frameConstants->BindStorage(frameConstants->Upload(s_Data.instanceData.data(), (uint32_t)(s_Data.instanceData.size() * sizeof(InstanceData))), 0);
+		}
+
+		//Entities that were removed or lost their mesh
+		for (auto it = s_Data.entityMotion.begin(); it != s_Data.entityMotion.end();)
+		{
+			if (it->second.frame != s_Data.frameIndex)
+				it = s_Data.entityMotion.erase(it);
+			else
+				++it;
+		}
+
+		//Shadow, local shadow, geometry, lighting, sky and anti aliasing passes
+		RenderGraphResource output = s_Data.lightingTarget;
+		if (s_Data.antiAliasing == AntiAliasing::FXAA)
+			output = s_Data.aaTarget;
+		else if (s_Data.antiAliasing == AntiAliasing::Temporal)
+			output = s_Data.temporalTarget;
+		s_Data.graph->SetOutput(output);
+		s_Data.graph->Execute();
 	}
 
 	void SceneRenderer::RenderEntity(const entt::entity& entity, MeshComponent& mc, const Ref<Shader>& shader)
 	{
 		//RenderCommand::SetState(RenderState::CULL, false);
-		Renderer::Submit(shader, mc.model);
+		Renderer::Submit(shader, *mc.model);
 		//RenderCommand::SetState(RenderState::CULL, true);
 	}
 
 	void SceneRenderer::RenderEntity(const entt::entity& entity, MeshComponent& mc, MaterialComponent& mat)
 	{
-		Renderer::Submit(mat.m_Material, mc.model);
+		Renderer::Submit(mat.m_Material, *mc.model);
 	}
 
 	void SceneRenderer::EndScene()
 	{
-		//-------------------------------------------------Lighting and post-processing pass---------------------------------------------------//
-
-		s_Data.lightingPass->BindTargetFrameBuffer();
-
-		RenderCommand::SetState(RenderState::DEPTH_TEST, false);
-		s_Data.screenVao->Bind();
-
-		s_Data.deferredLighting->Bind();
-		//shadow map samplers
-		Texture2D::BindTexture(s_Data.shadowPass->GetSpecification().TargetFrameBuffer->GetDepthAttachmentRendererID(), 3);
-		Texture1D::BindTexture(s_Data.distributionSampler0->GetRendererID(), 4);
-		Texture1D::BindTexture(s_Data.distributionSampler1->GetRendererID(), 5);
-
-		//Push constant variables
-		s_Data.deferredLighting->SetFloat("pc.size", s_Data.lightSize * 0.0001f);
-		s_Data.deferredLighting->SetInt("pc.numPCFSamples", s_Data.numPCF);
-		s_Data.deferredLighting->SetInt("pc.numBlockerSearchSamples", s_Data.numBlocker);
-		s_Data.deferredLighting->SetInt("pc.softShadow", (int)s_Data.softShadow);
-		s_Data.deferredLighting->SetFloat("pc.exposure", s_Data.exposure);
-		s_Data.deferredLighting->SetFloat("pc.gamma", s_Data.gamma);
-		s_Data.deferredLighting->SetFloat("pc.near", s_Data.lightNear);
-		s_Data.deferredLighting->SetFloat("pc.intensity", s_Data.intensity);
-		//GBuffer samplers
-		Texture2D::BindTexture(s_Data.geoPass->GetFrameBufferTextureID(0), 0);
-		Texture2D::BindTexture(s_Data.geoPass->GetFrameBufferTextureID(1), 1);
-		Texture2D::BindTexture(s_Data.geoPass->GetFrameBufferTextureID(2), 2);
-		Texture2D::BindTexture(s_Data.geoPass->GetFrameBufferTextureID(3), 6);
-		if (s_Data.environment) {
-			s_Data.environment->SetIntensity(s_Data.intensity);
-			s_Data.environment->BindIrradianceMap(7);
-			s_Data.environment->BindPreFilterMap(8);
-			s_Data.environment->BindBRDFMap(9);
-		}
-		Renderer::Submit(s_Data.deferredLighting, s_Data.screenVao);
-
-		s_Data.deferredLighting->Unbind();
-
-		s_Data.lightingPass->BindTargetFrameBuffer();
-		glBindFramebuffer(GL_READ_FRAMEBUFFER, s_Data.geoPass->GetSpecification().TargetFrameBuffer->GetRendererID());
-		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, s_Data.lightingPass->GetSpecification().TargetFrameBuffer->GetRendererID()); // write to default framebuffer
-		auto w = s_Data.lightingPass->GetSpecification().TargetFrameBuffer->GetSpecification().Width;
-		auto h = s_Data.lightingPass->GetSpecification().TargetFrameBuffer->GetSpecification().Height;
-		glBlitFramebuffer(0, 0, w, h, 0, 0, w, h, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
-		if (s_Data.environment) {
-			glEnable(GL_DEPTH_TEST);
-			glDepthFunc(GL_LEQUAL);
-			s_Data.environment->RenderBackground();
-			glDepthFunc(GL_LESS);
-		}
-
-		s_Data.lightingPass->UnbindTargetFrameBuffer();
-		//-------------------------------------------------ANTI ALIASING PASS------------------------------------------------------------------//
-
-		if (s_Data.useFxaa) {
-			s_Data.aaPass->BindTargetFrameBuffer();
-			s_Data.fxaa->Bind();
-			s_Data.fxaa->SetFloat("pc.width", (float)s_Data.aaPass->GetSpecification().TargetFrameBuffer->GetSpecification().Width);
-			s_Data.fxaa->SetFloat("pc.height", (float)s_Data.aaPass->GetSpecification().TargetFrameBuffer->GetSpecification().Height);
-			Texture2D::BindTexture(s_Data.lightingPass->GetFrameBufferTextureID(0), 0);
-			Renderer::Submit(s_Data.fxaa, s_Data.screenVao);
-			s_Data.fxaa->Unbind();
-			s_Data.aaPass->UnbindTargetFrameBuffer();
-		}
-
+		s_Data.frameConstants->EndFrame();
 		Renderer::EndScene();
 	}
 
@@ -387,9 +1366,13 @@ namespace Syndra {
 
 	void SceneRenderer::OnViewPortResize(uint32_t width, uint32_t height)
 	{
-		s_Data.geoPass->GetSpecification().TargetFrameBuffer->Resize(width, height);
-		s_Data.lightingPass->GetSpecification().TargetFrameBuffer->Resize(width, height);
-		s_Data.aaPass->GetSpecification().TargetFrameBuffer->Resize(width, height);
+		s_Data.gBuffer->Resize(width, height);
+		s_Data.temporalOutput->Resize(width, height);
+		s_Data.temporalHistory->Resize(width, height);
+		s_Data.historyValid = false;
+		s_Data.graph->Resize(width, height);
+		s_Data.viewportWidth = width;
+		s_Data.viewportHeight = height;
 	}
 
 	void SceneRenderer::OnImGuiRender(bool* rendererOpen, bool* environmentOpen)
@@ -410,24 +1393,30 @@ namespace Syndra {
 			if (ImGui::Button("Normal")) {
 				showNormal = true;
 			}
-			ImGui::SameLine();
-			if (ImGui::Button("Position")) {
-				showPosition = true;
+			//The packed layout has no position target
+			if (s_Data.gBufferLayout == GBufferLayout::Full) {
+				ImGui::SameLine();
+				if (ImGui::Button("Position")) {
+					showPosition = true;
+				}
 			}
 			ImGui::SameLine();
 			if (ImGui::Button("RoughMetalAO")) {
 				showRoughMetalAO = true;
 			}
-			auto width = s_Data.geoPass->GetSpecification().TargetFrameBuffer->GetSpecification().Width * 0.5f;
-			auto height = s_Data.geoPass->GetSpecification().TargetFrameBuffer->GetSpecification().Height * 0.5f;
+			uint32_t normalAttachment = GBufferNormalAttachment();
+			auto width = s_Data.gBuffer->GetSpecification().Width * 0.5f;
+			auto height = s_Data.gBuffer->GetSpecification().Height * 0.5f;
 			auto ratio = height / width;
 			width = ImGui::GetContentRegionAvail().x;
 			height = ratio * width;
+			//Only the drawn part of the G-buffer is shown
+			ImVec2 uv0 = { 0.0f, s_Data.renderScale }, uv1 = { s_Data.renderScale, 0.0f };
 			if (showAlbedo) {
 				ImGui::Begin("Albedo", &showAlbedo);
 				width = ImGui::GetContentRegionAvail().x;
 				height = ratio * width;
-				ImGui::Image((ImTextureID)s_Data.geoPass->GetFrameBufferTextureID(2), {width, height}, ImVec2{ 0, 1 }, ImVec2{ 1, 0 });
+				ImGui::Image((ImTextureID)s_Data.gBuffer->GetColorAttachmentRendererID(normalAttachment + 1), { width, height }, uv0, uv1);
 				ImGui::End();
 			}
 
@@ -435,15 +1424,15 @@ namespace Syndra {
 				ImGui::Begin("Normal", &showNormal);
 				width = ImGui::GetContentRegionAvail().x;
 				height = ratio * width;
-				ImGui::Image((ImTextureID)s_Data.geoPass->GetFrameBufferTextureID(1), { width, height }, ImVec2{ 0, 1 }, ImVec2{ 1, 0 });
+				ImGui::Image((ImTextureID)s_Data.gBuffer->GetColorAttachmentRendererID(normalAttachment), { width, height }, uv0, uv1);
 				ImGui::End();
 			}
 
-			if (showPosition) {
+			if (showPosition && s_Data.gBufferLayout == GBufferLayout::Full) {
 				ImGui::Begin("Position", &showPosition);
 				width = ImGui::GetContentRegionAvail().x;
 				height = ratio * width;
-				ImGui::Image((ImTextureID)s_Data.geoPass->GetFrameBufferTextureID(0), { width, height }, ImVec2{ 0, 1 }, ImVec2{ 1, 0 });
+				ImGui::Image((ImTextureID)s_Data.gBuffer->GetColorAttachmentRendererID(0), { width, height }, uv0, uv1);
 				ImGui::End();
 			}
 
@@ -451,7 +1440,7 @@ namespace Syndra {
 				ImGui::Begin("RoughMetalAO", &showRoughMetalAO);
 				width = ImGui::GetContentRegionAvail().x;
 				height = ratio * width;
-				ImGui::Image((ImTextureID)s_Data.geoPass->GetFrameBufferTextureID(3), { width, height }, ImVec2{ 0, 1 }, ImVec2{ 1, 0 });
+				ImGui::Image((ImTextureID)s_Data.gBuffer->GetColorAttachmentRendererID(normalAttachment + 2), { width, height }, uv0, uv1);
 				ImGui::End();
 			}
 			ImGui::Separator();
@@ -461,8 +1450,51 @@ namespace Syndra {
 			Application::Get().GetWindow().SetVSync(vSync);
 			ImGui::Separator();
 
+			ImGui::Text("Frustum culling");
+			ImGui::Text("Meshes: %d", s_Data.drawStats.meshes);
+			ImGui::Text("Culled (camera): %d", s_Data.drawStats.cameraCulled);
+			ImGui::Text("Culled (shadow): %d", s_Data.drawStats.shadowCulled);
+			ImGui::Text("Shadow cascades: %d updated, %d static redraws, %d scrolled", s_Data.drawStats.shadowUpdates, s_Data.drawStats.staticRedraws, s_Data.drawStats.staticScrolls);
+			ImGui::Text("Draw commands: %d (%d instances)", s_Data.drawStats.drawCommands, s_Data.drawStats.instances);
+			ImGui::Text("Draw calls: %d, %llu triangles", s_Data.drawStats.drawCalls, (unsigned long long)s_Data.drawStats.triangles);
+			auto stateStats = RenderCommand::GetStateStats();
+			ImGui::Text("State calls: %d issued, %d filtered", stateStats.issued, stateStats.filtered);
+			ImGui::Text("Render graph: %d/%d passes, %d pooled framebuffers", s_Data.graph->GetAlivePassCount(), s_Data.graph->GetPassCount(), s_Data.graph->GetFrameBufferCount());
+			auto& lightStats = s_Data.lightManager->GetStats();
+			ImGui::Text("Lights: %d point, %d spot", lightStats.pointLights, lightStats.spotLights);
+			auto& atlas = *s_Data.atlasAllocator;
+			float atlasUsage = 100.0f * atlas.GetUsedArea() / ((float)atlas.GetSize() * atlas.GetSize());
+			ImGui::Text("Shadow atlas: %d lights, %d tiles drawn, %.1f%% used", s_Data.drawStats.localShadows, s_Data.drawStats.localShadowUpdates, atlasUsage);
+			ImGui::Text("Light clusters: %d indices, at most %d lights per cluster", lightStats.indices, lightStats.maxPerCluster);
+			ImGui::Separator();
+
+			//G-buffer layout and the memory one frame writes into it
+			int layout = (int)s_Data.gBufferLayout;
+			if (ImGui::Combo("G-buffer layout", &layout, "Full\0Packed\0"))
+				SetGBufferLayout((GBufferLayout)layout);
+			auto& gBufferSpec = s_Data.gBuffer->GetSpecification();
+			float pixels = (float)gBufferSpec.Width * gBufferSpec.Height;
+			for (auto shown : { GBufferLayout::Full, GBufferLayout::Packed })
+			{
+				uint32_t bytes = BytesPerPixel(GBufferSpecification(shown, gBufferSpec.Width, gBufferSpec.Height));
+				ImGui::Text("%s: %d bytes per pixel, %.1f MB per frame", shown == GBufferLayout::Full ? "Full" : "Packed", bytes, bytes * pixels / (1024.0f * 1024.0f));
+			}
+			ImGui::Checkbox("Depth pre-pass", &s_Data.useDepthPrepass);
+			ImGui::Separator();
+
 			ImGui::Text("Anti Aliasing");
-			ImGui::Checkbox("FXAA", &s_Data.useFxaa);
+			int antiAliasing = (int)s_Data.antiAliasing;
+			if (ImGui::Combo("Mode", &antiAliasing, "None\0FXAA\0Temporal\0"))
+				s_Data.antiAliasing = (AntiAliasing)antiAliasing;
+			if (s_Data.antiAliasing == AntiAliasing::Temporal) {
+				ImGui::DragFloat("Feedback", &s_Data.temporalFeedback, 0.005f, 0.02f, 1.0f);
+				ImGui::Checkbox("Dynamic resolution", &s_Data.dynamicResolution);
+				ImGui::DragFloat("Target frame time (ms)", &s_Data.targetFrameTime, 0.1f, 4.0f, 100.0f);
+				ImGui::DragFloatRange2("Render scale", &s_Data.minRenderScale, &s_Data.maxRenderScale, 0.01f, 0.25f, 1.0f);
+				ImGui::Checkbox("Lower scale while moving", &s_Data.lowerScaleWhileMoving);
+				ImGui::DragFloat("Moving scale", &s_Data.movingRenderScale, 0.01f, 0.25f, 1.0f);
+			}
+			ImGui::Text("Frame time: %.2f ms, render scale %.0f%% (%dx%d)", s_Data.frameTime, s_Data.renderScale * 100.0f, s_Data.renderSize.x, s_Data.renderSize.y);
 			ImGui::Separator();
 
 			//Exposure
@@ -478,22 +1510,32 @@ namespace Syndra {
 			ImGui::DragFloat("blocker samples", &s_Data.numBlocker, 1, 1, 64);
 			ImGui::DragFloat("Light Size", &s_Data.lightSize, 0.01f, 0, 100);
 
-			if (ImGui::DragFloat("Ortho Size", &s_Data.orthoSize, 0.1f, 1, 100)) {
-				s_Data.lightProj = glm::ortho(-s_Data.orthoSize, s_Data.orthoSize, -s_Data.orthoSize, s_Data.orthoSize, s_Data.lightNear, s_Data.lightFar);
+			//Cascaded shadow maps
+			bool shadowMapChanged = ImGui::SliderInt("Cascades", &s_Data.cascadeCount, 1, MaxCascades);
+			static const int resolutions[] = { 512, 1024, 2048, 4096 };
+			static const char* resolutionNames[] = { "512", "1024", "2048", "4096" };
+			int resolution = (int)(std::find(std::begin(resolutions), std::end(resolutions), s_Data.shadowResolution) - std::begin(resolutions));
+			if (ImGui::Combo("Cascade resolution", &resolution, resolutionNames, IM_ARRAYSIZE(resolutionNames))) {
+				s_Data.shadowResolution = resolutions[resolution];
+				shadowMapChanged = true;
 			}
-
-			ImGui::PushMultiItemsWidths(2, ImGui::CalcItemWidth());
-			if (ImGui::DragFloat("near", &s_Data.lightNear, 0.01f, 0.1f, 100.0f)) {
-				//s_Data.lightProj = glm::perspective(45.0f, 1.0f, s_Data.lightNear, s_Data.lightFar);
-				s_Data.lightProj = glm::ortho(-s_Data.orthoSize, s_Data.orthoSize, -s_Data.orthoSize, s_Data.orthoSize, s_Data.lightNear, s_Data.lightFar);
-			}
-			ImGui::PopItemWidth();
-			ImGui::SameLine();
-			if (ImGui::DragFloat("far", &s_Data.lightFar, 0.1f, 100.0f, 10000.0f)) {
-				//s_Data.lightProj = glm::perspective(45.0f, 1.0f, s_Data.lightNear, s_Data.lightFar);
-				s_Data.lightProj = glm::ortho(-s_Data.orthoSize, s_Data.orthoSize, -s_Data.orthoSize, s_Data.orthoSize, s_Data.lightNear, s_Data.lightFar);
+			if (shadowMapChanged) {
+				CreateShadowMaps();
+				s_Data.graph->SetFrameBuffer(s_Data.shadowTarget, s_Data.shadowMap);
 			}
-			ImGui::PopItemWidth();
+			ImGui::DragFloat("Shadow distance", &s_Data.shadowDistance, 1.0f, 1.0f, 10000.0f);
+			ImGui::SliderFloat("Split lambda", &s_Data.cascadeSplitLambda, 0.0f, 1.0f);
+			ImGui::SliderFloat("Cascade blend", &s_Data.cascadeBlend, 0.0f, 0.5f);
+			ImGui::DragFloat("Caster distance", &s_Data.casterDistance, 1.0f, 0.0f, 10000.0f);
+
+			//Shadow atlas
+			static const int tileSizes[] = { 256, 512, 1024, 2048 };
+			static const char* tileSizeNames[] = { "256", "512", "1024", "2048" };
+			int tileSize = (int)(std::find(std::begin(tileSizes), std::end(tileSizes), s_Data.maxLocalShadowTile) - std::begin(tileSizes));
+			if (ImGui::Combo("Max light shadow tile", &tileSize, tileSizeNames, IM_ARRAYSIZE(tileSizeNames)))
+				s_Data.maxLocalShadowTile = tileSizes[tileSize];
+			//A point light needs six tiles in the same frame
+			ImGui::SliderInt("Shadow tiles per frame", &s_Data.localShadowBudget, 6, MaxLocalShadowUpdates);
 
 			ImGui::Separator();
 			std::string label = "shader";
@@ -529,11 +1571,14 @@ namespace Syndra {
 			if (ImGui::Button("HDR", { 40,30 })) {
 				auto path = FileDialogs::OpenFile("HDR (*.hdr)\0*.hdr\0");
 				if (path) {
-					//Add texture as sRGB color space if it is binded to 0 (diffuse texture binding)
-					s_Data.environment = CreateRef<Environment>(Texture2D::CreateHDR(*path, false, true));
+					LoadEnvironment(*path);
 					s_Data.scene->m_EnvironmentPath = *path;
 				}
 			}
+			if (s_Data.pendingEnvironment) {
+				ImGui::SameLine();
+				ImGui::TextUnformatted("Loading...");
+			}
 			if (s_Data.environment) {
 				ImGui::Image((ImTextureID)s_Data.environment->GetBackgroundTextureID(), { 300, 150 }, ImVec2{ 0, 1 }, ImVec2{ 1, 0 });
 			}
@@ -549,34 +1594,75 @@ namespace Syndra {
 	void SceneRenderer::SetScene(const Ref<Scene>& scene)
 	{
 		s_Data.scene = scene;
+		s_Data.historyValid = false;
+		s_Data.entityMotion.clear();
 		auto path = scene->m_EnvironmentPath;
 		if (s_Data.environment) {
 			s_Data.scene->m_EnvironmentPath = s_Data.environment->GetPath();
 		}
 		if (!path.empty()) {
-			s_Data.environment = CreateRef<Environment>(Texture2D::CreateHDR(path, false, true));
+			LoadEnvironment(path);
 		}
 	}
 
-	uint32_t SceneRenderer::GetTextureID(int index)
+	void SceneRenderer::WaitForEnvironment()
 	{
-		if (s_Data.useFxaa) {
-			return s_Data.aaPass->GetSpecification().TargetFrameBuffer->GetColorAttachmentRendererID(index);
-		}
-		else
-		{
-			return s_Data.lightingPass->GetSpecification().TargetFrameBuffer->GetColorAttachmentRendererID(index);
+		if (s_Data.pendingEnvironment) {
+			s_Data.pendingEnvironment->WaitUntilReady();
+			UpdateEnvironment();
 		}
 	}
 
+	uint32_t SceneRenderer::GetTextureID(int index)
+	{
+		auto frameBuffer = s_Data.graph->GetFrameBuffer(s_Data.graph->GetOutput());
+		return frameBuffer ? frameBuffer->GetColorAttachmentRendererID(index) : 0;
+	}
+
+	Ref<FrameBuffer> SceneRenderer::GetOutputFrameBuffer()
+	{
+		return s_Data.graph->GetFrameBuffer(s_Data.graph->GetOutput());
+	}
+
 	Syndra::FramebufferSpecification SceneRenderer::GetMainFrameSpec()
 	{
-		return s_Data.geoPass->GetSpecification().TargetFrameBuffer->GetSpecification();
+		return s_Data.gBuffer->GetSpecification();
 	}
 
 	Syndra::Ref<Syndra::FrameBuffer> SceneRenderer::GetGeoFrameBuffer()
 	{
-		return s_Data.geoPass->GetSpecification().TargetFrameBuffer;
+		return s_Data.gBuffer;
+	}
+
+	const Ref<GPUProfiler>& SceneRenderer::GetGPUProfiler()
+	{
+		return s_Data.gpuProfiler;
+	}
+
+	const Ref<RenderGraph>& SceneRenderer::GetRenderGraph()
+	{
+		return s_Data.graph;
+	}
+
+	void SceneRenderer::SetDynamicResolution(bool enabled)
+	{
+		s_Data.dynamicResolution = enabled;
+		s_Data.lowerScaleWhileMoving = enabled;
+	}
+
+	const SceneRenderer::DrawStats& SceneRenderer::GetDrawStats()
+	{
+		return s_Data.drawStats;
+	}
+
+	float SceneRenderer::GetRenderScale()
+	{
+		return s_Data.renderScale;
+	}
+
+	uint32_t SceneRenderer::GetEntityIDAttachment()
+	{
+		return s_Data.gBufferLayout == GBufferLayout::Packed ? 3 : 4;
 	}
 
 	Syndra::ShaderLibrary& SceneRenderer::GetShaderLibrary()
@@ -3,10 +3,15 @@
 #include "Engine/Scene/Components.h"
 #include "Engine/Renderer/Renderer.h"
 #include "Engine/Renderer/FrameBuffer.h"
-#include "Engine/Renderer/UniformBuffer.h"
+#include "Engine/Renderer/RingBuffer.h"
+#include "Engine/Renderer/RendererAPI.h"
 #include "Engine/Renderer/Environment.h"
 #include "Engine/Renderer/LightManager.h"
-#include "Engine/Renderer/RenderPass.h"
+#include "Engine/Renderer/RenderGraph.h"
+#include "Engine/Renderer/RenderQueue.h"
+#include "Engine/Renderer/ShadowAtlas.h"
+#include "Engine/Renderer/GPUProfiler.h"
+#include "Engine/Core/Timestep.h"
 #include "Engine/ImGui/IconsFontAwesome5.h"
 
 #include "entt.hpp"
@@ -24,7 +29,8 @@ namespace Syndra {
 	public:
 		static void Initialize();
 
-		static void BeginScene(const PerspectiveCamera& camera);
+		//The frame time drives the dynamic render scale
+		static void BeginScene(const PerspectiveCamera& camera, Timestep ts);
 		static void UpdateLights();
 		static void RenderScene();
 
@@ -42,24 +48,208 @@ namespace Syndra {
 		static void SetScene(const Ref<Scene>& scene);
 
 		static uint32_t GetTextureID(int index);
+		//Final image of the last frame, what the viewport shows
+		static Ref<FrameBuffer> GetOutputFrameBuffer();
 
 		static FramebufferSpecification GetMainFrameSpec();
 		static Ref<FrameBuffer> GetGeoFrameBuffer();
+		//Color attachment of the G-buffer holding entity IDs for mouse picking
+		static uint32_t GetEntityIDAttachment();
+		//Fraction of the viewport the G-buffer was drawn at, G-buffer reads have to scale their coordinates by it
+		static float GetRenderScale();
 
 		static ShaderLibrary& GetShaderLibrary();
+		//GPU time of the render graph passes
+		static const Ref<GPUProfiler>& GetGPUProfiler();
+		static const Ref<RenderGraph>& GetRenderGraph();
+
+		//Blocks until a loading environment is ready, for tools that measure frames right after SetScene
+		static void WaitForEnvironment();
+
+		//Off keeps the render scale at one, also while the camera moves, so every frame draws the same pixels
+		static void SetDynamicResolution(bool enabled);
 
 
 	public:
 
 		struct CameraData
 		{
+			//Jittered while the temporal resolve is on
 			glm::mat4 ViewProjection;
 			glm::vec4 position;
+			//Rebuilds world positions from the depth buffer
+			glm::mat4 InverseViewProjection;
+			//Motion vectors are computed without the jitter
+			glm::mat4 UnjitteredViewProjection = glm::mat4(1.0f);
+			glm::mat4 PreviousViewProjection = glm::mat4(1.0f);
+		};
+
+		//Full: world position, normal, albedo and material in RGBA16F targets.
+		//Packed: position rebuilt from depth, octahedral RG16 normals, sRGB albedo and RGBA8 material.
+		enum class GBufferLayout
+		{
+			Full = 0, Packed
+		};
+
+		//Temporal: jittered rendering resolved against the reprojected history, it also upsamples a render scale below one
+		enum class AntiAliasing
+		{
+			None = 0, FXAA, Temporal
+		};
+
+		//Per instance data, read by the shaders from the instance buffer with gl_InstanceIndex
+		struct InstanceData
+		{
+			glm::mat4 transform;
+			glm::mat4 previousTransform;
+			int id;
+			int padding[3];
+		};
+
+		//Transform of an entity in the last frame it was drawn and the one before
+		struct EntityMotion
+		{
+			glm::mat4 transform;
+			glm::mat4 previousTransform;
+			uint32_t frame = 0;
+		};
+
+		//Run of indirect commands sharing shader and material state
+		struct DrawBucket
+		{
+			uint32_t firstCommand;
+			uint32_t commandCount;
+			const RenderPacket* packet;
+		};
+
+		struct DrawStats
+		{
+			uint32_t meshes = 0;
+			uint32_t cameraCulled = 0;
+			uint32_t shadowCulled = 0;
+			uint32_t drawCommands = 0;
+			uint32_t instances = 0;
+			//Cascades whose static depth was redrawn or scrolled and cascades that were touched at all
+			uint32_t staticRedraws = 0;
+			uint32_t staticScrolls = 0;
+			uint32_t shadowUpdates = 0;
+			//Shadowed point and spot lights and the atlas tiles drawn this frame
+			uint32_t localShadows = 0;
+			uint32_t localShadowUpdates = 0;
+			//Multi draw calls issued by all passes and the triangles they drew
+			uint32_t drawCalls = 0;
+			uint64_t triangles = 0;
 		};
 
+		//Counters of the last rendered frame
+		static const DrawStats& GetDrawStats();
+
+		static constexpr uint32_t MaxCascades = 4;
+		//Atlas tiles that can be drawn in one frame, each is a pass of the local shadow queue
+		static constexpr uint32_t MaxLocalShadowUpdates = 16;
+
+		//Uniform binding 3
 		struct ShadowData {
-			glm::mat4 lightViewProj;
-			glm::mat4 pointLightViewProj[4][6];
+			glm::mat4 cascadeViewProj[MaxCascades];
+			//View space depth where each cascade ends
+			glm::vec4 cascadeSplits;
+			//Size of the first cascade relative to each cascade, scales the soft shadow search
+			glm::vec4 cascadeScales;
+			int cascadeCount;
+			//Fraction of a cascade blended with the next one
+			float cascadeBlend;
+			float padding[2];
+		};
+
+		//Light space footprint of a static caster when the cache was last drawn
+		struct StaticCaster
+		{
+			uint64_t signature;
+			//ndc min xy, max xy
+			glm::vec4 rect;
+			uint32_t frame;
+		};
+
+		//Where a cascade lies in light space. The view only depends on the light direction and the depth
+		//window moves in steps of the radius, so a moving camera only changes the texel origin.
+		struct CascadePlacement
+		{
+			glm::mat4 view;
+			glm::ivec2 origin = glm::ivec2(0);
+			float radius = 0.0f;
+			float nearDepth = 0.0f, farDepth = 0.0f;
+
+			bool SharesWindow(const CascadePlacement& other) const
+			{
+				return view == other.view && radius == other.radius && nearDepth == other.nearDepth && farDepth == other.farDepth;
+			}
+		};
+
+		//Static depth of a cascade, kept until a static caster, the light or the cascade window changes.
+		//When only the origin moves the content is scrolled by whole texels and the exposed strips are redrawn.
+		struct ShadowCache
+		{
+			bool valid = false;
+			CascadePlacement placement;
+			glm::mat4 viewProj;
+			std::unordered_map<uint64_t, StaticCaster> casters;
+			//Texels the content moves by this frame
+			glm::ivec2 scroll = glm::ivec2(0);
+			//ndc regions to redraw this frame, empty when min > max: changed casters, then the columns and the rows
+			//exposed by the scroll
+			glm::vec4 dirtyRects[3] = { glm::vec4(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX), glm::vec4(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX),
+				glm::vec4(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX) };
+			bool hadDynamicCasters = false;
+		};
+
+		//Storage binding 6, one entry per shadowed spot light and per point light cube face
+		struct ShadowTile
+		{
+			glm::mat4 viewProj;
+			//uv offset, uv size, normal offset per unit of distance to the light
+			glm::vec4 rect;
+		};
+
+		//Atlas tiles of a shadowed spot light (one) or point light (one per cube face, +X -X +Y -Y +Z -Z)
+		struct LocalShadow
+		{
+			std::vector<ShadowAtlasTile> tiles;
+			//Light space of the tiles when they were drawn
+			glm::mat4 viewProj[6];
+			float normalOffset = 0.0f;
+			uint32_t tileSize = 0;
+			//Changes when the light moves or its shape changes
+			uint64_t signature = 0;
+			//Changes when a mesh in the light's range moves, appears or goes away
+			uint64_t casterSignature = 0;
+			//Frame the tiles were last drawn, 0 until they are drawn once
+			uint32_t lastUpdate = 0;
+			uint32_t frame = 0;
+			//First entry in this frame's shadow tile buffer, -1 when the light has no drawn tiles
+			int tileIndex = -1;
+		};
+
+		//Atlas tile drawn this frame, view indexes the shadow view list read by the depth shader
+		struct LocalShadowUpdate
+		{
+			ShadowAtlasTile tile;
+			uint32_t view;
+			glm::vec3 lightPosition;
+			float range;
+		};
+
+		//Mesh of an entity in world space, gathered once per frame for the shadow updates and the render queue
+		struct MeshInstance
+		{
+			entt::entity entity;
+			const Mesh* mesh;
+			uint32_t meshIndex;
+			Material* material;
+			bool isStatic;
+			glm::mat4 transform;
+			Math::AABB bounds;
+			//Changes when the mesh moves or its model is replaced
+			uint64_t signature;
 		};
 
 		struct DrawCall {
@@ -68,39 +258,120 @@ namespace Syndra {
 			MeshComponent mc;
 		};
 
+		//Uniforms set for meshes drawn without a material
+		struct GeometryParameters
+		{
+			ShaderParameter<int> HasAlbedoMap, HasNormalMap, HasMetallicMap, HasRoughnessMap, HasAOMap;
+			ShaderParameter<float> Tiling, MetallicFactor, RoughnessFactor, AO;
+		};
+
 		struct SceneData
 		{
 			//Scene object
 			Ref<Scene> scene;
 			CameraData CameraBuffer;
+			glm::vec3 cameraForward;
+			glm::mat4 cameraView;
+			glm::mat4 cameraProjection;
+			float cameraNear;
+			float cameraFar;
+			//Meshes of the current frame and the draws made from them, sorted by state
+			std::vector<MeshInstance> meshInstances;
+			RenderQueue queue;
+			std::vector<DrawIndexedIndirectCommand> drawCommands;
+			std::vector<InstanceData> instanceData;
+			std::vector<DrawBucket> staticShadowBuckets[MaxCascades], dynamicShadowBuckets[MaxCascades], geometryBuckets;
+			//Casters of the atlas tiles drawn this frame, the pass is the index of the update
+			RenderQueue localShadowQueue{ true };
+			std::vector<DrawBucket> localShadowBuckets[MaxLocalShadowUpdates];
+			RingAllocation drawCommandAllocation;
+			DrawStats drawStats;
 			//Environment
 			float intensity;
 			Ref<Environment> environment;
+			//Loads in the background and replaces the environment once it is ready
+			Ref<Environment> pendingEnvironment;
+			//Replaced environments whose worker threads are still running, freed once they are idle
+			std::vector<Ref<Environment>> retiredEnvironments;
 			//Anti ALiasing
-			bool useFxaa = false;
+			AntiAliasing antiAliasing = AntiAliasing::Temporal;
+			//The resolve writes the output, which is copied into the history for the next frame
+			Ref<FrameBuffer> temporalOutput, temporalHistory;
+			bool historyValid = false;
+			//Weight of the current frame in the resolve
+			float temporalFeedback = 0.1f;
+			uint32_t jitterIndex = 0;
+			glm::vec2 jitter = glm::vec2(0.0f);
+			std::unordered_map<uint32_t, EntityMotion> entityMotion;
+			//Dynamic resolution, the geometry, lighting and sky passes draw into the lower left part of their targets
+			bool dynamicResolution = true;
+			float minRenderScale = 0.5f;
+			float maxRenderScale = 1.0f;
+			//Milliseconds, the smoothed GPU frame time is kept near it
+			float targetFrameTime = 16.6f;
+			float frameTime = 0.0f;
+			//Scale picked by the frame time and the one drawn at this frame
+			float dynamicScale = 1.0f;
+			float renderScale = 1.0f;
+			glm::uvec2 renderSize = glm::uvec2(1280, 720);
+			//The editor camera drops to a lower scale while it moves and refines once it stops
+			bool lowerScaleWhileMoving = true;
+			float movingRenderScale = 0.5f;
 			//Light
 			Ref<LightManager> lightManager;
 			float exposure;
 			float gamma;
 			float lightSize;
-			float orthoSize;
-			float lightNear;
-			float lightFar;
-			Ref<UniformBuffer> CameraUniformBuffer, ShadowBuffer;
+			//Camera, shadow, light and per draw data of the frame
+			Ref<RingBuffer> frameConstants;
 			//Shadow
 			bool softShadow = false;
 			float numPCF = 16;
 			float numBlocker = 2;
-			glm::mat4 lightProj;
-			glm::mat4 lightView;
 			ShadowData shadowData;
+			//Cascaded shadow maps
+			int cascadeCount = 4;
+			int shadowResolution = 2048;
+			float shadowDistance = 150.0f;
+			//0 splits the cascades uniformly, 1 logarithmically
+			float cascadeSplitLambda = 0.75f;
+			float cascadeBlend = 0.1f;
+			//How far in front of a cascade casters still cast into it
+			float casterDistance = 100.0f;
+			CascadePlacement cascadePlacements[MaxCascades];
+			//Cascades followed by the atlas tiles drawn this frame, storage binding 5
+			std::vector<glm::mat4> shadowViews;
+			ShaderParameter<int> depthView;
+			//The shadow map keeps its content between frames, static casters are copied from the cache
+			Ref<FrameBuffer> shadowMap, staticShadowMap;
+			ShadowCache shadowCaches[MaxCascades];
+			uint32_t frameIndex = 0;
+			//Point and spot light shadows share one atlas, tiles are sized by the screen size of the light
+			Ref<FrameBuffer> shadowAtlas;
+			Scope<ShadowAtlas> atlasAllocator;
+			int atlasResolution = 4096;
+			int maxLocalShadowTile = 1024;
+			//Tiles drawn per frame, lights with small tiles are refreshed less often
+			int localShadowBudget = 12;
+			std::unordered_map<uint32_t, LocalShadow> localShadows;
+			std::vector<LocalShadowUpdate> localShadowUpdates;
+			std::vector<ShadowTile> shadowTiles;
+			uint32_t viewportWidth = 1280;
+			uint32_t viewportHeight = 720;
 			//Poisson
 			Ref<Texture1D> distributionSampler0, distributionSampler1;
 			//shaders
 			ShaderLibrary shaders;
-			Ref<Shader> diffuse, geoShader, outline, mouseShader, fxaa, main, depth, deferredLighting, hdrToCubeShader;
-			//Render passes
-			Ref<RenderPass> geoPass, shadowPass, lightingPass, aaPass;
+			Ref<Shader> diffuse, geoShader, outline, mouseShader, fxaa, main, depth, depthPrepass, deferredLighting, temporalResolve, hdrToCubeShader;
+			GeometryParameters geoParameters;
+			//Render graph and its targets
+			Ref<RenderGraph> graph;
+			Ref<GPUProfiler> gpuProfiler;
+			Ref<FrameBuffer> gBuffer;
+			GBufferLayout gBufferLayout = GBufferLayout::Packed;
+			//Lays down depth before the G-buffer is shaded, only the visible surface of a pixel is then shaded
+			bool useDepthPrepass = true;
+			RenderGraphResource shadowTarget, shadowAtlasTarget, gBufferTarget, lightingTarget, aaTarget, temporalTarget;
 			//Scene quad VBO
 			Ref<VertexArray> screenVao;
 		};
@@ -26,6 +26,16 @@ namespace Syndra {
 		bool isUsed;
 	};
 
+	//Handle to a uniform of a shader, resolved once with Shader::GetParameter and reused for every set.
+	//Handles index the shader's parameter table so they stay valid when the shader is reloaded.
+	template<typename T>
+	struct ShaderParameter
+	{
+		int32_t Index = -1;
+
+		bool IsValid() const { return Index >= 0; }
+	};
+
 	class Shader
 	{
 	public:
@@ -42,14 +52,29 @@ namespace Syndra {
 		virtual void SetFloat4(const std::string& name, const glm::vec4& value) = 0;
 		virtual void SetMat4(const std::string& name, const glm::mat4& value) = 0;
 
+		template<typename T>
+		ShaderParameter<T> GetParameter(const std::string& name) { return { GetParameterIndex(name) }; }
+
+		virtual void Set(ShaderParameter<int> parameter, int value) = 0;
+		virtual void Set(ShaderParameter<float> parameter, float value) = 0;
+		virtual void Set(ShaderParameter<glm::vec3> parameter, const glm::vec3& value) = 0;
+		virtual void Set(ShaderParameter<glm::vec4> parameter, const glm::vec4& value) = 0;
+		virtual void Set(ShaderParameter<glm::mat4> parameter, const glm::mat4& value) = 0;
+
 		virtual std::vector<PushConstant> GetPushConstants() = 0;
 		virtual std::vector<Sampler> GetSamplers() = 0;
 
 		virtual const std::string& GetName() const = 0;
+		virtual uint32_t GetRendererID() const = 0;
 		virtual void Reload() = 0;
+		//Recompiles the shader with the given macros defined, parameter handles and materials using it stay valid
+		virtual void SetDefines(const std::vector<std::string>& defines) = 0;
 
 		static Ref<Shader> Create(const std::string& filepath);
 		static Ref<Shader> Create(const std::string& name, const std::string& vertexSrc, const std::string& fragmentSrc);
+
+	protected:
+		virtual int32_t GetParameterIndex(const std::string& name) = 0;
 	};
 
 	class ShaderLibrary
@@ -0,0 +1,93 @@
+#include "lpch.h"
+#include "Engine/Renderer/ShadowAtlas.h"
+
+namespace Syndra {
+
+	ShadowAtlas::ShadowAtlas(uint32_t size, uint32_t minTileSize)
+		:m_Size(size), m_LevelCount(1)
+	{
+		SN_CORE_ASSERT((size & (size - 1)) == 0, "Shadow atlas size should be a power of two");
+		while ((m_Size >> m_LevelCount) >= minTileSize)
+			m_LevelCount++;
+		m_Nodes.resize(m_LevelCount);
+		for (uint32_t level = 0; level < m_LevelCount; level++)
+		{
+			uint32_t count = 1u << level;
+			m_Nodes[level].resize(count * count, NodeState::Free);
+		}
+	}
+
+	bool ShadowAtlas::Allocate(uint32_t tileSize, ShadowAtlasTile& tile)
+	{
+		uint32_t targetLevel = 0;
+		while (targetLevel + 1 < m_LevelCount && (m_Size >> (targetLevel + 1)) >= tileSize)
+			targetLevel++;
+		return Allocate(0, 0, 0, targetLevel, tile);
+	}
+
+	//Depth first, children are visited in order so tiles fill the atlas from one corner
+	bool ShadowAtlas::Allocate(uint32_t level, uint32_t x, uint32_t y, uint32_t targetLevel, ShadowAtlasTile& tile)
+	{
+		auto& node = Node(level, x, y);
+		if (node == NodeState::Used)
+			return false;
+
+		if (level == targetLevel) {
+			if (node != NodeState::Free)
+				return false;
+			node = NodeState::Used;
+			tile.Size = m_Size >> level;
+			tile.X = x * tile.Size;
+			tile.Y = y * tile.Size;
+			tile.Level = level;
+			m_UsedArea += (uint64_t)tile.Size * tile.Size;
+			return true;
+		}
+
+		if (node == NodeState::Free)
+			node = NodeState::Split;
+		for (uint32_t child = 0; child < 4; child++)
+		{
+			if (Allocate(level + 1, x * 2 + (child & 1), y * 2 + (child >> 1), targetLevel, tile))
+				return true;
+		}
+		return false;
+	}
+
+	void ShadowAtlas::Free(const ShadowAtlasTile& tile)
+	{
+		uint32_t level = tile.Level;
+		uint32_t x = tile.X / tile.Size;
+		uint32_t y = tile.Y / tile.Size;
+		SN_CORE_ASSERT(Node(level, x, y) == NodeState::Used, "Shadow atlas tile is not allocated");
+		Node(level, x, y) = NodeState::Free;
+		m_UsedArea -= (uint64_t)tile.Size * tile.Size;
+
+		//Merge the parents whose children are all free again
+		while (level > 0)
+		{
+			x /= 2;
+			y /= 2;
+			level--;
+			for (uint32_t child = 0; child < 4; child++)
+			{
+				if (Node(level + 1, x * 2 + (child & 1), y * 2 + (child >> 1)) != NodeState::Free)
+					return;
+			}
+			Node(level, x, y) = NodeState::Free;
+		}
+	}
+
+	void ShadowAtlas::Clear()
+	{
+		for (auto& nodes : m_Nodes)
+			std::fill(nodes.begin(), nodes.end(), NodeState::Free);
+		m_UsedArea = 0;
+	}
+
+	ShadowAtlas::NodeState& ShadowAtlas::Node(uint32_t level, uint32_t x, uint32_t y)
+	{
+		return m_Nodes[level][y * (1u << level) + x];
+	}
+
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+namespace Syndra {
+
+	//Square region of the atlas in texels
+	struct ShadowAtlasTile
+	{
+		uint32_t X = 0, Y = 0, Size = 0;
+		//Depth in the quadtree, the whole atlas is level 0
+		uint32_t Level = 0;
+	};
+
+	//Quadtree allocator for the shadow atlas. Tiles are power of two sized, a tile is split into four
+	//children when a smaller one is needed and merged back once all four children are free.
+	class ShadowAtlas
+	{
+	public:
+		ShadowAtlas(uint32_t size, uint32_t minTileSize);
+		~ShadowAtlas() = default;
+
+		//The requested size is rounded up to a power of two and clamped to the atlas
+		bool Allocate(uint32_t tileSize, ShadowAtlasTile& tile);
+		void Free(const ShadowAtlasTile& tile);
+		void Clear();
+
+		uint32_t GetSize() const { return m_Size; }
+		uint32_t GetMinTileSize() const { return m_Size >> (m_LevelCount - 1); }
+		//Texels covered by allocated tiles
+		uint64_t GetUsedArea() const { return m_UsedArea; }
+
+	private:
+		enum class NodeState : uint8_t
+		{
+			Free = 0, Split, Used
+		};
+
+		bool Allocate(uint32_t level, uint32_t x, uint32_t y, uint32_t targetLevel, ShadowAtlasTile& tile);
+		NodeState& Node(uint32_t level, uint32_t x, uint32_t y);
+
+	private:
+		uint32_t m_Size;
+		uint32_t m_LevelCount;
+		//Row major grid of nodes for every level
+		std::vector<std::vector<NodeState>> m_Nodes;
+		uint64_t m_UsedArea = 0;
+	};
+
+}
@@ -0,0 +1,109 @@
+#include "lpch.h"
+#include "Engine/Renderer/SphericalHarmonics.h"
+
+#include <glad/glad.h>
+#include <future>
+
+namespace Syndra::SphericalHarmonics {
+
+	//Basis constants of the real spherical harmonics up to band 2
+	static constexpr float Y0 = 0.282095f;
+	static constexpr float Y1 = 0.488603f;
+	static constexpr float Y2 = 1.092548f;
+	static constexpr float Y20 = 0.315392f;
+	static constexpr float Y22 = 0.546274f;
+
+	//Cosine lobe convolution per band divided by pi
+	static constexpr float A0 = 1.0f;
+	static constexpr float A1 = 2.0f / 3.0f;
+	static constexpr float A2 = 1.0f / 4.0f;
+
+	static void EvaluateBasis(const glm::vec3& n, float basis[9])
+	{
+		basis[0] = Y0;
+		basis[1] = Y1 * n.y;
+		basis[2] = Y1 * n.z;
+		basis[3] = Y1 * n.x;
+		basis[4] = Y2 * n.x * n.y;
+		basis[5] = Y2 * n.y * n.z;
+		basis[6] = Y20 * (3.0f * n.z * n.z - 1.0f);
+		basis[7] = Y2 * n.x * n.z;
+		basis[8] = Y22 * (n.x * n.x - n.y * n.y);
+	}
+
+	//Direction through a texel of a face, following the OpenGL cube map face orientation
+	static glm::vec3 FaceDirection(uint32_t face, float u, float v)
+	{
+		switch (face)
+		{
+		case 0: return { 1.0f, -v, -u };
+		case 1: return { -1.0f, -v, u };
+		case 2: return { u, 1.0f, v };
+		case 3: return { u, -1.0f, -v };
+		case 4: return { u, -v, 1.0f };
+		default: return { -u, -v, -1.0f };
+		}
+	}
+
+	//Radiance projected on the basis, weighted by the solid angle of each texel
+	static std::array<glm::vec3, 9> ProjectFace(const float* texels, uint32_t face, uint32_t size)
+	{
+		std::array<glm::vec3, 9> sum = {};
+		float basis[9];
+		float texelSize = 2.0f / size;
+		for (uint32_t y = 0; y < size; y++)
+		{
+			float v = (y + 0.5f) * texelSize - 1.0f;
+			for (uint32_t x = 0; x < size; x++)
+			{
+				float u = (x + 0.5f) * texelSize - 1.0f;
+				float d2 = 1.0f + u * u + v * v;
+				float solidAngle = texelSize * texelSize / (d2 * std::sqrt(d2));
+				EvaluateBasis(glm::normalize(FaceDirection(face, u, v)), basis);
+				const float* texel = texels + ((size_t)y * size + x) * 3;
+				glm::vec3 radiance(texel[0], texel[1], texel[2]);
+				for (int i = 0; i < 9; i++)
+					sum[i] += radiance * (basis[i] * solidAngle);
+			}
+		}
+		return sum;
+	}
+
+	SHIrradiance ProjectCubemap(uint32_t cubemap, uint32_t level, uint32_t size)
+	{
+		SN_PROFILE_FUNCTION();
+
+		std::vector<float> texels((size_t)size * size * 6 * 3);
+		glPixelStorei(GL_PACK_ALIGNMENT, 4);
+		glGetTextureImage(cubemap, level, GL_RGB, GL_FLOAT, (GLsizei)(texels.size() * sizeof(float)), texels.data());
+
+		std::array<std::future<std::array<glm::vec3, 9>>, 6> faces;
+		for (uint32_t face = 0; face < 6; face++)
+			faces[face] = std::async(std::launch::async, ProjectFace, texels.data() + (size_t)face * size * size * 3, face, size);
+
+		std::array<glm::vec3, 9> sum = {};
+		for (auto& face : faces)
+		{
+			auto faceSum = face.get();
+			for (int i = 0; i < 9; i++)
+				sum[i] += faceSum[i];
+		}
+
+		//Fold the convolution and the basis constants into the coefficients
+		const float scale[9] = { A0 * Y0, A1 * Y1, A1 * Y1, A1 * Y1, A2 * Y2, A2 * Y2, A2 * Y20, A2 * Y2, A2 * Y22 };
+		SHIrradiance sh;
+		for (int i = 0; i < 9; i++)
+			sh.Coefficients[i] = glm::vec4(sum[i] * scale[i], 0.0f);
+		return sh;
+	}
+
+	glm::vec3 Evaluate(const SHIrradiance& sh, const glm::vec3& n)
+	{
+		const glm::vec4* c = sh.Coefficients;
+		glm::vec4 result = c[0] + c[1] * n.y + c[2] * n.z + c[3] * n.x
+			+ c[4] * (n.x * n.y) + c[5] * (n.y * n.z) + c[6] * (3.0f * n.z * n.z - 1.0f)
+			+ c[7] * (n.x * n.z) + c[8] * (n.x * n.x - n.y * n.y);
+		return glm::max(glm::vec3(result), glm::vec3(0.0f));
+	}
+
+}
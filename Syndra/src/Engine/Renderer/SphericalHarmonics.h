@@ -0,0 +1,23 @@
+#pragma once
+#include <glm/glm.hpp>
+
+namespace Syndra {
+
+	//L2 irradiance of an environment, laid out as the std140 uniform block the lighting shaders read.
+	//The coefficients already include the cosine lobe convolution, the basis constants and the 1/pi of a
+	//lambertian surface, so the irradiance along a normal n is
+	//c0 + c1 y + c2 z + c3 x + c4 xy + c5 yz + c6 (3z^2 - 1) + c7 xz + c8 (x^2 - y^2)
+	struct SHIrradiance
+	{
+		glm::vec4 Coefficients[9] = {};
+	};
+
+	namespace SphericalHarmonics {
+
+		//Projects a level of a float cubemap, faces are reduced in parallel. A 32x32 level is enough for L2.
+		SHIrradiance ProjectCubemap(uint32_t cubemap, uint32_t level, uint32_t size);
+		glm::vec3 Evaluate(const SHIrradiance& sh, const glm::vec3& n);
+
+	}
+
+}
@@ -65,6 +65,15 @@ namespace Syndra {
 
 	}
 
+	void Texture::BindTextures(uint32_t first, uint32_t count, const uint32_t* rendererIDs)
+	{
+		switch (Renderer::GetAPI())
+		{
+		case RendererAPI::API::NONE:    SN_CORE_ASSERT(false, "RendererAPI::None is currently not supported!"); return;
+		case RendererAPI::API::OpenGL:	OpenGLTexture2D::BindTextures(first, count, rendererIDs); return;
+		}
+	}
+
 	Ref<Texture1D> Texture1D::Create(uint32_t size)
 	{
 		switch (Renderer::GetAPI())
@@ -24,6 +24,8 @@ namespace Syndra{
 		virtual std::string GetPath() const = 0;
 
 		static void BindTexture(uint32_t rendererID, uint32_t slot);
+		//Binds rendererIDs to the slots first..first + count in one call, 0 leaves a slot empty
+		static void BindTextures(uint32_t first, uint32_t count, const uint32_t* rendererIDs);
 	};
 
 	class Texture1D : public Texture
@@ -9,6 +9,8 @@ namespace Syndra {
 	public:
 		virtual ~UniformBuffer() {}
 		virtual void SetData(const void* data, uint32_t size, uint32_t offset = 0) = 0;
+		//Rebinds the buffer, for blocks that share a binding point between owners
+		virtual void Bind(uint32_t binding) const = 0;
 
 		static Ref<UniformBuffer> Create(uint32_t size, uint32_t binding);
 	};
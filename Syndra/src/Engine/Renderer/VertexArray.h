@@ -19,6 +19,8 @@ namespace Syndra {
 		virtual const std::vector<Ref<VertexBuffer>>& GetVertexBuffers() const = 0;
 		virtual const Ref<IndexBuffer>& GetIndexBuffer() const = 0;
 
+		virtual uint32_t GetRendererID() const = 0;
+
 		static Ref<VertexArray> Create();
 	};
 
@@ -7,7 +7,7 @@
 #include <glm/gtx/quaternion.hpp>
 
 #include "Engine/Scene/SceneCamera.h"
-#include "Engine/Renderer/Model.h"
+#include "Engine/Renderer/AssetManager.h"
 #include "Engine/Renderer/Material.h"
 #include "Engine/Scene/Light.h"
 
@@ -46,13 +46,16 @@ namespace Syndra {
 
 	struct MeshComponent {
 
-		Model model;
+		//Shared with every entity using the same file, copying the component copies the handle
+		Ref<Model> model;
 		std::string path;
+		//Static meshes are cached in the shadow maps and only redrawn when they or the light change
+		bool isStatic = false;
 
 		MeshComponent() = default;
 		MeshComponent(const MeshComponent&) = default;
 		MeshComponent(std::string& path)
-			:path(path), model(path){}
+			:path(path), model(AssetManager::LoadModel(path)){}
 	};
 
 	struct CameraComponent
@@ -1,7 +1,7 @@
 #pragma once
 
 #include "entt.hpp"
-#include "Engine/Scene/scene.h"
+#include "Engine/Scene/Scene.h"
 
 namespace Syndra {
 
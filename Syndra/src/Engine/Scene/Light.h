@@ -18,9 +18,14 @@ namespace Syndra {
 		void SetIntensity(float intensity) { m_Intensity = intensity; }
 		float GetIntensity() const { return m_Intensity; }
 
+		//Point and spot lights get tiles in the shadow atlas, the directional light always casts shadows
+		void SetCastShadows(bool castShadows) { m_CastShadows = castShadows; }
+		bool GetCastShadows() const { return m_CastShadows; }
+
 	private:
 		glm::vec3 m_Color = { 1.0,1.0,1.0 };
 		float m_Intensity = 10.0f;
+		bool m_CastShadows = false;
 	};
 
 
@@ -102,12 +107,16 @@ namespace Syndra {
 		float GetInnerCutOff() const { return m_CutOff; }
 		float GetOuterCutOff() const { return m_OuterCutOff; }
 
+		void SetRange(float range) { m_Range = range; }
+		float GetRange() const { return m_Range; }
+
 	private:
 		glm::vec3 m_Position = { 0.0f,0.0f,0.0f };
 		glm::vec3 m_Direction = { -1.0f,0.0f,0.0f };
 
 		float m_CutOff = 12.5f;
 		float m_OuterCutOff = 15.0f;
+		float m_Range = 10;
 	};
 
 }
\ No newline at end of file
@@ -143,7 +143,7 @@ namespace Syndra {
 
 	void Scene::OnUpdateEditor(Timestep ts)
 	{
-		SceneRenderer::BeginScene(*m_Camera);
+		SceneRenderer::BeginScene(*m_Camera, ts);
 		SceneRenderer::RenderScene();
 		SceneRenderer::EndScene();
 	}
@@ -37,6 +37,8 @@ namespace Syndra {
 		void OnUpdateEditor(Timestep ts);
 		void OnViewportResize(uint32_t width, uint32_t height);
 		void OnCameraUpdate(Timestep ts) { m_Camera->OnUpdate(ts); }
+		PerspectiveCamera& GetCamera() { return *m_Camera; }
+		const std::string& GetName() const { return m_Name; }
 
 		uint32_t GetMainTextureID() { return SceneRenderer::GetTextureID(0); }
 		Ref<FrameBuffer> GetMainFrameBuffer() { return SceneRenderer::GetGeoFrameBuffer(); }
@@ -189,8 +189,9 @@ namespace Syndra {
 			out << YAML::Key << "MeshComponent";
 			out << YAML::BeginMap; // MeshComponent
 
-			auto& path = entity.GetComponent<MeshComponent>().path;
-			out << YAML::Key << "Path" << YAML::Value << path;
+			auto& mc = entity.GetComponent<MeshComponent>();
+			out << YAML::Key << "Path" << YAML::Value << mc.path;
+			out << YAML::Key << "Static" << YAML::Value << mc.isStatic;
 
 			out << YAML::EndMap; // MeshComponent
 		}
@@ -208,6 +209,7 @@ namespace Syndra {
 			{
 			case LightType::Point:
 				out << YAML::Key << "Range" << YAML::Value << dynamic_cast<PointLight*>(pl.light.get())->GetRange();
+				out << YAML::Key << "CastShadows" << YAML::Value << pl.light->GetCastShadows();
 				break;
 			case LightType::Directional:
 				out << YAML::Key << "Direction" << YAML::Value << dynamic_cast<DirectionalLight*>(pl.light.get())->GetDirection();
@@ -216,6 +218,8 @@ namespace Syndra {
 				out << YAML::Key << "Direction" << YAML::Value << dynamic_cast<SpotLight*>(pl.light.get())->GetDirection();
 				out << YAML::Key << "InnerCutOff" << YAML::Value << dynamic_cast<SpotLight*>(pl.light.get())->GetInnerCutOff();
 				out << YAML::Key << "OuterCutOff" << YAML::Value << dynamic_cast<SpotLight*>(pl.light.get())->GetOuterCutOff();
+				out << YAML::Key << "Range" << YAML::Value << dynamic_cast<SpotLight*>(pl.light.get())->GetRange();
+				out << YAML::Key << "CastShadows" << YAML::Value << pl.light->GetCastShadows();
 			default:
 				break;
 			}
@@ -246,6 +250,7 @@ namespace Syndra {
 
 	void SceneSerializer::Serialize(const std::string& filepath)
 	{
+		SN_PROFILE_FUNCTION();
 		YAML::Emitter out;
 
 		auto nameWithPost = filepath.substr(filepath.find_last_of("\\")+1);
@@ -280,6 +285,7 @@ namespace Syndra {
 
 	bool SceneSerializer::Deserialize(const std::string& filepath)
 	{
+		SN_PROFILE_FUNCTION();
 		YAML::Node data = YAML::LoadFile(filepath);
 		if (!data["Scene"])
 			return false;
@@ -359,12 +365,14 @@ namespace Syndra {
 					auto dir = std::filesystem::current_path();
 					auto& mc = deserializedEntity->AddComponent<MeshComponent>();
 					mc.path = meshComponent["Path"].as<std::string>();
+					if (meshComponent["Static"])
+						mc.isStatic = meshComponent["Static"].as<bool>();
 					auto filepath = mc.path;
 					if (mc.path.find("\\") == 0) {
 						filepath = dir.string() + mc.path;
 					}
 					if (!filepath.empty())
-						mc.model = Model(filepath);
+						mc.model = AssetManager::LoadModel(filepath);
 				}
 
 				auto lightComponent = entity["LightComponent"];
@@ -390,8 +398,14 @@ namespace Syndra {
 						auto pos = transformComponent["Translation"].as<glm::vec3>();
 						auto iCutOff = lightComponent["InnerCutOff"].as<float>();
 						auto oCutOff = lightComponent["OuterCutOff"].as<float>();
-						pl.light = CreateRef<SpotLight>(pl.light->GetColor(), intensity, pos, dir, iCutOff, oCutOff);
+						auto spot = CreateRef<SpotLight>(pl.light->GetColor(), intensity, pos, dir, iCutOff, oCutOff);
+						//Scenes saved before spot lights had a range keep the default one
+						if (lightComponent["Range"])
+							spot->SetRange(lightComponent["Range"].as<float>());
+						pl.light = spot;
 					}
+					if (lightComponent["CastShadows"])
+						pl.light->SetCastShadows(lightComponent["CastShadows"].as<bool>());
 					//TODO Area light
 
 				}
@@ -414,7 +428,7 @@ namespace Syndra {
 							auto binding = texture["binding"].as<uint32_t>();
 							auto texturePath = texture["path"].as<std::string>();
 							if (!texturePath.empty()) {
-								materialTextures[binding] = Texture2D::Create(texturePath);
+								materialTextures[binding] = AssetManager::LoadTexture(texturePath);
 							}
 						}
 					}
@@ -0,0 +1,71 @@
+#include "lpch.h"
+#include "Engine/Utils/FreeListAllocator.h"
+
+namespace Syndra {
+
+	FreeListAllocator::FreeListAllocator(uint32_t capacity)
+		:m_Capacity(capacity)
+	{
+		if (capacity > 0)
+			m_FreeRanges[0] = capacity;
+	}
+
+	uint32_t FreeListAllocator::Allocate(uint32_t size)
+	{
+		if (size == 0)
+			return InvalidOffset;
+
+		//First fit
+		for (auto it = m_FreeRanges.begin(); it != m_FreeRanges.end(); it++)
+		{
+			if (it->second < size)
+				continue;
+
+			uint32_t offset = it->first;
+			uint32_t remaining = it->second - size;
+			m_FreeRanges.erase(it);
+			if (remaining > 0)
+				m_FreeRanges[offset + size] = remaining;
+			m_Used += size;
+			return offset;
+		}
+		return InvalidOffset;
+	}
+
+	void FreeListAllocator::Free(uint32_t offset, uint32_t size)
+	{
+		if (offset == InvalidOffset || size == 0)
+			return;
+
+		m_Used -= size;
+		auto next = m_FreeRanges.lower_bound(offset);
+
+		//Merge with the following range
+		if (next != m_FreeRanges.end() && offset + size == next->first) {
+			size += next->second;
+			next = m_FreeRanges.erase(next);
+		}
+
+		//Merge with the preceding range
+		if (next != m_FreeRanges.begin()) {
+			auto prev = std::prev(next);
+			if (prev->first + prev->second == offset) {
+				prev->second += size;
+				return;
+			}
+		}
+		m_FreeRanges[offset] = size;
+	}
+
+	void FreeListAllocator::Grow(uint32_t newCapacity)
+	{
+		if (newCapacity <= m_Capacity)
+			return;
+
+		uint32_t oldCapacity = m_Capacity;
+		m_Capacity = newCapacity;
+		m_Used += newCapacity - oldCapacity;
+		Free(oldCapacity, newCapacity - oldCapacity);
+	}
+
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <map>
+
+namespace Syndra {
+
+	//Hands out [offset, offset + size) ranges of a linear resource (buffer elements, atlas rows...).
+	//Free ranges are kept sorted by offset so neighbours can be merged back on release.
+	class FreeListAllocator
+	{
+	public:
+		static constexpr uint32_t InvalidOffset = UINT32_MAX;
+
+		FreeListAllocator() = default;
+		FreeListAllocator(uint32_t capacity);
+
+		//Returns InvalidOffset if no free range is large enough
+		uint32_t Allocate(uint32_t size);
+		void Free(uint32_t offset, uint32_t size);
+
+		//Extends the managed range, existing allocations stay where they are
+		void Grow(uint32_t newCapacity);
+
+		uint32_t GetCapacity() const { return m_Capacity; }
+		uint32_t GetUsed() const { return m_Used; }
+
+	private:
+		//offset -> size
+		std::map<uint32_t, uint32_t> m_FreeRanges;
+		uint32_t m_Capacity = 0;
+		uint32_t m_Used = 0;
+	};
+
+}
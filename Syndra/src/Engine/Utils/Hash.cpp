@@ -0,0 +1,25 @@
+#include "lpch.h"
+#include "Engine/Utils/Hash.h"
+
+#include <fstream>
+
+namespace Syndra::Hash {
+
+	uint64_t HashFile(const std::string& path)
+	{
+		SN_PROFILE_FUNCTION();
+
+		std::ifstream in(path, std::ios::in | std::ios::binary);
+		if (!in)
+			return 0;
+		uint64_t hash = FNVOffset;
+		std::vector<char> chunk(1 << 20);
+		while (in)
+		{
+			in.read(chunk.data(), chunk.size());
+			hash = FNV1a(chunk.data(), (size_t)in.gcount(), hash);
+		}
+		return hash;
+	}
+
+}
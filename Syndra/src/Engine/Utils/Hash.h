@@ -0,0 +1,30 @@
+#pragma once
+
+namespace Syndra::Hash {
+
+	static constexpr uint64_t FNVOffset = 14695981039346656037ull;
+	static constexpr uint64_t FNVPrime = 1099511628211ull;
+
+	//64 bit FNV-1a, pass the previous result as hash to continue it over more data
+	inline uint64_t FNV1a(const void* data, size_t size, uint64_t hash = FNVOffset)
+	{
+		auto bytes = (const uint8_t*)data;
+		for (size_t i = 0; i < size; i++)
+		{
+			hash ^= bytes[i];
+			hash *= FNVPrime;
+		}
+		return hash;
+	}
+
+	//Continues the hash over the bytes of a plain value
+	template<typename T>
+	inline uint64_t Combine(uint64_t hash, const T& value)
+	{
+		return FNV1a(&value, sizeof(T), hash);
+	}
+
+	//FNV-1a of the whole file content, read in chunks. Zero when the file cannot be read.
+	uint64_t HashFile(const std::string& path);
+
+}
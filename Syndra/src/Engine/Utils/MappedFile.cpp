@@ -0,0 +1,76 @@
+#include "lpch.h"
+#include "Engine/Utils/MappedFile.h"
+
+#ifndef SN_PLATFORM_WINDOWS
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Syndra {
+
+#ifdef SN_PLATFORM_WINDOWS
+
+	MappedFile::MappedFile(const std::string& path)
+	{
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return;
+		LARGE_INTEGER size;
+		HANDLE mapping = nullptr;
+		if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+			mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mapping) {
+			CloseHandle(file);
+			return;
+		}
+		m_Data = (const uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (!m_Data) {
+			CloseHandle(mapping);
+			CloseHandle(file);
+			return;
+		}
+		m_Size = (size_t)size.QuadPart;
+		m_File = file;
+		m_Mapping = mapping;
+	}
+
+	MappedFile::~MappedFile()
+	{
+		if (m_Data)
+			UnmapViewOfFile(m_Data);
+		if (m_Mapping)
+			CloseHandle(m_Mapping);
+		if (m_File)
+			CloseHandle(m_File);
+	}
+
+#else
+
+	MappedFile::MappedFile(const std::string& path)
+	{
+		int file = open(path.c_str(), O_RDONLY);
+		if (file == -1)
+			return;
+		struct stat info;
+		if (fstat(file, &info) == 0 && info.st_size > 0) {
+			void* data = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+			if (data != MAP_FAILED) {
+				m_Data = (const uint8_t*)data;
+				m_Size = (size_t)info.st_size;
+			}
+		}
+		//The mapping keeps its own reference to the file
+		close(file);
+	}
+
+	MappedFile::~MappedFile()
+	{
+		if (m_Data)
+			munmap((void*)m_Data, m_Size);
+	}
+
+#endif
+
+}
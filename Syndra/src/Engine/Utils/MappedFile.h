@@ -0,0 +1,29 @@
+#pragma once
+
+namespace Syndra {
+
+	//Read only view of a whole file, the pages are loaded by the OS as they are touched
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		MappedFile(const std::string& path);
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		bool IsOpen() const { return m_Data != nullptr; }
+		const uint8_t* GetData() const { return m_Data; }
+		size_t GetSize() const { return m_Size; }
+
+	private:
+		const uint8_t* m_Data = nullptr;
+		size_t m_Size = 0;
+#ifdef SN_PLATFORM_WINDOWS
+		void* m_File = nullptr;
+		void* m_Mapping = nullptr;
+#endif
+	};
+
+}
@@ -78,4 +78,45 @@ namespace Syndra::Math {
 		return true;
 	}
 
-}
\ No newline at end of file
+	AABB AABB::Transform(const glm::mat4& transform) const
+	{
+		//Transform center and extents, the new extents are the absolute projections on each axis
+		glm::vec3 center = glm::vec3(transform * glm::vec4(GetCenter(), 1.0f));
+		glm::vec3 extents = GetExtents();
+		glm::mat3 m = glm::mat3(transform);
+		glm::vec3 newExtents = glm::abs(m[0]) * extents.x + glm::abs(m[1]) * extents.y + glm::abs(m[2]) * extents.z;
+		return AABB(center - newExtents, center + newExtents);
+	}
+
+	Frustum::Frustum(const glm::mat4& viewProjection)
+	{
+		//Gribb/Hartmann plane extraction, rows of the matrix combined for an OpenGL clip space
+		glm::mat4 m = glm::transpose(viewProjection);
+		Planes[0] = m[3] + m[0]; // left
+		Planes[1] = m[3] - m[0]; // right
+		Planes[2] = m[3] + m[1]; // bottom
+		Planes[3] = m[3] - m[1]; // top
+		Planes[4] = m[3] + m[2]; // near
+		Planes[5] = m[3] - m[2]; // far
+		for (auto& plane : Planes)
+		{
+			plane /= glm::length(glm::vec3(plane));
+		}
+	}
+
+	bool Frustum::Intersects(const AABB& box) const
+	{
+		//The box is outside if its most positive vertex is behind any plane
+		for (auto& plane : Planes)
+		{
+			glm::vec3 positive = glm::vec3(
+				plane.x >= 0.0f ? box.Max.x : box.Min.x,
+				plane.y >= 0.0f ? box.Max.y : box.Min.y,
+				plane.z >= 0.0f ? box.Max.z : box.Min.z);
+			if (glm::dot(glm::vec3(plane), positive) + plane.w < 0.0f)
+				return false;
+		}
+		return true;
+	}
+
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <glm/glm.hpp>
+#include <cfloat>
 
 namespace Syndra::Math {
 
@@ -18,4 +19,39 @@ namespace Syndra::Math {
 	//************************************
 	bool DecomposeTransform(const glm::mat4& transform, glm::vec3& translation, glm::vec3& rotation, glm::vec3& scale);
 
+	//Axis aligned bounding box, an empty box has Min > Max
+	struct AABB
+	{
+		glm::vec3 Min = glm::vec3(FLT_MAX);
+		glm::vec3 Max = glm::vec3(-FLT_MAX);
+
+		AABB() = default;
+		AABB(const glm::vec3& min, const glm::vec3& max) :Min(min), Max(max) {}
+
+		void Expand(const glm::vec3& point) { Min = glm::min(Min, point); Max = glm::max(Max, point); }
+		void Expand(const AABB& box) { Min = glm::min(Min, box.Min); Max = glm::max(Max, box.Max); }
+
+		bool IsValid() const { return Min.x <= Max.x && Min.y <= Max.y && Min.z <= Max.z; }
+		glm::vec3 GetCenter() const { return (Min + Max) * 0.5f; }
+		glm::vec3 GetExtents() const { return (Max - Min) * 0.5f; }
+		bool Intersects(const AABB& box) const
+		{
+			return Min.x <= box.Max.x && box.Min.x <= Max.x && Min.y <= box.Max.y && box.Min.y <= Max.y && Min.z <= box.Max.z && box.Min.z <= Max.z;
+		}
+
+		//Bounds of the transformed box
+		AABB Transform(const glm::mat4& transform) const;
+	};
+
+	//Six planes (xyz normal pointing inside, w distance) extracted from a view projection matrix
+	struct Frustum
+	{
+		glm::vec4 Planes[6];
+
+		Frustum() = default;
+		Frustum(const glm::mat4& viewProjection);
+
+		bool Intersects(const AABB& box) const;
+	};
+
 }
\ No newline at end of file
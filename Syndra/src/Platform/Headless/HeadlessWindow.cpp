@@ -0,0 +1,50 @@
+#include "lpch.h"
+#include "Platform/Headless/HeadlessWindow.h"
+
+#include "Platform/OpenGL/OpenGLContext.h"
+#include "Platform/OpenGL/OpenGLHeadlessContext.h"
+
+#include <GLFW/glfw3.h>
+
+namespace Syndra {
+
+	HeadlessWindow::HeadlessWindow(const WindowProps& props)
+		:m_Title(props.Title), m_Width(props.Width), m_Height(props.Height)
+	{
+		SN_PROFILE_FUNCTION();
+
+		SN_CORE_INFO("Creating headless window {0} ({1}, {2})", props.Title, props.Width, props.Height);
+#ifdef SN_PLATFORM_LINUX
+		m_Context = CreateScope<OpenGLHeadlessContext>();
+#else
+		//Without EGL an invisible window provides the context
+		glfwInit();
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 5);
+		glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+		m_Window = glfwCreateWindow((int)props.Width, (int)props.Height, m_Title.c_str(), nullptr, nullptr);
+		m_Context = CreateScope<OpenGLContext>(m_Window);
+#endif
+		m_Context->Init();
+	}
+
+	HeadlessWindow::~HeadlessWindow()
+	{
+		SN_PROFILE_FUNCTION();
+
+		m_Context.reset();
+		if (m_Window) {
+			glfwDestroyWindow(m_Window);
+			glfwTerminate();
+		}
+	}
+
+	void HeadlessWindow::OnUpdate()
+	{
+		SN_PROFILE_FUNCTION();
+
+		m_Context->SwapBuffers();
+	}
+
+}
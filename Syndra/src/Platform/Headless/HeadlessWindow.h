@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Engine/Core/Window.h"
+#include "Engine/Renderer/GraphicsContext.h"
+
+struct GLFWwindow;
+
+namespace Syndra {
+
+	//Window without anything on screen for batch runs (benchmarks, thumbnails). It only owns the context,
+	//the renderer draws into its framebuffers as usual and nothing is presented. No input events are sent.
+	class HeadlessWindow : public Window
+	{
+	public:
+		HeadlessWindow(const WindowProps& props);
+		virtual ~HeadlessWindow();
+
+		void OnUpdate() override;
+
+		uint32_t GetWidth() const override { return m_Width; }
+		uint32_t GetHeight() const override { return m_Height; }
+
+		void SetEventCallback(const EventCallbackFn& callback) override { m_EventCallback = callback; }
+		void SetVSync(bool enabled) override {}
+		bool IsVSync() const override { return false; }
+
+		//Null on Linux, the hidden GLFW window elsewhere
+		virtual void* GetNativeWindow() const override { return m_Window; }
+
+		virtual void SetTitle(const std::string& title) override { m_Title = title; }
+
+	private:
+		std::string m_Title;
+		uint32_t m_Width, m_Height;
+		EventCallbackFn m_EventCallback;
+		GLFWwindow* m_Window = nullptr;
+		Scope<GraphicsContext> m_Context;
+	};
+
+}
@@ -1,5 +1,6 @@
 #include "lpch.h"
 #include "Platform/OpenGL/OpenGLFrameBuffer.h"
+#include "Platform/OpenGL/OpenGLStateCache.h"
 #include <glad/glad.h>
 
 namespace Syndra {
@@ -18,16 +19,19 @@ namespace Syndra {
 
 	static void BindTexture(bool multisampled, uint32_t id)
 	{
-		glBindTexture(TextureTarget(multisampled), id);
+		OpenGLStateCache::BindTexture(TextureTarget(multisampled), id);
 	}
 
 	static GLenum TextureFormatToGL(FramebufferTextureFormat format)
 	{
 		switch (format)
 		{
-		case FramebufferTextureFormat::RGBA8:       return GL_RGBA8;
-		case FramebufferTextureFormat::RGBA16F:       return GL_RGB16F;
-		case FramebufferTextureFormat::RED_INTEGER: return GL_RED_INTEGER;
+		case FramebufferTextureFormat::RGBA8:        return GL_RGBA8;
+		case FramebufferTextureFormat::RGBA16F:      return GL_RGBA16F;
+		case FramebufferTextureFormat::RG16:         return GL_RG16;
+		case FramebufferTextureFormat::SRGB8_ALPHA8: return GL_SRGB8_ALPHA8;
+		case FramebufferTextureFormat::RG16F:        return GL_RG16F;
+		case FramebufferTextureFormat::RED_INTEGER:  return GL_RED_INTEGER;
 		}
 
 		SN_CORE_ASSERT(false, "Framebuffer texture format should be defined!");
@@ -43,7 +47,7 @@ namespace Syndra {
 		}
 		else
 		{
-			glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, internalFormat==GL_RGBA16F ? GL_FLOAT : GL_UNSIGNED_BYTE, nullptr);
+			glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, (internalFormat == GL_RGBA16F || internalFormat == GL_RG16F) ? GL_FLOAT : GL_UNSIGNED_BYTE, nullptr);
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
@@ -82,6 +86,23 @@ namespace Syndra {
 		glFramebufferTexture2D(GL_FRAMEBUFFER, attachmentType, TextureTarget(multisampled), id, 0);
 	}
 
+	static void AttachDepthTextureArray(uint32_t id, GLenum format, GLenum attachmentType, uint32_t width, uint32_t height, uint32_t layers)
+	{
+		glTextureStorage3D(id, 1, format, width, height, layers);
+		glTextureParameteri(id, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTextureParameteri(id, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTextureParameteri(id, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(id, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+		//The first layer is attached, passes select the one they render with BindDepthLayer
+		glFramebufferTextureLayer(GL_FRAMEBUFFER, attachmentType, id, 0, 0);
+	}
+
+	static GLenum DepthAttachmentType(FramebufferTextureFormat format)
+	{
+		return format == FramebufferTextureFormat::DEPTH24STENCIL8 ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+	}
+
 	static bool IsDepthFormat(FramebufferTextureFormat format)
 	{
 		switch (format)
@@ -125,25 +146,25 @@ namespace Syndra {
 
 	OpenGLFrameBuffer::~OpenGLFrameBuffer()
 	{
-		glDeleteFramebuffers(1, &m_RendererID);
-		glDeleteTextures(m_ColorAttachments.size(), m_ColorAttachments.data());
-		glDeleteTextures(1, &m_DepthAttachment);
+		OpenGLStateCache::DeleteFramebuffer(m_RendererID);
+		OpenGLStateCache::DeleteTextures((uint32_t)m_ColorAttachments.size(), m_ColorAttachments.data());
+		OpenGLStateCache::DeleteTextures(1, &m_DepthAttachment);
 	}
 
 	void OpenGLFrameBuffer::Invalidate()
 	{
 		if (m_RendererID)
 		{
-			glDeleteFramebuffers(1, &m_RendererID);
-			glDeleteTextures(m_ColorAttachments.size(), m_ColorAttachments.data());
-			glDeleteTextures(1, &m_DepthAttachment);
+			OpenGLStateCache::DeleteFramebuffer(m_RendererID);
+			OpenGLStateCache::DeleteTextures((uint32_t)m_ColorAttachments.size(), m_ColorAttachments.data());
+			OpenGLStateCache::DeleteTextures(1, &m_DepthAttachment);
 
 			m_ColorAttachments.clear();
 			m_DepthAttachment = 0;
 		}
 
 		glCreateFramebuffers(1, &m_RendererID);
-		glBindFramebuffer(GL_FRAMEBUFFER, m_RendererID);
+		OpenGLStateCache::BindFramebuffer(GL_FRAMEBUFFER, m_RendererID);
 
 		bool multisample = m_Specification.Samples > 1;
 
@@ -161,7 +182,16 @@ namespace Syndra {
 					AttachColorTexture(m_ColorAttachments[i], m_Specification.Samples, GL_RGBA8, GL_RGBA, m_Specification.Width, m_Specification.Height, i);
 					break;
 				case FramebufferTextureFormat::RGBA16F:
-					AttachColorTexture(m_ColorAttachments[i], m_Specification.Samples, GL_RGB16F, GL_RGBA, m_Specification.Width, m_Specification.Height, i);
+					AttachColorTexture(m_ColorAttachments[i], m_Specification.Samples, GL_RGBA16F, GL_RGBA, m_Specification.Width, m_Specification.Height, i);
+					break;
+				case FramebufferTextureFormat::RG16:
+					AttachColorTexture(m_ColorAttachments[i], m_Specification.Samples, GL_RG16, GL_RG, m_Specification.Width, m_Specification.Height, i);
+					break;
+				case FramebufferTextureFormat::SRGB8_ALPHA8:
+					AttachColorTexture(m_ColorAttachments[i], m_Specification.Samples, GL_SRGB8_ALPHA8, GL_RGBA, m_Specification.Width, m_Specification.Height, i);
+					break;
+				case FramebufferTextureFormat::RG16F:
+					AttachColorTexture(m_ColorAttachments[i], m_Specification.Samples, GL_RG16F, GL_RG, m_Specification.Width, m_Specification.Height, i);
 					break;
 				case FramebufferTextureFormat::RED_INTEGER:
 					AttachColorTexture(m_ColorAttachments[i], m_Specification.Samples, GL_R32I, GL_RED_INTEGER, m_Specification.Width, m_Specification.Height, i);
@@ -170,7 +200,15 @@ namespace Syndra {
 			}
 		}
 
-		if (m_DepthAttachmentSpecification.TextureFormat != FramebufferTextureFormat::None)
+		if (m_DepthAttachmentSpecification.TextureFormat != FramebufferTextureFormat::None && m_Specification.Layers > 0)
+		{
+			SN_CORE_ASSERT(!multisample, "Layered framebuffers can not be multisampled");
+			glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &m_DepthAttachment);
+			auto format = m_DepthAttachmentSpecification.TextureFormat;
+			AttachDepthTextureArray(m_DepthAttachment, format == FramebufferTextureFormat::DEPTH32 ? GL_DEPTH_COMPONENT32F : GL_DEPTH24_STENCIL8,
+				DepthAttachmentType(format), m_Specification.Width, m_Specification.Height, m_Specification.Layers);
+		}
+		else if (m_DepthAttachmentSpecification.TextureFormat != FramebufferTextureFormat::None)
 		{
 			CreateTextures(multisample, 1, &m_DepthAttachment);
 			BindTexture(multisample, m_DepthAttachment);
@@ -188,7 +226,7 @@ namespace Syndra {
 		if (m_CubeMapAttachmentSpecification.TextureFormat != FramebufferTextureFormat::None) 
 		{
 			glCreateTextures(GL_TEXTURE_CUBE_MAP, 1, &m_CubemapAttachment);
-			glBindTexture(GL_TEXTURE_CUBE_MAP, m_CubemapAttachment);
+			OpenGLStateCache::BindTexture(GL_TEXTURE_CUBE_MAP, m_CubemapAttachment);
 			for (unsigned int i = 0; i < 6; ++i)
 			{
 				glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_DEPTH_COMPONENT, m_Specification.Width, m_Specification.Height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
@@ -215,18 +253,18 @@ namespace Syndra {
 		}
 
 		SN_CORE_ASSERT(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE, "Framebuffer is incomplete!");
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		OpenGLStateCache::BindFramebuffer(GL_FRAMEBUFFER, 0);
 	}
 
 	void OpenGLFrameBuffer::Bind()
 	{
-		glViewport(0, 0, m_Specification.Width, m_Specification.Height);
-		glBindFramebuffer(GL_FRAMEBUFFER, m_RendererID);
+		OpenGLStateCache::Viewport(0, 0, m_Specification.Width, m_Specification.Height);
+		OpenGLStateCache::BindFramebuffer(GL_FRAMEBUFFER, m_RendererID);
 	}
 
 	void OpenGLFrameBuffer::Unbind()
 	{
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		OpenGLStateCache::BindFramebuffer(GL_FRAMEBUFFER, 0);
 	}
 
 	void OpenGLFrameBuffer::Resize(uint32_t width, uint32_t height)
@@ -273,11 +311,27 @@ namespace Syndra {
 		return pixelData;
 	}
 
+	void OpenGLFrameBuffer::ReadPixels(uint32_t attachmentIndex, std::vector<uint8_t>& pixels)
+	{
+		SN_CORE_ASSERT(attachmentIndex < m_ColorAttachments.size(), "Attachment index should be less than size!");
+
+		//Float targets are clamped to [0, 1] by the conversion
+		pixels.resize((size_t)m_Specification.Width * m_Specification.Height * 4);
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		glGetTextureImage(m_ColorAttachments[attachmentIndex], 0, GL_RGBA, GL_UNSIGNED_BYTE, (GLsizei)pixels.size(), pixels.data());
+	}
+
 	void OpenGLFrameBuffer::BindCubemapFace(uint32_t index) const
 	{
 		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_CUBE_MAP_POSITIVE_X + index, m_CubemapAttachment, 0);
 	}
 
+	void OpenGLFrameBuffer::BindDepthLayer(uint32_t layer) const
+	{
+		SN_CORE_ASSERT(layer < m_Specification.Layers, "Depth layer index should be less than the layer count");
+		glNamedFramebufferTextureLayer(m_RendererID, DepthAttachmentType(m_DepthAttachmentSpecification.TextureFormat), m_DepthAttachment, 0, layer);
+	}
+
 	uint32_t OpenGLFrameBuffer::GetRendererID() const
 	{
 		return m_RendererID;
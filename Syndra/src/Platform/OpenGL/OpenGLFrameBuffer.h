@@ -24,8 +24,10 @@ namespace Syndra {
 
 
 		virtual int ReadPixel(uint32_t attachmentIndex, int x, int y) override;
+		virtual void ReadPixels(uint32_t attachmentIndex, std::vector<uint8_t>& pixels) override;
 
 		virtual void BindCubemapFace(uint32_t index) const override;
+		virtual void BindDepthLayer(uint32_t layer) const override;
 
 
 		virtual uint32_t GetRendererID() const override;
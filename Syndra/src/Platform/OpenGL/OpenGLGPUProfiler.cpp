@@ -0,0 +1,95 @@
+#include "lpch.h"
+#include "Platform/OpenGL/OpenGLGPUProfiler.h"
+
+#include <glad/glad.h>
+
+namespace Syndra {
+
+	OpenGLGPUProfiler::~OpenGLGPUProfiler()
+	{
+		for (auto& frame : m_Frames)
+		{
+			if (!frame.Pool.empty())
+				glDeleteQueries((GLsizei)frame.Pool.size(), frame.Pool.data());
+		}
+	}
+
+	void OpenGLGPUProfiler::BeginFrame()
+	{
+		SN_CORE_ASSERT(m_Open.empty(), "GPU profiler pass was not ended");
+		m_Frame++;
+		//The slot was last written FrameLatency frames ago
+		auto& frame = m_Frames[m_Frame % FrameLatency];
+		Resolve(frame);
+		frame.Used = 0;
+		frame.Timers.clear();
+	}
+
+	void OpenGLGPUProfiler::BeginPass(const std::string& name)
+	{
+		glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, -1, name.c_str());
+		if (!m_Enabled)
+			return;
+
+		auto& frame = m_Frames[m_Frame % FrameLatency];
+		Timer timer;
+		timer.Name = name;
+		timer.Depth = (uint32_t)m_Open.size();
+		timer.Begin = AcquireQuery(frame);
+		timer.End = 0;
+		glQueryCounter(timer.Begin, GL_TIMESTAMP);
+		m_Open.push_back((uint32_t)frame.Timers.size());
+		frame.Timers.push_back(timer);
+	}
+
+	void OpenGLGPUProfiler::EndPass()
+	{
+		//Passes begun while the timers were off have nothing to end
+		if (!m_Open.empty()) {
+			auto& frame = m_Frames[m_Frame % FrameLatency];
+			auto& timer = frame.Timers[m_Open.back()];
+			m_Open.pop_back();
+			timer.End = AcquireQuery(frame);
+			glQueryCounter(timer.End, GL_TIMESTAMP);
+		}
+		glPopDebugGroup();
+	}
+
+	uint32_t OpenGLGPUProfiler::AcquireQuery(FrameQueries& frame)
+	{
+		if (frame.Used == frame.Pool.size()) {
+			uint32_t query;
+			glCreateQueries(GL_TIMESTAMP, 1, &query);
+			frame.Pool.push_back(query);
+		}
+		return frame.Pool[frame.Used++];
+	}
+
+	void OpenGLGPUProfiler::Resolve(FrameQueries& frame)
+	{
+		if (frame.Timers.empty())
+			return;
+
+		//Queries finish in order, the last one written tells whether the frame is done
+		GLint available = 0;
+		glGetQueryObjectiv(frame.Pool[frame.Used - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available) {
+			m_DroppedFrames++;
+			return;
+		}
+
+		float total = 0.0f;
+		for (auto& timer : frame.Timers)
+		{
+			GLuint64 begin = 0, end = 0;
+			glGetQueryObjectui64v(timer.Begin, GL_QUERY_RESULT, &begin);
+			glGetQueryObjectui64v(timer.End, GL_QUERY_RESULT, &end);
+			float milliseconds = (float)(end - begin) / 1000000.0f;
+			AddSample(timer.Name, milliseconds);
+			if (timer.Depth == 0)
+				total += milliseconds;
+		}
+		AddFrameSample(total);
+	}
+
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include "Engine/Renderer/GPUProfiler.h"
+
+namespace Syndra {
+
+	//Every pass writes a GL_TIMESTAMP query when it begins and ends, each frame in flight has its own query pool
+	class OpenGLGPUProfiler : public GPUProfiler
+	{
+	public:
+		OpenGLGPUProfiler() = default;
+		virtual ~OpenGLGPUProfiler();
+
+		virtual void BeginFrame() override;
+		virtual void BeginPass(const std::string& name) override;
+		virtual void EndPass() override;
+
+	private:
+		struct Timer
+		{
+			std::string Name;
+			uint32_t Depth;
+			uint32_t Begin, End;
+		};
+
+		struct FrameQueries
+		{
+			//Query objects are kept and reused, Used counts the ones written this frame
+			std::vector<uint32_t> Pool;
+			uint32_t Used = 0;
+			std::vector<Timer> Timers;
+		};
+
+		uint32_t AcquireQuery(FrameQueries& frame);
+		void Resolve(FrameQueries& frame);
+
+	private:
+		FrameQueries m_Frames[FrameLatency];
+		uint32_t m_Frame = 0;
+		//Timers of the current frame that were begun and not ended yet
+		std::vector<uint32_t> m_Open;
+	};
+
+}
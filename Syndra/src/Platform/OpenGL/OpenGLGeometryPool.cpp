@@ -0,0 +1,125 @@
+#include "lpch.h"
+#include "Platform/OpenGL/OpenGLGeometryPool.h"
+#include "Platform/OpenGL/OpenGLStateCache.h"
+#include <glad/glad.h>
+
+namespace Syndra {
+
+	static GLenum ShaderDataTypeToOpenGLBaseType(ShaderDataType type)
+	{
+		switch (type)
+		{
+		case ShaderDataType::Float:    return GL_FLOAT;
+		case ShaderDataType::Float2:   return GL_FLOAT;
+		case ShaderDataType::Float3:   return GL_FLOAT;
+		case ShaderDataType::Float4:   return GL_FLOAT;
+		case ShaderDataType::Int:      return GL_INT;
+		case ShaderDataType::Int2:     return GL_INT;
+		case ShaderDataType::Int3:     return GL_INT;
+		case ShaderDataType::Int4:     return GL_INT;
+		case ShaderDataType::Bool:     return GL_UNSIGNED_BYTE;
+		}
+		SN_CORE_ASSERT(false, "ShaderDataType not supported by the geometry pool!");
+		return 0;
+	}
+
+	static uint32_t CreateBuffer(uint32_t size)
+	{
+		uint32_t buffer;
+		glCreateBuffers(1, &buffer);
+		glNamedBufferStorage(buffer, size, nullptr, GL_DYNAMIC_STORAGE_BIT);
+		return buffer;
+	}
+
+	OpenGLGeometryPool::OpenGLGeometryPool(const BufferLayout& layout, uint32_t vertexCapacity, uint32_t indexCapacity)
+		:m_Layout(layout), m_Vertices(vertexCapacity), m_Indices(indexCapacity)
+	{
+		m_VertexBufferID = CreateBuffer(vertexCapacity * layout.GetStride());
+		m_IndexBufferID = CreateBuffer(indexCapacity * sizeof(uint32_t));
+
+		glCreateVertexArrays(1, &m_VertexArrayID);
+		uint32_t index = 0;
+		for (const auto& element : m_Layout)
+		{
+			glEnableVertexArrayAttrib(m_VertexArrayID, index);
+			GLenum type = ShaderDataTypeToOpenGLBaseType(element.Type);
+			if (type == GL_FLOAT || element.Normalized)
+				glVertexArrayAttribFormat(m_VertexArrayID, index, element.GetComponentCount(), type, element.Normalized ? GL_TRUE : GL_FALSE, (uint32_t)element.Offset);
+			else
+				glVertexArrayAttribIFormat(m_VertexArrayID, index, element.GetComponentCount(), type, (uint32_t)element.Offset);
+			glVertexArrayAttribBinding(m_VertexArrayID, index, 0);
+			index++;
+		}
+		glVertexArrayVertexBuffer(m_VertexArrayID, 0, m_VertexBufferID, 0, m_Layout.GetStride());
+		glVertexArrayElementBuffer(m_VertexArrayID, m_IndexBufferID);
+	}
+
+	OpenGLGeometryPool::~OpenGLGeometryPool()
+	{
+		OpenGLStateCache::DeleteVertexArray(m_VertexArrayID);
+		glDeleteBuffers(1, &m_VertexBufferID);
+		glDeleteBuffers(1, &m_IndexBufferID);
+	}
+
+	void OpenGLGeometryPool::Bind() const
+	{
+		OpenGLStateCache::BindVertexArray(m_VertexArrayID);
+	}
+
+	Ref<GeometryAllocation> OpenGLGeometryPool::Allocate(const void* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount)
+	{
+		//Nothing to draw, the empty allocation owns no range of the pool
+		if (vertexCount == 0 || indexCount == 0)
+			return CreateRef<GeometryAllocation>(shared_from_this(), 0, 0, 0, 0);
+
+		uint32_t baseVertex = m_Vertices.Allocate(vertexCount);
+		if (baseVertex == FreeListAllocator::InvalidOffset) {
+			GrowVertexBuffer(m_Vertices.GetCapacity() + vertexCount);
+			baseVertex = m_Vertices.Allocate(vertexCount);
+		}
+		uint32_t firstIndex = m_Indices.Allocate(indexCount);
+		if (firstIndex == FreeListAllocator::InvalidOffset) {
+			GrowIndexBuffer(m_Indices.GetCapacity() + indexCount);
+			firstIndex = m_Indices.Allocate(indexCount);
+		}
+
+		uint32_t stride = m_Layout.GetStride();
+		glNamedBufferSubData(m_VertexBufferID, (GLintptr)baseVertex * stride, (GLsizeiptr)vertexCount * stride, vertices);
+		glNamedBufferSubData(m_IndexBufferID, (GLintptr)firstIndex * sizeof(uint32_t), (GLsizeiptr)indexCount * sizeof(uint32_t), indices);
+
+		return CreateRef<GeometryAllocation>(shared_from_this(), baseVertex, vertexCount, firstIndex, indexCount);
+	}
+
+	void OpenGLGeometryPool::Free(const GeometryAllocation& allocation)
+	{
+		m_Vertices.Free(allocation.GetBaseVertex(), allocation.GetVertexCount());
+		m_Indices.Free(allocation.GetFirstIndex(), allocation.GetIndexCount());
+	}
+
+	//The pool only grows, old content is copied on the GPU so meshes keep their offsets
+	void OpenGLGeometryPool::GrowVertexBuffer(uint32_t minCapacity)
+	{
+		uint32_t capacity = std::max(minCapacity, m_Vertices.GetCapacity() * 2);
+		uint32_t stride = m_Layout.GetStride();
+		uint32_t buffer = CreateBuffer(capacity * stride);
+		glCopyNamedBufferSubData(m_VertexBufferID, buffer, 0, 0, (GLsizeiptr)m_Vertices.GetCapacity() * stride);
+		glDeleteBuffers(1, &m_VertexBufferID);
+
+		m_VertexBufferID = buffer;
+		m_Vertices.Grow(capacity);
+		glVertexArrayVertexBuffer(m_VertexArrayID, 0, m_VertexBufferID, 0, stride);
+	}
+
+	void OpenGLGeometryPool::GrowIndexBuffer(uint32_t minCapacity)
+	{
+		uint32_t capacity = std::max(minCapacity, m_Indices.GetCapacity() * 2);
+		uint32_t buffer = CreateBuffer(capacity * sizeof(uint32_t));
+		glCopyNamedBufferSubData(m_IndexBufferID, buffer, 0, 0, (GLsizeiptr)m_Indices.GetCapacity() * sizeof(uint32_t));
+		glDeleteBuffers(1, &m_IndexBufferID);
+
+		m_IndexBufferID = buffer;
+		m_Indices.Grow(capacity);
+		glVertexArrayElementBuffer(m_VertexArrayID, m_IndexBufferID);
+	}
+
+}
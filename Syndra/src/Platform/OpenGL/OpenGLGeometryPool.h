@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Engine/Renderer/GeometryPool.h"
+#include "Engine/Utils/FreeListAllocator.h"
+
+namespace Syndra {
+
+	class OpenGLGeometryPool : public GeometryPool
+	{
+	public:
+		OpenGLGeometryPool(const BufferLayout& layout, uint32_t vertexCapacity, uint32_t indexCapacity);
+		virtual ~OpenGLGeometryPool();
+
+		virtual void Bind() const override;
+
+		virtual Ref<GeometryAllocation> Allocate(const void* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount) override;
+		virtual void Free(const GeometryAllocation& allocation) override;
+
+		virtual const BufferLayout& GetLayout() const override { return m_Layout; }
+		virtual uint32_t GetRendererID() const override { return m_VertexArrayID; }
+
+	private:
+		void GrowVertexBuffer(uint32_t minCapacity);
+		void GrowIndexBuffer(uint32_t minCapacity);
+
+	private:
+		BufferLayout m_Layout;
+		uint32_t m_VertexArrayID = 0;
+		uint32_t m_VertexBufferID = 0;
+		uint32_t m_IndexBufferID = 0;
+
+		FreeListAllocator m_Vertices;
+		FreeListAllocator m_Indices;
+	};
+
+}
@@ -0,0 +1,139 @@
+#include "lpch.h"
+#include "Platform/OpenGL/OpenGLHeadlessContext.h"
+
+#include <glad/glad.h>
+
+#ifdef SN_PLATFORM_LINUX
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+namespace Syndra {
+
+	//Headless runs have nobody to recover them, a context that cannot run the shaders stops the process
+	[[noreturn]] static void Fail(const char* message)
+	{
+		SN_CORE_ERROR(message);
+		SN_CORE_ASSERT(false, message);
+		std::abort();
+	}
+
+#ifdef SN_PLATFORM_LINUX
+
+	//Surfaceless Mesa needs neither a display server nor a GPU, the device platform picks the first GPU without a display
+	//and the default display is the last resort
+	static EGLDisplay GetHeadlessDisplay()
+	{
+		auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+		if (getPlatformDisplay) {
+			EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+			if (display != EGL_NO_DISPLAY && eglInitialize(display, nullptr, nullptr))
+				return display;
+
+			auto queryDevices = (PFNEGLQUERYDEVICESEXTPROC)eglGetProcAddress("eglQueryDevicesEXT");
+			if (queryDevices) {
+				EGLDeviceEXT devices[8];
+				EGLint deviceCount = 0;
+				queryDevices(8, devices, &deviceCount);
+				for (EGLint i = 0; i < deviceCount; i++)
+				{
+					display = getPlatformDisplay(EGL_PLATFORM_DEVICE_EXT, devices[i], nullptr);
+					if (display != EGL_NO_DISPLAY && eglInitialize(display, nullptr, nullptr))
+						return display;
+				}
+			}
+		}
+
+		EGLDisplay display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+		if (display != EGL_NO_DISPLAY && eglInitialize(display, nullptr, nullptr))
+			return display;
+		return EGL_NO_DISPLAY;
+	}
+
+	OpenGLHeadlessContext::~OpenGLHeadlessContext()
+	{
+		if (!m_Display)
+			return;
+		eglMakeCurrent(m_Display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		if (m_Context)
+			eglDestroyContext(m_Display, m_Context);
+		eglTerminate(m_Display);
+	}
+
+	void OpenGLHeadlessContext::Init()
+	{
+		EGLDisplay display = GetHeadlessDisplay();
+		if (display == EGL_NO_DISPLAY)
+			Fail("Could not initialize an EGL display for headless rendering");
+		m_Display = display;
+
+		const char* extensions = eglQueryString(display, EGL_EXTENSIONS);
+		if (!extensions || !strstr(extensions, "EGL_KHR_surfaceless_context"))
+			SN_CORE_WARN("EGL_KHR_surfaceless_context is not reported, making the context current may fail");
+
+		eglBindAPI(EGL_OPENGL_API);
+		//No surface is created, any config able to render OpenGL will do
+		const EGLint configAttributes[] = {
+			EGL_SURFACE_TYPE, 0,
+			EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+			EGL_NONE
+		};
+		EGLConfig config;
+		EGLint configCount = 0;
+		if (!eglChooseConfig(display, configAttributes, &config, 1, &configCount) || configCount == 0)
+			Fail("No EGL config supports OpenGL");
+
+		//4.6 is preferred, llvmpipe stops at 4.5 and is only usable when it has GL_ARB_shader_draw_parameters
+		for (EGLint minor : { 6, 5 })
+		{
+			const EGLint contextAttributes[] = {
+				EGL_CONTEXT_MAJOR_VERSION, 4,
+				EGL_CONTEXT_MINOR_VERSION, minor,
+				EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+				EGL_NONE
+			};
+			m_Context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+			if (m_Context != EGL_NO_CONTEXT)
+				break;
+			m_Context = nullptr;
+		}
+		if (!m_Context)
+			Fail("Could not create an OpenGL 4.5 context through EGL");
+
+		if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, m_Context))
+			Fail("Could not make the headless context current");
+		if (!gladLoadGLLoader((GLADloadproc)eglGetProcAddress))
+			Fail("Failed to initialize Glad!");
+
+		//The shaders read gl_BaseInstance, which is core in 4.6 and an extension before
+		if (GLVersion.major == 4 && GLVersion.minor < 6) {
+			bool drawParameters = false;
+			GLint extensionCount = 0;
+			glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+			for (GLint i = 0; i < extensionCount && !drawParameters; i++)
+				drawParameters = strcmp((const char*)glGetStringi(GL_EXTENSIONS, i), "GL_ARB_shader_draw_parameters") == 0;
+			if (!drawParameters)
+				Fail("The headless context needs OpenGL 4.6 or GL_ARB_shader_draw_parameters");
+		}
+		SN_CORE_INFO("Headless OpenGL context: {0} ({1})", (const char*)glGetString(GL_RENDERER), (const char*)glGetString(GL_VERSION));
+	}
+
+#else
+
+	OpenGLHeadlessContext::~OpenGLHeadlessContext()
+	{
+	}
+
+	void OpenGLHeadlessContext::Init()
+	{
+		Fail("EGL headless contexts are only available on Linux");
+	}
+
+#endif
+
+	void OpenGLHeadlessContext::SwapBuffers()
+	{
+		glFlush();
+	}
+
+}
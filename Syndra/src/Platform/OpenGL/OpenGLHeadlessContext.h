@@ -0,0 +1,23 @@
+#pragma once
+#include "Engine/Renderer/GraphicsContext.h"
+
+namespace Syndra {
+
+	//OpenGL context without a window or swapchain, everything is drawn into framebuffers.
+	//Uses an EGL surfaceless context, which Mesa's llvmpipe provides on machines without a GPU or display.
+	class OpenGLHeadlessContext : public GraphicsContext
+	{
+	public:
+		OpenGLHeadlessContext() = default;
+		virtual ~OpenGLHeadlessContext();
+
+		virtual void Init() override;
+		//Nothing is presented, the queued commands are only flushed
+		virtual void SwapBuffers() override;
+
+	private:
+		void* m_Display = nullptr;
+		void* m_Context = nullptr;
+	};
+
+}
@@ -1,5 +1,6 @@
 #include "lpch.h"
 #include "Platform/OpenGL/OpenGLRendererAPI.h"
+#include "Platform/OpenGL/OpenGLStateCache.h"
 #include "glad/glad.h"
 
 namespace Syndra {
@@ -43,7 +44,7 @@ namespace Syndra {
 		glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
 		//glCullFace(GL_FRONT);
 		//glEnable(GL_CULL_FACE);
-		glEnable(GL_DEPTH_TEST);
+		OpenGLStateCache::SetEnabled(GL_DEPTH_TEST, true);
 	}
 
 	static GLenum RenderStateToGLState(RenderState state)
@@ -54,12 +55,51 @@ namespace Syndra {
 		case RenderState::CULL:				return GL_CULL_FACE;
 		case RenderState::BLEND:			return GL_BLEND;
 		case RenderState::SRGB:             return GL_FRAMEBUFFER_SRGB;
+		case RenderState::SCISSOR:          return GL_SCISSOR_TEST;
+		case RenderState::STENCIL_TEST:     return GL_STENCIL_TEST;
 		}
 
 		SN_CORE_ASSERT(false, "Renderstate should be defined!");
 		return 0;
 	}
 
+	static GLenum DepthFuncToGLDepthFunc(DepthFunc func)
+	{
+		switch (func)
+		{
+		case DepthFunc::LESS:               return GL_LESS;
+		case DepthFunc::LEQUAL:             return GL_LEQUAL;
+		case DepthFunc::EQUAL:              return GL_EQUAL;
+		case DepthFunc::ALWAYS:             return GL_ALWAYS;
+		}
+
+		SN_CORE_ASSERT(false, "Depth function should be defined!");
+		return 0;
+	}
+
+	static GLenum StencilFuncToGLStencilFunc(StencilFunc func)
+	{
+		switch (func)
+		{
+		case StencilFunc::ALWAYS:           return GL_ALWAYS;
+		case StencilFunc::EQUAL:            return GL_EQUAL;
+		case StencilFunc::NOTEQUAL:         return GL_NOTEQUAL;
+		}
+
+		SN_CORE_ASSERT(false, "Stencil function should be defined!");
+		return 0;
+	}
+
+	static bool HasStencil(const FramebufferSpecification& spec)
+	{
+		for (auto& attachment : spec.Attachments.Attachments)
+		{
+			if (attachment.TextureFormat == FramebufferTextureFormat::DEPTH24STENCIL8)
+				return true;
+		}
+		return false;
+	}
+
 	void OpenGLRendererAPI::SetClearColor(const glm::vec4& color)
 	{
 		glClearColor(color.r, color.g, color.b, color.a);
@@ -67,7 +107,12 @@ namespace Syndra {
 
 	void OpenGLRendererAPI::Clear()
 	{
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+	}
+
+	void OpenGLRendererAPI::ClearColorBuffer()
+	{
+		glClear(GL_COLOR_BUFFER_BIT);
 	}
 
 	void OpenGLRendererAPI::DrawIndexed(const Ref<VertexArray>& vertexArray)
@@ -75,17 +120,100 @@ namespace Syndra {
 		uint32_t count = vertexArray->GetIndexBuffer()->GetCount();
 		
 		glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr);
-		glBindTexture(GL_TEXTURE_2D, 0);
+	}
+
+	void OpenGLRendererAPI::DrawIndexed(uint32_t indexCount, uint32_t firstIndex, uint32_t baseVertex)
+	{
+		glDrawElementsBaseVertex(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, (const void*)(firstIndex * sizeof(uint32_t)), baseVertex);
+	}
+
+	void OpenGLRendererAPI::MultiDrawIndexedIndirect(uint32_t drawCount, uint64_t offset)
+	{
+		glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (const void*)offset, drawCount, 0);
 	}
 
 	void OpenGLRendererAPI::SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height)
 	{
-		glViewport(x, y, width, height);
+		OpenGLStateCache::Viewport(x, y, width, height);
+	}
+
+	void OpenGLRendererAPI::SetScissor(uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+	{
+		glScissor(x, y, width, height);
 	}
 
 	void OpenGLRendererAPI::SetState(RenderState stateID, bool on)
 	{
-		on ? glEnable(RenderStateToGLState(stateID)) : glDisable(RenderStateToGLState(stateID));
+		OpenGLStateCache::SetEnabled(RenderStateToGLState(stateID), on);
+	}
+
+	void OpenGLRendererAPI::SetDepthFunc(DepthFunc func)
+	{
+		OpenGLStateCache::DepthFunc(DepthFuncToGLDepthFunc(func));
+	}
+
+	void OpenGLRendererAPI::SetDepthMask(bool write)
+	{
+		OpenGLStateCache::DepthMask(write);
+	}
+
+	void OpenGLRendererAPI::SetColorMask(bool write)
+	{
+		OpenGLStateCache::ColorMask(write);
+	}
+
+	void OpenGLRendererAPI::SetStencil(StencilFunc func, uint32_t reference, bool write)
+	{
+		OpenGLStateCache::StencilFunc(StencilFuncToGLStencilFunc(func), reference);
+		OpenGLStateCache::StencilPassOp(write ? GL_REPLACE : GL_KEEP);
+	}
+
+	//Named blit, it does not disturb the tracked framebuffer bindings. Stencil is copied along when both sides have it
+	void OpenGLRendererAPI::CopyDepth(const Ref<FrameBuffer>& source, const Ref<FrameBuffer>& destination)
+	{
+		auto& src = source->GetSpecification();
+		auto& dst = destination->GetSpecification();
+		GLbitfield mask = GL_DEPTH_BUFFER_BIT;
+		if (HasStencil(src) && HasStencil(dst))
+			mask |= GL_STENCIL_BUFFER_BIT;
+		glBlitNamedFramebuffer(source->GetRendererID(), destination->GetRendererID(),
+			0, 0, src.Width, src.Height, 0, 0, dst.Width, dst.Height, mask, GL_NEAREST);
+	}
+
+	void OpenGLRendererAPI::CopyDepth(const Ref<FrameBuffer>& source, const Ref<FrameBuffer>& destination, uint32_t sourceX, uint32_t sourceY,
+		uint32_t destinationX, uint32_t destinationY, uint32_t width, uint32_t height)
+	{
+		glBlitNamedFramebuffer(source->GetRendererID(), destination->GetRendererID(), sourceX, sourceY, sourceX + width, sourceY + height,
+			destinationX, destinationY, destinationX + width, destinationY + height, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+	}
+
+	void OpenGLRendererAPI::CopyColor(const Ref<FrameBuffer>& source, const Ref<FrameBuffer>& destination)
+	{
+		auto& src = source->GetSpecification();
+		auto& dst = destination->GetSpecification();
+		glBlitNamedFramebuffer(source->GetRendererID(), destination->GetRendererID(),
+			0, 0, src.Width, src.Height, 0, 0, dst.Width, dst.Height, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+	}
+
+	void OpenGLRendererAPI::StorageBarrier()
+	{
+		glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+	}
+
+	void OpenGLRendererAPI::InvalidateState()
+	{
+		OpenGLStateCache::Invalidate();
+	}
+
+	RenderStateStats OpenGLRendererAPI::GetStateStats()
+	{
+		auto& stats = OpenGLStateCache::GetStats();
+		return { stats.Issued, stats.Filtered };
+	}
+
+	void OpenGLRendererAPI::ResetStateStats()
+	{
+		OpenGLStateCache::ResetStats();
 	}
 
 	std::string OpenGLRendererAPI::GetRendererInfo()
@@ -11,9 +11,27 @@ namespace Syndra {
 		virtual void Init() override;
 		virtual void SetClearColor(const glm::vec4& color) override;
 		virtual void Clear() override;
+		virtual void ClearColorBuffer() override;
 		virtual void DrawIndexed(const Ref<VertexArray>& vertexArray) override;
+		virtual void DrawIndexed(uint32_t indexCount, uint32_t firstIndex, uint32_t baseVertex) override;
+		virtual void MultiDrawIndexedIndirect(uint32_t drawCount, uint64_t offset) override;
 		virtual void SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
+		virtual void SetScissor(uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
 		virtual void SetState(RenderState stateID, bool on) override;
+		virtual void SetDepthFunc(DepthFunc func) override;
+		virtual void SetDepthMask(bool write) override;
+		virtual void SetColorMask(bool write) override;
+		virtual void SetStencil(StencilFunc func, uint32_t reference, bool write) override;
+
+		virtual void CopyDepth(const Ref<FrameBuffer>& source, const Ref<FrameBuffer>& destination) override;
+		virtual void CopyDepth(const Ref<FrameBuffer>& source, const Ref<FrameBuffer>& destination, uint32_t sourceX, uint32_t sourceY,
+			uint32_t destinationX, uint32_t destinationY, uint32_t width, uint32_t height) override;
+		virtual void CopyColor(const Ref<FrameBuffer>& source, const Ref<FrameBuffer>& destination) override;
+		virtual void StorageBarrier() override;
+
+		virtual void InvalidateState() override;
+		virtual RenderStateStats GetStateStats() override;
+		virtual void ResetStateStats() override;
 
 		virtual std::string GetRendererInfo() override;
 
@@ -0,0 +1,146 @@
+#include "lpch.h"
+#include "Platform/OpenGL/OpenGLRingBuffer.h"
+#include <glad/glad.h>
+
+namespace Syndra {
+
+	static uint32_t AlignUp(uint32_t value, uint32_t alignment)
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	OpenGLRingBuffer::OpenGLRingBuffer(uint32_t regionSize, uint32_t regionCount)
+		:m_Fences(regionCount, nullptr)
+	{
+		GLint uniformAlignment = 0, storageAlignment = 0;
+		glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformAlignment);
+		glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &storageAlignment);
+		m_Alignment = std::max({ (uint32_t)uniformAlignment, (uint32_t)storageAlignment, 16u });
+
+		m_RegionSize = AlignUp(regionSize, m_Alignment);
+		CreateStorage();
+	}
+
+	OpenGLRingBuffer::~OpenGLRingBuffer()
+	{
+		for (auto fence : m_Fences)
+		{
+			if (fence)
+				glDeleteSync(fence);
+		}
+		for (auto& retired : m_Retired)
+		{
+			if (retired.Fence)
+				glDeleteSync(retired.Fence);
+			glDeleteBuffers(1, &retired.RendererID);
+		}
+		glDeleteBuffers(1, &m_RendererID);
+	}
+
+	void OpenGLRingBuffer::CreateStorage()
+	{
+		GLsizeiptr size = (GLsizeiptr)m_RegionSize * m_Fences.size();
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glCreateBuffers(1, &m_RendererID);
+		glNamedBufferStorage(m_RendererID, size, nullptr, flags);
+		m_MappedData = (uint8_t*)glMapNamedBufferRange(m_RendererID, 0, size, flags);
+		SN_CORE_ASSERT(m_MappedData, "Could not map the ring buffer!");
+	}
+
+	void OpenGLRingBuffer::Wait(GLsync fence)
+	{
+		GLenum result = glClientWaitSync(fence, 0, 0);
+		while (result == GL_TIMEOUT_EXPIRED)
+		{
+			//Flush on the first real wait so the fence is guaranteed to signal
+			result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+		}
+	}
+
+	void OpenGLRingBuffer::BeginFrame()
+	{
+		auto& fence = m_Fences[m_Region];
+		if (fence) {
+			Wait(fence);
+			glDeleteSync(fence);
+			fence = nullptr;
+		}
+		m_Head = 0;
+
+		for (auto it = m_Retired.begin(); it != m_Retired.end();)
+		{
+			if (it->Fence && glClientWaitSync(it->Fence, 0, 0) != GL_TIMEOUT_EXPIRED) {
+				glDeleteSync(it->Fence);
+				glDeleteBuffers(1, &it->RendererID);
+				it = m_Retired.erase(it);
+			}
+			else
+				++it;
+		}
+	}
+
+	void OpenGLRingBuffer::EndFrame()
+	{
+		GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		m_Fences[m_Region] = fence;
+		for (auto& retired : m_Retired)
+		{
+			if (!retired.Fence)
+				retired.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		}
+		m_Region = (m_Region + 1) % (uint32_t)m_Fences.size();
+	}
+
+	//A frame outgrew its region: move to a bigger buffer. Earlier allocations of this frame
+	//keep pointing into the old buffer, which is retired instead of deleted right away.
+	void OpenGLRingBuffer::Grow(uint32_t size)
+	{
+		SN_CORE_WARN("Ring buffer region of {0} bytes is too small, growing", m_RegionSize);
+		glUnmapNamedBuffer(m_RendererID);
+		m_Retired.push_back({ m_RendererID, nullptr });
+
+		//The new buffer is not used by the GPU yet
+		for (auto& fence : m_Fences)
+		{
+			if (fence) {
+				glDeleteSync(fence);
+				fence = nullptr;
+			}
+		}
+
+		m_RegionSize = AlignUp(std::max(m_RegionSize * 2, size), m_Alignment);
+		m_Head = 0;
+		CreateStorage();
+	}
+
+	RingAllocation OpenGLRingBuffer::Allocate(uint32_t size)
+	{
+		uint32_t alignedSize = AlignUp(size, m_Alignment);
+		if (m_Head + alignedSize > m_RegionSize)
+			Grow(alignedSize);
+
+		RingAllocation allocation;
+		allocation.Buffer = m_RendererID;
+		allocation.Offset = m_Region * m_RegionSize + m_Head;
+		allocation.Size = size;
+		allocation.Data = m_MappedData + allocation.Offset;
+		m_Head += alignedSize;
+		return allocation;
+	}
+
+	void OpenGLRingBuffer::BindUniform(const RingAllocation& allocation, uint32_t binding) const
+	{
+		glBindBufferRange(GL_UNIFORM_BUFFER, binding, allocation.Buffer, allocation.Offset, allocation.Size);
+	}
+
+	void OpenGLRingBuffer::BindStorage(const RingAllocation& allocation, uint32_t binding) const
+	{
+		glBindBufferRange(GL_SHADER_STORAGE_BUFFER, binding, allocation.Buffer, allocation.Offset, allocation.Size);
+	}
+
+	void OpenGLRingBuffer::BindIndirect(const RingAllocation& allocation) const
+	{
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, allocation.Buffer);
+	}
+
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Engine/Renderer/RingBuffer.h"
+
+typedef struct __GLsync* GLsync;
+
+namespace Syndra {
+
+	class OpenGLRingBuffer : public RingBuffer
+	{
+	public:
+		OpenGLRingBuffer(uint32_t regionSize, uint32_t regionCount);
+		virtual ~OpenGLRingBuffer();
+
+		virtual void BeginFrame() override;
+		virtual void EndFrame() override;
+
+		virtual RingAllocation Allocate(uint32_t size) override;
+
+		virtual void BindUniform(const RingAllocation& allocation, uint32_t binding) const override;
+		virtual void BindStorage(const RingAllocation& allocation, uint32_t binding) const override;
+		virtual void BindIndirect(const RingAllocation& allocation) const override;
+
+		virtual uint32_t GetRegionSize() const override { return m_RegionSize; }
+	private:
+		void CreateStorage();
+		void Grow(uint32_t size);
+		static void Wait(GLsync fence);
+	private:
+		uint32_t m_RendererID = 0;
+		uint8_t* m_MappedData = nullptr;
+		uint32_t m_RegionSize;
+		uint32_t m_Alignment = 256;
+
+		std::vector<GLsync> m_Fences;
+		uint32_t m_Region = 0;
+		uint32_t m_Head = 0;
+
+		//Buffers replaced by Grow, deleted once the frames that used them are done
+		struct RetiredBuffer
+		{
+			uint32_t RendererID;
+			GLsync Fence;
+		};
+		std::vector<RetiredBuffer> m_Retired;
+	};
+
+}
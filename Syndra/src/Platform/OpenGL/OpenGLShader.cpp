@@ -2,6 +2,7 @@
 #include <fstream>
 #include <glad/glad.h>
 #include "Platform/OpenGL/OpenGLShader.h"
+#include "Platform/OpenGL/OpenGLStateCache.h"
 #include "glm/gtc/type_ptr.hpp"
 
 #include <shaderc/shaderc.hpp>
@@ -17,6 +18,8 @@ namespace Syndra {
 			return GL_VERTEX_SHADER;
 		if (type == "fragment" || type == "pixel")
 			return GL_FRAGMENT_SHADER;
+		if (type == "compute")
+			return GL_COMPUTE_SHADER;
 
 		SN_CORE_ASSERT(false, "Unknown shader type!");
 		return 0;
@@ -28,6 +31,7 @@ namespace Syndra {
 		{
 		case GL_VERTEX_SHADER:   return shaderc_glsl_vertex_shader;
 		case GL_FRAGMENT_SHADER: return shaderc_glsl_fragment_shader;
+		case GL_COMPUTE_SHADER:  return shaderc_glsl_compute_shader;
 		}
 		SN_CORE_ASSERT(false, "Unknown shader type!");
 		return (shaderc_shader_kind)0;
@@ -39,11 +43,20 @@ namespace Syndra {
 		{
 		case GL_VERTEX_SHADER:   return "GL_VERTEX_SHADER";
 		case GL_FRAGMENT_SHADER: return "GL_FRAGMENT_SHADER";
+		case GL_COMPUTE_SHADER:  return "GL_COMPUTE_SHADER";
 		}
 		SN_CORE_ASSERT(false, "Unknown shader stage!");
 		return nullptr;
 	}
 
+	//GLSL version of the current context. Below 4.6 spirv_cross reads gl_BaseInstance through
+	//GL_ARB_shader_draw_parameters, which the context has to support.
+	static uint32_t GetGLSLVersion()
+	{
+		static uint32_t version = GLVersion.major > 4 || (GLVersion.major == 4 && GLVersion.minor >= 6) ? 460 : 450;
+		return version;
+	}
+
 	static const char* GetCacheDirectory()
 	{
 		return "assets/cache/shader/opengl";
@@ -62,6 +75,7 @@ namespace Syndra {
 		{
 		case GL_VERTEX_SHADER:    return ".cached_opengl.vert";
 		case GL_FRAGMENT_SHADER:  return ".cached_opengl.frag";
+		case GL_COMPUTE_SHADER:   return ".cached_opengl.comp";
 		}
 		SN_CORE_ASSERT(false, "Unknown shader stage!");
 		return "";
@@ -73,6 +87,7 @@ namespace Syndra {
 		{
 		case GL_VERTEX_SHADER:    return ".cached_vulkan.vert";
 		case GL_FRAGMENT_SHADER:  return ".cached_vulkan.frag";
+		case GL_COMPUTE_SHADER:   return ".cached_vulkan.comp";
 		}
 		SN_CORE_ASSERT(false, "Unknown shader stage!");
 		return "";
@@ -81,6 +96,7 @@ namespace Syndra {
 	OpenGLShader::OpenGLShader(const std::string& filepath)
 		: m_FilePath(filepath)
 	{
+		SN_PROFILE_FUNCTION();
 		CreateCacheDirectoryIfNeeded();
 
 		std::string source = ReadFile(filepath);
@@ -110,7 +126,7 @@ namespace Syndra {
 
 	OpenGLShader::~OpenGLShader()
 	{
-		glDeleteProgram(m_RendererID);
+		OpenGLStateCache::DeleteProgram(m_RendererID);
 	}
 
 	std::string OpenGLShader::ReadFile(const std::string& filepath)
@@ -165,8 +181,24 @@ namespace Syndra {
 		return shaderSources;
 	}
 
+	//Variants compiled with defines get their own cache files
+	std::string OpenGLShader::GetCacheFileName() const
+	{
+		std::string name = std::filesystem::path(m_FilePath).filename().string();
+		if (m_Defines.empty())
+			return name;
+
+		std::string defines;
+		for (auto& define : m_Defines)
+			defines += define + ";";
+		std::stringstream stream;
+		stream << name << "." << std::hex << std::hash<std::string>()(defines);
+		return stream.str();
+	}
+
 	void OpenGLShader::CompileOrGetVulkanBinaries(const std::unordered_map<GLenum, std::string>& shaderSources)
 	{
+		SN_PROFILE_FUNCTION();
 		GLuint program = glCreateProgram();
 
 		shaderc::Compiler compiler;
@@ -175,6 +207,8 @@ namespace Syndra {
 		const bool optimize = false;
 		if (optimize)
 			options.SetOptimizationLevel(shaderc_optimization_level_size);
+		for (auto& define : m_Defines)
+			options.AddMacroDefinition(define);
 
 		std::filesystem::path cacheDirectory = GetCacheDirectory();
 
@@ -182,8 +216,7 @@ namespace Syndra {
 		shaderData.clear();
 		for (auto&& [stage, source] : shaderSources)
 		{
-			std::filesystem::path shaderFilePath = m_FilePath;
-			std::filesystem::path cachedPath = cacheDirectory / (shaderFilePath.filename().string() + GLShaderStageCachedVulkanFileExtension(stage));
+			std::filesystem::path cachedPath = cacheDirectory / (GetCacheFileName() + GLShaderStageCachedVulkanFileExtension(stage));
 
 			std::ifstream in(cachedPath, std::ios::in | std::ios::binary);
 			if (in.is_open())
@@ -225,6 +258,7 @@ namespace Syndra {
 
 	void OpenGLShader::CompileOrGetOpenGLBinaries()
 	{
+		SN_PROFILE_FUNCTION();
 		auto& shaderData = m_OpenGLSPIRV;
 
 		std::filesystem::path cacheDirectory = GetCacheDirectory();
@@ -235,7 +269,7 @@ namespace Syndra {
 			spirv_cross::ShaderResources resources = glsl.get_shader_resources();
 			spirv_cross::CompilerGLSL::Options options;
 
-			options.version = 460;
+			options.version = GetGLSLVersion();
 			options.es = false;
 			glsl.set_common_options(options);
 	
@@ -321,7 +355,13 @@ namespace Syndra {
 
 	void OpenGLShader::Compile(const std::unordered_map<GLenum, std::string>& shaderSources)
 	{
+		SN_PROFILE_FUNCTION();
+		//Reloading replaces the previous program
+		if (m_RendererID)
+			OpenGLStateCache::DeleteProgram(m_RendererID);
+
 		GLuint program = glCreateProgram();
+		//A vertex and fragment pair, or a single compute shader
 		SN_CORE_ASSERT(shaderSources.size() <= 2, "Syndra only supports 2 shaders for now");
 		std::array<GLenum, 2> glShaderIDs;
 		int glShaderIDIndex = 0;
@@ -378,29 +418,88 @@ namespace Syndra {
 			// We don't need the program anymore.
 			glDeleteProgram(program);
 
-			for (auto id : glShaderIDs)
-				glDeleteShader(id);
+			for (int i = 0; i < glShaderIDIndex; i++)
+				glDeleteShader(glShaderIDs[i]);
 
 			SN_CORE_ERROR("{0}", infoLog.data());
 			SN_CORE_ASSERT(false, "Shader link failure!");
+			m_RendererID = 0;
 			return;
 		}
 
-		for (auto id : glShaderIDs)
+		for (int i = 0; i < glShaderIDIndex; i++)
+		{
+			glDetachShader(program, glShaderIDs[i]);
+			glDeleteShader(glShaderIDs[i]);
+		}
+
+		ReflectUniformLocations();
+	}
+
+	//Builds the location table of the linked program once, so setting a uniform never goes back to the driver
+	void OpenGLShader::ReflectUniformLocations()
+	{
+		m_UniformLocations.clear();
+
+		GLint uniformCount = 0, maxNameLength = 0;
+		glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORMS, &uniformCount);
+		glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+		std::vector<GLchar> nameBuffer(maxNameLength > 0 ? maxNameLength : 1);
+		for (GLint i = 0; i < uniformCount; i++)
 		{
-			glDetachShader(program, id);
-			glDeleteShader(id);
+			GLsizei length = 0;
+			glGetActiveUniformName(m_RendererID, i, (GLsizei)nameBuffer.size(), &length, nameBuffer.data());
+			std::string name(nameBuffer.data(), length);
+
+			//Uniforms inside uniform blocks have no location, every other active uniform must have one
+			GLint location = glGetUniformLocation(m_RendererID, name.c_str());
+			if (location == -1) {
+				GLuint index = (GLuint)i;
+				GLint block = -1;
+				glGetActiveUniformsiv(m_RendererID, 1, &index, GL_UNIFORM_BLOCK_INDEX, &block);
+				SN_CORE_ASSERT(block != -1, "Active uniform has no location");
+				continue;
+			}
+			m_UniformLocations[name] = location;
+
+			//Arrays are reported as "name[0]", allow setting them by their plain name as well
+			if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0)
+				m_UniformLocations[name.substr(0, name.size() - 3)] = location;
 		}
+
+		for (size_t i = 0; i < m_ParameterNames.size(); i++)
+			m_ParameterLocations[i] = GetUniformLocation(m_ParameterNames[i]);
+	}
+
+	int32_t OpenGLShader::GetUniformLocation(const std::string& name) const
+	{
+		auto it = m_UniformLocations.find(name);
+		//Inactive uniforms are not in the table, -1 makes glUniform* a no-op like the driver would
+		return it != m_UniformLocations.end() ? it->second : -1;
+	}
+
+	int32_t OpenGLShader::GetParameterIndex(const std::string& name)
+	{
+		auto it = m_ParameterIndices.find(name);
+		if (it != m_ParameterIndices.end())
+			return it->second;
+
+		int32_t index = (int32_t)m_ParameterNames.size();
+		m_ParameterIndices[name] = index;
+		m_ParameterNames.push_back(name);
+		m_ParameterLocations.push_back(GetUniformLocation(name));
+		return index;
 	}
 
 	void OpenGLShader::Bind() const
 	{
-		glUseProgram(m_RendererID);
+		OpenGLStateCache::UseProgram(m_RendererID);
 	}
 
 	void OpenGLShader::Unbind() const
 	{
-		glUseProgram(0);
+		OpenGLStateCache::UseProgram(0);
 	}
 
 	void OpenGLShader::SetInt(const std::string& name, int value)
@@ -435,68 +534,98 @@ namespace Syndra {
 
 	void OpenGLShader::UploadUniformInt(const std::string& name, int value)
 	{
-		GLint location = glGetUniformLocation(m_RendererID, name.c_str());
+		GLint location = GetUniformLocation(name);
 		glUniform1i(location, value);
 	}
 
 	void OpenGLShader::UploadUniformIntArray(const std::string& name, int* values, uint32_t count)
 	{
-		GLint location = glGetUniformLocation(m_RendererID, name.c_str());
+		GLint location = GetUniformLocation(name);
 		glUniform1iv(location, count, values);
 	}
 
 	void OpenGLShader::UploadUniformFloat(const std::string& name, float value)
 	{
-		GLint location = glGetUniformLocation(m_RendererID, name.c_str());
+		GLint location = GetUniformLocation(name);
 		glUniform1f(location, value);
 	}
 
 	void OpenGLShader::UploadUniformFloat2(const std::string& name, const glm::vec2& value)
 	{
-		GLint location = glGetUniformLocation(m_RendererID, name.c_str());
+		GLint location = GetUniformLocation(name);
 		glUniform2f(location, value.x, value.y);
 	}
 
 	void OpenGLShader::UploadUniformFloat3(const std::string& name, const glm::vec3& value)
 	{
-		GLint location = glGetUniformLocation(m_RendererID, name.c_str());
+		GLint location = GetUniformLocation(name);
 		glUniform3f(location, value.x, value.y, value.z);
 	}
 
 	void OpenGLShader::UploadUniformFloat4(const std::string& name, const glm::vec4& value)
 	{
-		GLint location = glGetUniformLocation(m_RendererID, name.c_str());
+		GLint location = GetUniformLocation(name);
 		glUniform4f(location, value.x, value.y, value.z, value.w);
 	}
 
 	void OpenGLShader::UploadUniformMat3(const std::string& name, const glm::mat3& matrix)
 	{
-		GLint location = glGetUniformLocation(m_RendererID, name.c_str());
+		GLint location = GetUniformLocation(name);
 		glUniformMatrix3fv(location, 1, GL_FALSE, glm::value_ptr(matrix));
 	}
 
 	void OpenGLShader::UploadUniformMat4(const std::string& name, const glm::mat4& matrix)
 	{
-		GLint location = glGetUniformLocation(m_RendererID, name.c_str());
+		GLint location = GetUniformLocation(name);
 		glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(matrix));
 	}
 
+	void OpenGLShader::Set(ShaderParameter<int> parameter, int value)
+	{
+		if (parameter.IsValid())
+			glUniform1i(m_ParameterLocations[parameter.Index], value);
+	}
+
+	void OpenGLShader::Set(ShaderParameter<float> parameter, float value)
+	{
+		if (parameter.IsValid())
+			glUniform1f(m_ParameterLocations[parameter.Index], value);
+	}
+
+	void OpenGLShader::Set(ShaderParameter<glm::vec3> parameter, const glm::vec3& value)
+	{
+		if (parameter.IsValid())
+			glUniform3f(m_ParameterLocations[parameter.Index], value.x, value.y, value.z);
+	}
+
+	void OpenGLShader::Set(ShaderParameter<glm::vec4> parameter, const glm::vec4& value)
+	{
+		if (parameter.IsValid())
+			glUniform4f(m_ParameterLocations[parameter.Index], value.x, value.y, value.z, value.w);
+	}
+
+	void OpenGLShader::Set(ShaderParameter<glm::mat4> parameter, const glm::mat4& value)
+	{
+		if (parameter.IsValid())
+			glUniformMatrix4fv(m_ParameterLocations[parameter.Index], 1, GL_FALSE, glm::value_ptr(value));
+	}
+
 	void OpenGLShader::Reload()
 	{
+		SN_PROFILE_FUNCTION();
 		CreateCacheDirectoryIfNeeded();
 
 		std::string source = ReadFile(m_FilePath);
 		auto shaderSources = PreProcess(source);
 
-		
-		GLuint program = glCreateProgram();
-
 		shaderc::Compiler compiler;
 		shaderc::CompileOptions options;
 		options.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_2);
 		const bool optimize = false;
 		if (optimize)
 			options.SetOptimizationLevel(shaderc_optimization_level_size);
+		for (auto& define : m_Defines)
+			options.AddMacroDefinition(define);
 
 		std::filesystem::path cacheDirectory = GetCacheDirectory();
 
@@ -504,8 +633,7 @@ namespace Syndra {
 		shaderData.clear();
 		for (auto&& [stage, source] : shaderSources)
 		{
-			std::filesystem::path shaderFilePath = m_FilePath;
-			std::filesystem::path cachedPath = cacheDirectory / (shaderFilePath.filename().string() + GLShaderStageCachedVulkanFileExtension(stage));
+			std::filesystem::path cachedPath = cacheDirectory / (GetCacheFileName() + GLShaderStageCachedVulkanFileExtension(stage));
 
 			std::ifstream in(cachedPath, std::ios::in | std::ios::binary);
 
@@ -528,6 +656,8 @@ namespace Syndra {
 			}
 			
 		}
+		m_Samplers.clear();
+		m_PushConstants.clear();
 		SN_CORE_WARN("=================================={0} Shader=======================================", m_Name);
 		for (auto&& [stage, data] : shaderData)
 			Reflect(stage, data);
@@ -536,6 +666,20 @@ namespace Syndra {
 		CompileOrGetOpenGLBinaries();
 	}
 
+	void OpenGLShader::SetDefines(const std::vector<std::string>& defines)
+	{
+		SN_CORE_ASSERT(!m_FilePath.empty(), "Only shaders loaded from a file can be recompiled");
+		if (defines == m_Defines)
+			return;
+		m_Defines = defines;
+
+		auto shaderSources = PreProcess(ReadFile(m_FilePath));
+		m_Samplers.clear();
+		m_PushConstants.clear();
+		CompileOrGetVulkanBinaries(shaderSources);
+		CompileOrGetOpenGLBinaries();
+	}
+
 	const std::string& OpenGLShader::GetName() const
 	{
 		return m_Name;
@@ -22,7 +22,14 @@ namespace Syndra {
 		virtual void SetFloat4(const std::string& name, const glm::vec4& value) override;
 		virtual void SetMat4(const std::string& name, const glm::mat4& value) override;
 
+		virtual void Set(ShaderParameter<int> parameter, int value) override;
+		virtual void Set(ShaderParameter<float> parameter, float value) override;
+		virtual void Set(ShaderParameter<glm::vec3> parameter, const glm::vec3& value) override;
+		virtual void Set(ShaderParameter<glm::vec4> parameter, const glm::vec4& value) override;
+		virtual void Set(ShaderParameter<glm::mat4> parameter, const glm::mat4& value) override;
+
 		virtual const std::string& GetName() const override;
+		virtual uint32_t GetRendererID() const override { return m_RendererID; }
 
 		void UploadUniformInt(const std::string& name, int value);
 		void UploadUniformIntArray(const std::string& name, int* values, uint32_t count);
@@ -41,20 +48,28 @@ namespace Syndra {
 
 
 		virtual void Reload() override;
+		virtual void SetDefines(const std::vector<std::string>& defines) override;
+
+	protected:
+		virtual int32_t GetParameterIndex(const std::string& name) override;
 
 	private:
 		std::string ReadFile(const std::string& filepath);
 		std::unordered_map<GLenum, std::string> PreProcess(const std::string& source);
+		std::string GetCacheFileName() const;
 
 		void CompileOrGetVulkanBinaries(const std::unordered_map<GLenum, std::string>& shaderSources);
 		void CompileOrGetOpenGLBinaries();
 		void Reflect(GLenum stage, const std::vector<uint32_t>& shaderData);
 
 		void Compile(const std::unordered_map<GLenum, std::string>& shaderSources);
+		void ReflectUniformLocations();
+		int32_t GetUniformLocation(const std::string& name) const;
 	private:
-		uint32_t m_RendererID;
+		uint32_t m_RendererID = 0;
 		std::string m_FilePath;
 		std::string m_Name;
+		std::vector<std::string> m_Defines;
 
 		std::vector<PushConstant> m_PushConstants;
 		std::vector<Sampler> m_Samplers;
@@ -63,6 +78,13 @@ namespace Syndra {
 		std::unordered_map<GLenum, std::vector<uint32_t>> m_OpenGLSPIRV;
 
 		std::unordered_map<GLenum, std::string> m_OpenGLSourceCode;
+
+		//Locations of the active uniforms of the linked program
+		std::unordered_map<std::string, int32_t> m_UniformLocations;
+		//Parameter handles index these, locations are refreshed when the program is rebuilt
+		std::unordered_map<std::string, int32_t> m_ParameterIndices;
+		std::vector<std::string> m_ParameterNames;
+		std::vector<int32_t> m_ParameterLocations;
 	};
 
 }
\ No newline at end of file
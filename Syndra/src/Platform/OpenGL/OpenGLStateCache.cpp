@@ -0,0 +1,271 @@
+#include "lpch.h"
+#include "Platform/OpenGL/OpenGLStateCache.h"
+#include <glad/glad.h>
+
+namespace Syndra {
+
+	static constexpr uint32_t Unknown = UINT32_MAX;
+	//Units above this bypass the cache
+	static constexpr uint32_t MaxTextureUnits = 32;
+
+	struct StateCacheData
+	{
+		uint32_t program = Unknown;
+		uint32_t vertexArray = Unknown;
+		uint32_t textures[MaxTextureUnits];
+		uint32_t samplers[MaxTextureUnits];
+		uint32_t readFramebuffer = Unknown;
+		uint32_t drawFramebuffer = Unknown;
+		int32_t viewport[4] = { -1, -1, -1, -1 };
+		uint32_t depthFunc = Unknown;
+		uint32_t depthMask = Unknown;
+		uint32_t colorMask = Unknown;
+		uint32_t stencilFunc = Unknown;
+		uint32_t stencilReference = Unknown;
+		uint32_t stencilPassOp = Unknown;
+		std::unordered_map<uint32_t, bool> capabilities;
+
+		OpenGLStateCache::Stats stats;
+
+		StateCacheData()
+		{
+			std::fill(std::begin(textures), std::end(textures), Unknown);
+			std::fill(std::begin(samplers), std::end(samplers), Unknown);
+		}
+	};
+
+	static StateCacheData s_State;
+
+	static bool Filter(uint32_t& cached, uint32_t value)
+	{
+		if (cached == value) {
+			s_State.stats.Filtered++;
+			return true;
+		}
+		cached = value;
+		s_State.stats.Issued++;
+		return false;
+	}
+
+	void OpenGLStateCache::Invalidate()
+	{
+		s_State.program = Unknown;
+		s_State.vertexArray = Unknown;
+		std::fill(std::begin(s_State.textures), std::end(s_State.textures), Unknown);
+		std::fill(std::begin(s_State.samplers), std::end(s_State.samplers), Unknown);
+		s_State.readFramebuffer = Unknown;
+		s_State.drawFramebuffer = Unknown;
+		std::fill(std::begin(s_State.viewport), std::end(s_State.viewport), -1);
+		s_State.depthFunc = Unknown;
+		s_State.depthMask = Unknown;
+		s_State.colorMask = Unknown;
+		s_State.stencilFunc = Unknown;
+		s_State.stencilReference = Unknown;
+		s_State.stencilPassOp = Unknown;
+		s_State.capabilities.clear();
+	}
+
+	void OpenGLStateCache::UseProgram(uint32_t program)
+	{
+		if (!Filter(s_State.program, program))
+			glUseProgram(program);
+	}
+
+	void OpenGLStateCache::BindVertexArray(uint32_t vertexArray)
+	{
+		if (!Filter(s_State.vertexArray, vertexArray))
+			glBindVertexArray(vertexArray);
+	}
+
+	void OpenGLStateCache::BindTextureUnit(uint32_t unit, uint32_t texture)
+	{
+		if (unit >= MaxTextureUnits) {
+			s_State.stats.Issued++;
+			glBindTextureUnit(unit, texture);
+			return;
+		}
+		if (!Filter(s_State.textures[unit], texture))
+			glBindTextureUnit(unit, texture);
+	}
+
+	void OpenGLStateCache::BindTextures(uint32_t first, uint32_t count, const uint32_t* textures)
+	{
+		if (first + count > MaxTextureUnits) {
+			s_State.stats.Issued++;
+			glBindTextures(first, count, textures);
+			return;
+		}
+
+		//Only the span between the first and last unit that changes is rebound
+		int32_t begin = -1, end = -1;
+		for (uint32_t i = 0; i < count; i++)
+		{
+			if (s_State.textures[first + i] != textures[i]) {
+				if (begin < 0)
+					begin = i;
+				end = i;
+			}
+		}
+		if (begin < 0) {
+			s_State.stats.Filtered += count;
+			return;
+		}
+
+		for (int32_t i = begin; i <= end; i++)
+			s_State.textures[first + i] = textures[i];
+		s_State.stats.Filtered += count - (end - begin + 1);
+		s_State.stats.Issued++;
+		glBindTextures(first + begin, end - begin + 1, textures + begin);
+	}
+
+	void OpenGLStateCache::BindTexture(uint32_t target, uint32_t texture)
+	{
+		//Unit 0 may hold a texture of another target, it has to be rebound next time
+		s_State.textures[0] = Unknown;
+		s_State.stats.Issued++;
+		glBindTexture(target, texture);
+	}
+
+	void OpenGLStateCache::BindSampler(uint32_t unit, uint32_t sampler)
+	{
+		if (unit >= MaxTextureUnits) {
+			s_State.stats.Issued++;
+			glBindSampler(unit, sampler);
+			return;
+		}
+		if (!Filter(s_State.samplers[unit], sampler))
+			glBindSampler(unit, sampler);
+	}
+
+	void OpenGLStateCache::BindFramebuffer(uint32_t target, uint32_t framebuffer)
+	{
+		switch (target)
+		{
+		case GL_READ_FRAMEBUFFER:
+			if (!Filter(s_State.readFramebuffer, framebuffer))
+				glBindFramebuffer(target, framebuffer);
+			return;
+		case GL_DRAW_FRAMEBUFFER:
+			if (!Filter(s_State.drawFramebuffer, framebuffer))
+				glBindFramebuffer(target, framebuffer);
+			return;
+		}
+
+		if (s_State.readFramebuffer == framebuffer && s_State.drawFramebuffer == framebuffer) {
+			s_State.stats.Filtered++;
+			return;
+		}
+		s_State.readFramebuffer = s_State.drawFramebuffer = framebuffer;
+		s_State.stats.Issued++;
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	}
+
+	void OpenGLStateCache::Viewport(int32_t x, int32_t y, int32_t width, int32_t height)
+	{
+		auto& viewport = s_State.viewport;
+		if (viewport[0] == x && viewport[1] == y && viewport[2] == width && viewport[3] == height) {
+			s_State.stats.Filtered++;
+			return;
+		}
+		viewport[0] = x; viewport[1] = y; viewport[2] = width; viewport[3] = height;
+		s_State.stats.Issued++;
+		glViewport(x, y, width, height);
+	}
+
+	void OpenGLStateCache::SetEnabled(uint32_t capability, bool enabled)
+	{
+		auto it = s_State.capabilities.find(capability);
+		if (it != s_State.capabilities.end() && it->second == enabled) {
+			s_State.stats.Filtered++;
+			return;
+		}
+		s_State.capabilities[capability] = enabled;
+		s_State.stats.Issued++;
+		enabled ? glEnable(capability) : glDisable(capability);
+	}
+
+	void OpenGLStateCache::DepthFunc(uint32_t func)
+	{
+		if (!Filter(s_State.depthFunc, func))
+			glDepthFunc(func);
+	}
+
+	void OpenGLStateCache::DepthMask(bool write)
+	{
+		if (!Filter(s_State.depthMask, write))
+			glDepthMask(write ? GL_TRUE : GL_FALSE);
+	}
+
+	void OpenGLStateCache::ColorMask(bool write)
+	{
+		if (!Filter(s_State.colorMask, write)) {
+			GLboolean value = write ? GL_TRUE : GL_FALSE;
+			glColorMask(value, value, value, value);
+		}
+	}
+
+	void OpenGLStateCache::StencilFunc(uint32_t func, uint32_t reference)
+	{
+		if (s_State.stencilFunc == func && s_State.stencilReference == reference) {
+			s_State.stats.Filtered++;
+			return;
+		}
+		s_State.stencilFunc = func;
+		s_State.stencilReference = reference;
+		s_State.stats.Issued++;
+		glStencilFunc(func, reference, 0xFF);
+	}
+
+	void OpenGLStateCache::StencilPassOp(uint32_t op)
+	{
+		if (!Filter(s_State.stencilPassOp, op))
+			glStencilOp(GL_KEEP, GL_KEEP, op);
+	}
+
+	void OpenGLStateCache::DeleteProgram(uint32_t program)
+	{
+		if (s_State.program == program)
+			s_State.program = Unknown;
+		glDeleteProgram(program);
+	}
+
+	void OpenGLStateCache::DeleteVertexArray(uint32_t vertexArray)
+	{
+		if (s_State.vertexArray == vertexArray)
+			s_State.vertexArray = Unknown;
+		glDeleteVertexArrays(1, &vertexArray);
+	}
+
+	void OpenGLStateCache::DeleteTextures(uint32_t count, const uint32_t* textures)
+	{
+		for (uint32_t i = 0; i < count; i++)
+		{
+			for (auto& unit : s_State.textures)
+			{
+				if (unit == textures[i])
+					unit = Unknown;
+			}
+		}
+		glDeleteTextures(count, textures);
+	}
+
+	void OpenGLStateCache::DeleteFramebuffer(uint32_t framebuffer)
+	{
+		if (s_State.readFramebuffer == framebuffer)
+			s_State.readFramebuffer = Unknown;
+		if (s_State.drawFramebuffer == framebuffer)
+			s_State.drawFramebuffer = Unknown;
+		glDeleteFramebuffers(1, &framebuffer);
+	}
+
+	const OpenGLStateCache::Stats& OpenGLStateCache::GetStats()
+	{
+		return s_State.stats;
+	}
+
+	void OpenGLStateCache::ResetStats()
+	{
+		s_State.stats = {};
+	}
+
+}
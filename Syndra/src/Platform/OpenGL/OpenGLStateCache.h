@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Syndra {
+
+	//Shadow copy of the GL state the renderer touches, binds and toggles that would not change
+	//anything are dropped before they reach the driver. State changed behind its back (ImGui, raw GL calls)
+	//is unknown to it, Invalidate() has to be called before relying on the cache again.
+	class OpenGLStateCache
+	{
+	public:
+		struct Stats
+		{
+			//GL calls that reached the driver
+			uint32_t Issued = 0;
+			//Calls dropped because the state was already set
+			uint32_t Filtered = 0;
+		};
+
+		static void Invalidate();
+
+		static void UseProgram(uint32_t program);
+		static void BindVertexArray(uint32_t vertexArray);
+		static void BindTextureUnit(uint32_t unit, uint32_t texture);
+		//Multi-bind of a contiguous range of units, 0 unbinds a unit
+		static void BindTextures(uint32_t first, uint32_t count, const uint32_t* textures);
+		//Non DSA bind, it targets unit 0 since the renderer never changes the active texture unit
+		static void BindTexture(uint32_t target, uint32_t texture);
+		static void BindSampler(uint32_t unit, uint32_t sampler);
+		static void BindFramebuffer(uint32_t target, uint32_t framebuffer);
+		static void Viewport(int32_t x, int32_t y, int32_t width, int32_t height);
+		static void SetEnabled(uint32_t capability, bool enabled);
+		static void DepthFunc(uint32_t func);
+		static void DepthMask(bool write);
+		//Same mask for all four channels of every draw buffer
+		static void ColorMask(bool write);
+		//The stencil mask is left at all bits, only the function and reference change
+		static void StencilFunc(uint32_t func, uint32_t reference);
+		//Operation for fragments passing the stencil and depth test, failing ones keep their value
+		static void StencilPassOp(uint32_t op);
+
+		//Deleted names can be handed out again, so they are forgotten by the cache
+		static void DeleteProgram(uint32_t program);
+		static void DeleteVertexArray(uint32_t vertexArray);
+		static void DeleteTextures(uint32_t count, const uint32_t* textures);
+		static void DeleteFramebuffer(uint32_t framebuffer);
+
+		static const Stats& GetStats();
+		static void ResetStats();
+	};
+
+}
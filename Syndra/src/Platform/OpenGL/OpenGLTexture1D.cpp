@@ -1,5 +1,6 @@
 #include "lpch.h"
 #include "Platform/OpenGL/OpenGLTexture1D.h"
+#include "Platform/OpenGL/OpenGLStateCache.h"
 
 namespace Syndra {
 
@@ -7,7 +8,7 @@ namespace Syndra {
 		:m_Size(size)
 	{
 		glCreateTextures(GL_TEXTURE_1D, 1, &m_RendererID);
-		glBindTexture(GL_TEXTURE_1D, m_RendererID);
+		OpenGLStateCache::BindTexture(GL_TEXTURE_1D, m_RendererID);
 		glTextureStorage1D(m_RendererID, 1, GL_RG32F, size);
 
 		glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -21,7 +22,7 @@ namespace Syndra {
 		:m_Size(size)
 	{
 		glCreateTextures(GL_TEXTURE_1D, 1, &m_RendererID);
-		glBindTexture(GL_TEXTURE_1D, m_RendererID);
+		OpenGLStateCache::BindTexture(GL_TEXTURE_1D, m_RendererID);
 		glTextureStorage1D(m_RendererID, 1, GL_RG32F, size);
 
 		glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -34,7 +35,7 @@ namespace Syndra {
 
 	OpenGLTexture1D::~OpenGLTexture1D()
 	{
-		glDeleteTextures(1, &m_RendererID);
+		OpenGLStateCache::DeleteTextures(1, &m_RendererID);
 	}
 
 	void OpenGLTexture1D::SetData(void* data, uint32_t size)
@@ -44,7 +45,7 @@ namespace Syndra {
 
 	void OpenGLTexture1D::Bind(uint32_t slot /*= 0*/) const
 	{
-		glBindTextureUnit(slot, m_RendererID);
+		OpenGLStateCache::BindTextureUnit(slot, m_RendererID);
 	}
 
 	std::string OpenGLTexture1D::GetPath() const
@@ -1,5 +1,6 @@
 #include "lpch.h"
 #include "Platform/OpenGL/OpenGLTexture2D.h"
+#include "Platform/OpenGL/OpenGLStateCache.h"
 #include "stb_image.h"
 
 namespace Syndra {
@@ -24,6 +25,7 @@ namespace Syndra {
 	OpenGLTexture2D::OpenGLTexture2D(const std::string& path, bool sRGB, bool HDR)
 		: m_Path(path)
 	{
+		SN_PROFILE_FUNCTION();
 		int width, height, channels;
 		
 		stbi_uc* data = nullptr;
@@ -60,7 +62,7 @@ namespace Syndra {
 			//SN_CORE_ASSERT(internalFormat & dataFormat, "Format not supported!");
 
 			glCreateTextures(GL_TEXTURE_2D, 1, &m_RendererID);
-			glBindTexture(GL_TEXTURE_2D, m_RendererID);
+			OpenGLStateCache::BindTexture(GL_TEXTURE_2D, m_RendererID);
 			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 			glTextureStorage2D(m_RendererID, mipmapLevels, internalFormat, m_Width, m_Height);
 
@@ -114,7 +116,7 @@ namespace Syndra {
 		//SN_CORE_ASSERT(internalFormat & dataFormat, "Format not supported!");
 
 		glCreateTextures(GL_TEXTURE_2D, 1, &m_RendererID);
-		glBindTexture(GL_TEXTURE_2D, m_RendererID);
+		OpenGLStateCache::BindTexture(GL_TEXTURE_2D, m_RendererID);
 		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 		glTextureStorage2D(m_RendererID, mipmapLevels, internalFormat, m_Width, m_Height);
 
@@ -132,7 +134,7 @@ namespace Syndra {
 
 	OpenGLTexture2D::~OpenGLTexture2D()
 	{
-		glDeleteTextures(1, &m_RendererID);
+		OpenGLStateCache::DeleteTextures(1, &m_RendererID);
 	}
 
 	void OpenGLTexture2D::SetData(void* data, uint32_t size)
@@ -144,21 +146,27 @@ namespace Syndra {
 
 	void OpenGLTexture2D::Bind(uint32_t slot /*= 0*/) const
 	{
-		glBindTextureUnit(slot, m_RendererID);
+		OpenGLStateCache::BindTextureUnit(slot, m_RendererID);
 	}
 
 	void OpenGLTexture2D::BindTexture(uint32_t rendererID, uint32_t slot)
 	{
 		//glActiveTexture(GL_TEXTURE0 + slot);
-		glBindTextureUnit(slot, rendererID);
+		OpenGLStateCache::BindTextureUnit(slot, rendererID);
+	}
+
+	void OpenGLTexture2D::BindTextures(uint32_t first, uint32_t count, const uint32_t* rendererIDs)
+	{
+		OpenGLStateCache::BindTextures(first, count, rendererIDs);
 	}
 
 	void OpenGLTexture2D::LoadHDR()
 	{
+		SN_PROFILE_FUNCTION();
 		int width, height, channels;
 		float* data = stbi_loadf(m_Path.c_str(), &width, &height, &channels, 0);
 		glCreateTextures(GL_TEXTURE_2D, 1, &m_RendererID);
-		glBindTexture(GL_TEXTURE_2D, m_RendererID);
+		OpenGLStateCache::BindTexture(GL_TEXTURE_2D, m_RendererID);
 
 		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, width, height, 0, GL_RGB, GL_FLOAT, data);
 
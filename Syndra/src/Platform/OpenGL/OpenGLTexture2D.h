@@ -24,6 +24,7 @@ namespace Syndra {
 		virtual void Bind(uint32_t slot = 0) const override;
 
 		static void BindTexture(uint32_t rendererID, uint32_t slot);
+		static void BindTextures(uint32_t first, uint32_t count, const uint32_t* rendererIDs);
 
 	private:
 		void LoadHDR();
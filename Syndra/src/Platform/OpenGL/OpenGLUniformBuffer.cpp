@@ -21,4 +21,9 @@ namespace Syndra {
 		glNamedBufferSubData(m_RendererID, offset, size, data);
 	}
 
+	void OpenGLUniformBuffer::Bind(uint32_t binding) const
+	{
+		glBindBufferBase(GL_UNIFORM_BUFFER, binding, m_RendererID);
+	}
+
 }
\ No newline at end of file
@@ -11,6 +11,7 @@ namespace Syndra {
 		virtual ~OpenGLUniformBuffer();
 
 		virtual void SetData(const void* data, uint32_t size, uint32_t offset = 0) override;
+		virtual void Bind(uint32_t binding) const override;
 	private:
 		uint32_t m_RendererID = 0;
 	};
@@ -1,5 +1,6 @@
 #include "lpch.h"
 #include "OpenGLVertexArray.h"
+#include "Platform/OpenGL/OpenGLStateCache.h"
 #include "glad/glad.h"
 
 namespace Syndra {
@@ -27,27 +28,27 @@ namespace Syndra {
 	OpenGLVertexArray::OpenGLVertexArray()
 	{
 		glCreateVertexArrays(1, &m_RendererID);
-		glBindVertexArray(m_RendererID);
+		OpenGLStateCache::BindVertexArray(m_RendererID);
 	}
 
 	OpenGLVertexArray::~OpenGLVertexArray()
 	{
-		glDeleteVertexArrays(1, &m_RendererID);
+		OpenGLStateCache::DeleteVertexArray(m_RendererID);
 	}
 
 	void OpenGLVertexArray::Bind() const
 	{
-		glBindVertexArray(m_RendererID);
+		OpenGLStateCache::BindVertexArray(m_RendererID);
 	}
 
 	void OpenGLVertexArray::Unbind() const
 	{
-		glBindVertexArray(0);
+		OpenGLStateCache::BindVertexArray(0);
 	}
 
 	void OpenGLVertexArray::AddVertexBuffer(const Ref<VertexBuffer>& vertexBuffer)
 	{
-		glBindVertexArray(m_RendererID);
+		OpenGLStateCache::BindVertexArray(m_RendererID);
 		vertexBuffer->Bind();
 
 		uint32_t index = 0;
@@ -103,7 +104,7 @@ namespace Syndra {
 
 	void OpenGLVertexArray::SetIndexBuffer(const Ref<IndexBuffer>& indexBuffer)
 	{
-		glBindVertexArray(m_RendererID);
+		OpenGLStateCache::BindVertexArray(m_RendererID);
 		indexBuffer->Bind();
 
 		m_IndexBuffer = indexBuffer;
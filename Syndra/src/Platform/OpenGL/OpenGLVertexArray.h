@@ -18,6 +18,8 @@ namespace Syndra {
 		virtual const std::vector<Ref<VertexBuffer>>& GetVertexBuffers() const override { return m_VertexBuffers; };
 		virtual const Ref<IndexBuffer>& GetIndexBuffer() const override { return m_IndexBuffer; };
 
+		virtual uint32_t GetRendererID() const override { return m_RendererID; }
+
 	private:
 		uint32_t m_RendererID;
 		uint32_t m_VertexBufferIndex = 0;
@@ -9,6 +9,9 @@ namespace Syndra {
 	bool Input::IsKeyPressed(const KeyCode key)
 	{
 		auto* window = static_cast<GLFWwindow*>(Application::Get().GetWindow().GetNativeWindow());
+		//Headless windows have no input
+		if (!window)
+			return false;
 		auto state = glfwGetKey(window, static_cast<int32_t>(key));
 		return state == GLFW_PRESS || state == GLFW_REPEAT;
 	}
@@ -16,6 +19,8 @@ namespace Syndra {
 	bool Input::IsMouseButtonPressed(const MouseCode button)
 	{
 		auto* window = static_cast<GLFWwindow*>(Application::Get().GetWindow().GetNativeWindow());
+		if (!window)
+			return false;
 		auto state = glfwGetMouseButton(window, static_cast<int32_t>(button));
 		return state == GLFW_PRESS;
 	}
@@ -23,6 +28,8 @@ namespace Syndra {
 	glm::vec2 Input::GetMousePosition()
 	{
 		auto* window = static_cast<GLFWwindow*>(Application::Get().GetWindow().GetNativeWindow());
+		if (!window)
+			return { 0.0f, 0.0f };
 		double xpos, ypos;
 		glfwGetCursorPos(window, &xpos, &ypos);
 
@@ -22,20 +22,20 @@ namespace Syndra {
 	WindowsWindow::WindowsWindow(const WindowProps& props)
 	{
 
-		//SN_PROFILE_FUNCTION();
+		SN_PROFILE_FUNCTION();
 		Init(props);
 	}
 
 	WindowsWindow::~WindowsWindow()
 	{
-		//SN_PROFILE_FUNCTION();
+		SN_PROFILE_FUNCTION();
 
 		Shutdown();
 	}
 
 	void WindowsWindow::Init(const WindowProps& props)
 	{
-		//SN_PROFILE_FUNCTION();
+		SN_PROFILE_FUNCTION();
 
 		m_Data.Title = props.Title;
 		m_Data.Width = props.Width;
@@ -50,14 +50,14 @@ namespace Syndra {
 
 		if (s_GLFWWindowCount == 0)
 		{
-			//SN_PROFILE_SCOPE("glfwInit");
+			SN_PROFILE_SCOPE("glfwInit");
 			int success = glfwInit();
 			//SN_CORE_ASSERT(success, "Could not initialize GLFW!");
 			glfwSetErrorCallback(GLFWErrorCallback);
 		}
 
 		{
-			//SN_PROFILE_SCOPE("glfwCreateWindow");
+			SN_PROFILE_SCOPE("glfwCreateWindow");
 //#if defined(SN_DEBUG)
 //			if (Renderer::GetAPI() == RendererAPI::API::OpenGL)
 //				glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE);
@@ -172,7 +172,7 @@ namespace Syndra {
 
 	void WindowsWindow::Shutdown()
 	{
-		//SN_PROFILE_FUNCTION();
+		SN_PROFILE_FUNCTION();
 
 		glfwDestroyWindow(m_Window);
 		--s_GLFWWindowCount;
@@ -185,7 +185,7 @@ namespace Syndra {
 
 	void WindowsWindow::OnUpdate()
 	{
-		//SN_PROFILE_FUNCTION();
+		SN_PROFILE_FUNCTION();
 
 		glfwPollEvents();
 		m_Context->SwapBuffers();
@@ -193,7 +193,7 @@ namespace Syndra {
 
 	void WindowsWindow::SetVSync(bool enabled)
 	{
-		//SN_PROFILE_FUNCTION();
+		SN_PROFILE_FUNCTION();
 
 		if (enabled)
 			glfwSwapInterval(1);
@@ -22,9 +22,10 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <stdint.h>
-#include "Engine/Core/core.h"
+#include "Engine/Core/Core.h"
 
 #include "Engine/Core/Log.h"
+#include "Engine/Debug/Instrumentor.h"
 
 #ifdef SN_PLATFORM_WINDOWS
 #include "windows.h"
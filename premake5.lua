@@ -54,6 +54,7 @@ group "Dependencies"
 group ""
 
 include "Syndra-Editor"
+include "Syndra-Bench"
 
 project "Syndra"
 	location "Syndra"
@@ -106,8 +107,7 @@ project "Syndra"
 		"GLFW",
 		"Glad",
 		"imgui",
-		"yaml-cpp",
-		"opengl32.lib"
+		"yaml-cpp"
 	}
 	
 	filter "files:Syndra/vendor/ImGuizmo/**.cpp"
@@ -116,12 +116,18 @@ project "Syndra"
 	filter "system:windows"
 		cppdialect "C++latest"
 		systemversion "latest"
+		links { "opengl32.lib" }
 
 	defines
 	{
 		"GLFW_INCLUDE_NONE"
 	}
 
+	-- Headless runs create their context through EGL
+	filter "system:linux"
+		pic "on"
+		links { "EGL", "dl", "pthread" }
+
 	filter "configurations:Debug"
 		defines "SN_DEBUG"
 		symbols "on"